@@ -172,7 +172,7 @@ ActionStatus BuildAction::perform()
         }
         else
         {
-            ingredient->quantity -= it.second;
+            ingredient->setQuantity(ingredient->quantity - it.second);
         }
     }
     for (auto iterator : tools)
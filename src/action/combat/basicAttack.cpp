@@ -656,7 +656,7 @@ bool BasicAttack::performRangedAttack(Character * target,
     }
     else
     {
-        projectile->quantity -= 1;
+        projectile->setQuantity(projectile->quantity - 1);
     }
     // -------------------------------------------------------------------------
     // Phase 4: Check if the target is hit.
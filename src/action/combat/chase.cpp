@@ -23,21 +23,34 @@
 #include "chase.hpp"
 
 #include "structureUtils.hpp"
+#include "flowField.hpp"
 #include "characterUtilities.hpp"
 #include "effectFactory.hpp"
 #include "moveAction.hpp"
 #include "logger.hpp"
-#include "aStar.hpp"
 #include "area.hpp"
 #include "room.hpp"
+#include "mud.hpp"
 #include <queue>
 #include <cassert>
 
 Chase::Chase(Character * _actor, Character * _target) :
     CombatAction(_actor),
     target(_target),
-    lastRoom(_target->room),
-    RoomCheckFunction()
+    lastRoom(_target->room->vnum),
+    path(),
+    aStar([this](Room * from, Room * to)
+          {
+              // Prepare the movement options.
+              MovementOptions options;
+              options.character = actor;
+              // Prepare the error string.
+              std::string error;
+              return StructUtils::checkConnection(options, from, to, error);
+          },
+          StructUtils::getRoomDistance,
+          StructUtils::roomsAreEqual,
+          StructUtils::getNeighbours)
 {
     // Debugging message.
     Logger::log(LogLevel::Debug, "Created Chase.");
@@ -106,7 +119,7 @@ ActionStatus Chase::perform()
     else
     {
         // If the path to the target is empty or the target has changed room.
-        if (path.empty() || (target->room->vnum != lastRoom->vnum))
+        if (path.empty() || (target->room->vnum != lastRoom))
         {
             Logger::log(LogLevel::Debug, "Evaluating the path...");
             // Find the path from the actor to the target.
@@ -181,25 +194,28 @@ unsigned int Chase::getConsumedStamina(Character * character)
 
 bool Chase::updatePath()
 {
-    // Set the check function.
-    if (RoomCheckFunction == nullptr)
+    // Follow the flow field shared by all the characters chasing the target.
+    std::vector<Room *> rooms;
+    auto const & field = FlowFieldService::instance().getField(
+        target->room, actor->isMobile());
+    if (!field.getPath(actor->room, rooms))
     {
-        RoomCheckFunction = [&](Room * from, Room * to)
+        // Do not look for paths which wander too far from the actor.
+        aStar.setCostLimit(actor->getViewDistance() * 3);
+        // Find the path from the actor to the target.
+        if (!aStar.findPath(actor->room, target->room, rooms))
         {
-            // Prepare the movement options.
-            MovementOptions options;
-            options.character = actor;
-            // Prepare the error string.
-            std::string error;
-            return StructUtils::checkConnection(options, from, to, error);
-        };
+            return false;
+        }
+    }
+    path.clear();
+    for (auto room : rooms)
+    {
+        path.emplace_back(room->vnum);
     }
-    // Find the path from the actor to the target.
-    AStar<Room *> aStar(RoomCheckFunction,
-                        StructUtils::getRoomDistance,
-                        StructUtils::roomsAreEqual,
-                        StructUtils::getNeighbours);
-    return aStar.findPath(actor->room, target->room, path);
+    // Remember where the target was when the path has been evaluated.
+    lastRoom = target->room->vnum;
+    return true;
 }
 
 bool Chase::moveTowardsTarget()
@@ -209,10 +225,11 @@ bool Chase::moveTowardsTarget()
         Logger::log(LogLevel::Debug, "Path is empty.");
         return false;
     }
-    Room * nextRoom = path.front();
+    // Find the room again, it is materialized if it has been evicted.
+    auto nextRoom = Mud::instance().findRoom(path.front());
     if (nextRoom == nullptr)
     {
-        Logger::log(LogLevel::Debug, "Next room is a nullptr.");
+        Logger::log(LogLevel::Debug, "Next room does not exist.");
         return false;
     }
     // Get the direction of the next room.
@@ -24,7 +24,7 @@
 
 #include "characterPosture.hpp"
 #include "combatAction.hpp"
-#include <functional>
+#include "aStar.hpp"
 
 /// @brief An action executed by characters when fighting at close range.
 class Chase :
@@ -33,12 +33,13 @@ class Chase :
 private:
     /// The chased target.
     Character * target;
-    /// The room to which the path leads.
-    Room * lastRoom;
-    /// The path which leads to the target.
-    std::vector<Room *> path;
-    /// Checking function.
-    std::function<bool(Room *, Room *)> RoomCheckFunction;
+    /// The vnum of the room to which the path leads.
+    int lastRoom;
+    /// The vnums of the rooms of the path which leads to the target, since
+    /// the rooms of a streamed area can be evicted while chasing.
+    std::vector<int> path;
+    /// The pathfinder, kept between the updates of the path.
+    AStar<Room *> aStar;
 
 public:
     /// @brief Constructor.
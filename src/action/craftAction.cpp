@@ -186,7 +186,7 @@ ActionStatus CraftAction::perform()
         }
         else
         {
-            ingredient->quantity -= it.second;
+            ingredient->setQuantity(ingredient->quantity - it.second);
         }
     }
     // Get the outcome model.
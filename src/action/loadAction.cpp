@@ -121,8 +121,8 @@ ActionStatus LoadAction::perform()
         }
         else
         {
-            loadedProjectile->quantity += amount;
-            projectile->quantity -= amount;
+            loadedProjectile->setQuantity(loadedProjectile->quantity + amount);
+            projectile->setQuantity(projectile->quantity - amount);
             loadedProjectile->updateOnDB();
             projectile->updateOnDB();
         }
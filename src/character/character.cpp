@@ -27,7 +27,10 @@
 
 #include "lightItem.hpp"
 #include "armorItem.hpp"
+#include "lua_script.hpp"
+#include "pathRequestService.hpp"
 #include "logger.hpp"
+#include "memoryTracker.hpp"
 #include "mud.hpp"
 
 Character::Character() :
@@ -47,7 +50,7 @@ Character::Character() :
     inventory(),
     equipment(),
     posture(CharacterPosture::Stand),
-    L(luaL_newstate()),
+    L(LuaNewState()),
     actionQueue(),
     actionQueueMutex(),
     inputProcessor(std::make_shared<ProcessInput>()),
@@ -61,7 +64,22 @@ Character::Character() :
 
 Character::~Character()
 {
-    lua_close(L);
+    // Forget the paths which are still being searched for the character.
+    PathRequestService::instance().cancel(this);
+    LuaCloseState(L);
+}
+
+void * Character::operator new(size_t size)
+{
+    auto ptr = ::operator new(size);
+    MemoryTracker::instance().allocate(MemoryCategory::Character, size);
+    return ptr;
+}
+
+void Character::operator delete(void * ptr, size_t size)
+{
+    MemoryTracker::instance().deallocate(MemoryCategory::Character, size);
+    ::operator delete(ptr);
 }
 
 bool Character::check() const
@@ -620,6 +638,11 @@ void Character::addEquipmentItem(Item *& item)
     equipment.push_back_item(item);
     // Set the owner of the item.
     item->owner = this;
+    // Update the light map.
+    if (item->getType() == ModelType::Light)
+    {
+        static_cast<LightItem *>(item)->updateLightMap();
+    }
     // Log it.
     Logger::log(LogLevel::Debug,
                 "Item '%s' added to '%s' equipment;",
@@ -653,6 +676,11 @@ bool Character::remEquipmentItem(Item * item)
     item->owner = nullptr;
     // Empty the occupied body parts.
     item->occupiedBodyParts.clear();
+    // Update the light map.
+    if (item->getType() == ModelType::Light)
+    {
+        static_cast<LightItem *>(item)->updateLightMap();
+    }
     // Log it.
     Logger::log(LogLevel::Debug,
                 "Item '%s' removed from '%s';",
@@ -660,6 +688,17 @@ bool Character::remEquipmentItem(Item * item)
     return true;
 }
 
+void Character::updateEquippedLights()
+{
+    for (auto item : equipment)
+    {
+        if (item->getType() == ModelType::Light)
+        {
+            static_cast<LightItem *>(item)->updateLightMap();
+        }
+    }
+}
+
 bool Character::canCarry(Item * item, unsigned int quantity) const
 {
     return ((this->getCarryingWeight() + (item->getWeight(false) * quantity)) <
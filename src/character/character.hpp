@@ -136,6 +136,13 @@ public:
     /// @brief Destructor.
     virtual ~Character();
 
+
+    /// @brief Allocates the memory for a character, keeping track of its usage.
+    static void * operator new(size_t size);
+
+    /// @brief Releases the memory of a character, keeping track of its usage.
+    static void operator delete(void * ptr, size_t size);
+
     /// @brief Disable copy constructor.
     Character(const Character & source) = delete;
 
@@ -384,6 +391,10 @@ public:
     ///         <b>False</b> otherwise.
     virtual bool remEquipmentItem(Item * item);
 
+    /// @brief Updates the light map with the equipped light sources, it must
+    ///         be called every time the character changes room.
+    void updateEquippedLights();
+
     /// @brief Check if the player can carry the item.
     /// @param item     The item we want to check.
     /// @param quantity The amount of item to check (by default it is 1).
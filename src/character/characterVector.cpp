@@ -24,6 +24,8 @@
 #include "player.hpp"
 #include "mobile.hpp"
 
+#include <algorithm>
+
 static inline bool IsAnException(
     Character * character,
     std::vector<Character *> const & ex)
@@ -80,11 +82,7 @@ Character * CharacterVector::findCharacter(const std::string & target,
 
 bool CharacterVector::containsCharacter(Character * character) const
 {
-    for (auto it : (*this))
-    {
-        if (it->getName() == character->getName()) return true;
-    }
-    return false;
+    return std::find(this->begin(), this->end(), character) != this->end();
 }
 
 void CharacterVector::emplace_back_character(Character * character)
@@ -25,6 +25,7 @@
 #include "generalBehaviour.hpp"
 #include "lua_script.hpp"
 #include "logger.hpp"
+#include "memoryTracker.hpp"
 #include "mud.hpp"
 
 Mobile::Mobile() :
@@ -125,8 +126,11 @@ void Mobile::respawn()
         }
     }
     inventory.clear();
-    // Intialize the lua state.
-    L = luaL_newstate();
+    // Empty the behaviours queue, since it references the old lua state.
+    behaviourQueue.clear();
+    // Close the previous lua state and intialize a new one.
+    LuaCloseState(L);
+    L = LuaNewState();
     // Load the lua environment.
     LoadLuaEnvironmet(L, lua_script);
     // Set the mobile to Alive.
@@ -183,7 +187,7 @@ void Mobile::getSheet(Table & sheet) const
     sheet.addRow({"Id", this->id});
     sheet.addRow({"Respawn Room", ToString(this->respawnRoom->vnum)});
     std::string keyGroup;
-    for (auto it : this->keys)
+    for (auto const & it : this->keys)
     {
         keyGroup += " " + it;
     }
@@ -207,6 +211,7 @@ void Mobile::getSheet(Table & sheet) const
         sheet.addRow({"Controller", this->controller->getName()});
     }
     sheet.addRow({"Lua Script", this->lua_script});
+    sheet.addRow({"Lua Memory", MemorySizeToString(LuaGetMemoryUsage(L))});
 }
 
 std::string Mobile::getName() const
@@ -217,7 +222,7 @@ std::string Mobile::getName() const
 bool Mobile::hasKey(const std::string & key) const
 {
     bool found = false;
-    for (auto iterator : keys)
+    for (auto const & iterator : keys)
     {
         if (BeginWith(iterator, key))
         {
@@ -252,7 +257,7 @@ void Mobile::kill()
         auto min = (item->maxCondition / 100) * 10;
         auto max = (item->maxCondition / 100) * 50;
         // Set a random condition for the new item.
-        item->condition = TRandReal<double>(min, max);
+        item->setCondition(TRandReal<double>(min, max));
     };
     // Before calling the character kill function, set the vnum for the new
     //  items, and set the item condition to a random value from 10% to 50%.
@@ -304,8 +309,9 @@ void Mobile::reloadLua()
     lua_settop(L, 0);
     // Empty the behaviours queue.
     behaviourQueue.clear();
-    // Reset the lua state.
-    L = luaL_newstate();
+    // Close the previous lua state and create a new one.
+    LuaCloseState(L);
+    L = LuaNewState();
     // Load the lua environment.
     LoadLuaEnvironmet(L, lua_script);
     // Call the LUA function: Event_Init in order to prepare the mobile.
@@ -416,6 +422,29 @@ void Mobile::triggerEventMain()
     this->mobileThread("EventMain", nullptr, "");
 }
 
+void Mobile::triggerEventPathReady(unsigned int handle)
+{
+    try
+    {
+        luabridge::LuaRef func = luabridge::getGlobal(L, "EventPathReady");
+        if (func.isFunction())
+        {
+            behaviourQueue.emplace_back(
+                std::make_shared<
+                    BehaviourP2<
+                        Character *,
+                        unsigned int>>("EventPathReady",
+                                       func,
+                                       this,
+                                       handle));
+        }
+    }
+    catch (luabridge::LuaException const & e)
+    {
+        Logger::log(LogLevel::Error, e.what());
+    }
+}
+
 bool Mobile::mobileThread(std::string event,
                           Character * character,
                           std::string message)
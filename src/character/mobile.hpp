@@ -30,6 +30,7 @@
 #include <future>
 
 #include "character.hpp"
+#include "stringPool.hpp"
 
 class GeneralBehaviour;
 
@@ -43,7 +44,7 @@ public:
     /// The room where the mobile must respawn.
     Room * respawnRoom;
     /// List of keys used to target this mobile.
-    std::vector<std::string> keys;
+    std::vector<InternedString> keys;
     /// Short description.
     std::string shortdesc;
     /// Static description.
@@ -172,6 +173,11 @@ public:
 
     /// @brief This event is triggered at every time tick.
     void triggerEventMain();
+
+    /// @brief This event is triggered when a path requested by the mobile
+    ///         has been resolved.
+    /// @param handle The handle of the request.
+    void triggerEventPathReady(unsigned int handle);
     ///@}
 
 protected:
@@ -24,6 +24,7 @@
 
 #include "sqliteWriteFunctions.hpp"
 #include "logger.hpp"
+#include "memoryTracker.hpp"
 #include "mud.hpp"
 
 Player::Player(const int & _socket,
@@ -34,6 +35,7 @@ Player::Player(const int & _socket,
     address(_address),
     outbuf(),
     inbuf(),
+    bufferUsage(),
     password(),
     age(),
     experience(),
@@ -46,7 +48,8 @@ Player::Player(const int & _socket,
     logged_in(),
     connectionFlags(),
     msdpVariables(),
-    luaVariables()
+    luaVariables(),
+    clientMap()
 {
     // Nothing to do.
 }
@@ -79,6 +82,8 @@ Player::~Player()
     {
         room->removeCharacter(this);
     }
+    // Release the memory accounted to the buffers.
+    MemoryTracker::instance().resize(MemoryCategory::Network, bufferUsage, 0);
     //Logger::log(LogLevel::Debug, "Deleted player\t\t\t\t(%s)", this->getNameCapital());
 }
 
@@ -376,6 +381,8 @@ void Player::processRead()
     this->doCommand(Trim(inbuf));
     // Null-terminate the buffer.
     inbuf[uRead] = 0;
+    // Update the memory used by the buffers.
+    this->updateBufferUsage();
 }
 
 void Player::processWrite()
@@ -438,7 +445,7 @@ void Player::processWrite()
             {
                 Logger::log(LogLevel::Error, "Unknown error during Send...");
             }
-            return;
+            break;
         }
         std::size_t uWritten = static_cast<std::size_t>(nWrite);
         MudUpdater::instance().updateBandOut(uWritten);
@@ -452,6 +459,8 @@ void Player::processWrite()
             break;
         }
     }
+    // Update the memory used by the buffers.
+    this->updateBufferUsage();
 }
 
 void Player::processException()
@@ -463,6 +472,8 @@ void Player::processException()
 void Player::sendMsg(const std::string & msg)
 {
     outbuf += msg;
+    // Update the memory used by the buffers.
+    this->updateBufferUsage();
 }
 
 void Player::updateTicImpl()
@@ -478,3 +489,15 @@ void Player::updateHourImpl()
 {
     // Nothing to do.
 }
+
+void Player::updateBufferUsage()
+{
+    auto usage = outbuf.capacity() + inbuf.capacity();
+    if (usage != bufferUsage)
+    {
+        MemoryTracker::instance().resize(MemoryCategory::Network,
+                                         bufferUsage,
+                                         usage);
+        bufferUsage = usage;
+    }
+}
@@ -29,6 +29,7 @@
 #include <string>
 
 #include "character.hpp"
+#include "renderCache.hpp"
 #include "skill.hpp"
 
 /// Handle all the player's phases during login.
@@ -53,6 +54,8 @@ private:
     std::string outbuf;
     /// Pending input.
     std::string inbuf;
+    /// The memory currently reserved by the input and output buffers.
+    size_t bufferUsage;
 
 public:
     /// Player password.
@@ -81,6 +84,8 @@ public:
     std::map<std::string, std::string> msdpVariables;
     /// Lua variables.
     std::map<std::string, std::string> luaVariables;
+    /// The last map sent to the client.
+    ClientMap clientMap;
 
     /// @brief Constructor.
     /// @param socket    Player socket.
@@ -173,4 +178,7 @@ protected:
 
     void updateHourImpl() override;
 
+private:
+    /// @brief Updates the memory accounted to the network buffers.
+    void updateBufferUsage();
 };
@@ -298,7 +298,7 @@ bool DoDeconstruct(Character * character, ArgumentHandler & args)
     {
         character->sendMsg("You deconstruct %s.\n", item->getName(true));
         // Reset item flags.
-        ClearFlag(item->flags, ItemFlag::Built);
+        item->clearFlag(ItemFlag::Built);
         return true;
     }
     character->sendMsg(error + "\n");
@@ -48,8 +48,10 @@ void LoadGodCommands()
         "Go to another room.",
         true, true, false));
     Mud::instance().addCommand(std::make_shared<Command>(
-        DoGenerateMap, "mud_generate_map", "",
-        "Generate a map.",
+        DoGenerateMap, "mud_generate_map",
+        "(height map) [seed] [mountains|noise]",
+        "Generate a map in background, the same seed always generates the "
+            "same map, the relief is raised by mountains or by noise.",
         true, true, false));
     Mud::instance().addCommand(std::make_shared<Command>(
         DoShowGenerateMap, "mud_show_generated_map", "",
@@ -60,8 +62,26 @@ void LoadGodCommands()
         "Deletes a generated map.",
         true, true, false));
     Mud::instance().addCommand(std::make_shared<Command>(
-        DoBuildGenerateMap, "mud_build_generated_map", "",
-        "Builds a generated map.",
+        DoBuildGenerateMap, "mud_build_generated_map", "(map) (name) [radius]",
+        "Builds a generated map in background, with a radius only the rooms "
+            "near the characters are kept.",
+        true, true, false));
+    Mud::instance().addCommand(std::make_shared<Command>(
+        DoMapJobs, "mud_map_jobs", "[cancel (job)]",
+        "Shows (or cancels) the maps generated and built in background.",
+        true, true, false));
+    Mud::instance().addCommand(std::make_shared<Command>(
+        DoMemoryInfo, "mud_memory", "[export]",
+        "Shows (or exports) the memory used by each subsystem.",
+        true, true, false));
+    Mud::instance().addCommand(std::make_shared<Command>(
+        DoBenchmark, "mud_benchmark", "[queries]",
+        "Times the pathfinding and field of view on synthetic areas.",
+        true, true, false));
+    Mud::instance().addCommand(std::make_shared<Command>(
+        DoSnapshot, "mud_snapshot", "[now|interval (seconds)]",
+        "Shows the snapshots of the database, takes one or sets their "
+            "interval.",
         true, true, false));
     Mud::instance().addCommand(std::make_shared<Command>(
         DoFactionInfo, "faction_information", "(faction vnum)",
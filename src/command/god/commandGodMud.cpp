@@ -21,7 +21,10 @@
 
 #include "commandGodMud.hpp"
 #include "characterUtilities.hpp"
-#include "mapGenerator.hpp"
+#include "mapGenerationService.hpp"
+#include "memoryTracker.hpp"
+#include "structureBenchmark.hpp"
+#include "stopwatch.hpp"
 #include "mud.hpp"
 
 bool DoShutdown(Character * character, ArgumentHandler &)
@@ -35,6 +38,8 @@ bool DoShutdown(Character * character, ArgumentHandler &)
 
 bool DoMudSave(Character * character, ArgumentHandler &)
 {
+    Stopwatch<std::chrono::microseconds> stopwatch("Save");
+    stopwatch.start();
     if (!Mud::instance().saveMud())
     {
         character->sendMsg("Something gone wrong during the saving process.\n");
@@ -43,7 +48,7 @@ bool DoMudSave(Character * character, ArgumentHandler &)
     // Send message to all the players.
     Mud::instance().broadcastMsg(0, character->getNameCapital() +
                                     " is writing the history...");
-    character->sendMsg("Ok.\n");
+    character->sendMsg("Ok, saved in %s ms.\n", stopwatch.stop() / 1000);
     return true;
 }
 
@@ -168,7 +173,7 @@ bool DoSkillList(Character * character, ArgumentHandler & /*args*/)
 bool DoGenerateMap(Character * character, ArgumentHandler & args)
 {
     std::shared_ptr<HeightMap> heightMap = nullptr;
-    if (args.size() == 1)
+    if ((args.size() >= 1) && (args.size() <= 3))
     {
         heightMap = Mud::instance().findHeightMap(
             ToNumber<unsigned int>(args[0].getContent()));
@@ -183,31 +188,29 @@ bool DoGenerateMap(Character * character, ArgumentHandler & args)
         return false;
     }
     MapGeneratorConfiguration configuration;
-    // Instantiate the map generator.
-    MapGenerator mapGenerator(configuration, heightMap);
-    // Generate the map.
-    auto map = std::make_shared<MapWrapper>();
-    if (!mapGenerator.generateMap(map))
+    // Check if the map has to be generated from a given seed.
+    if (args.size() >= 2)
     {
-        character->sendMsg("Error while generating the map.");
-        return false;
+        configuration.seed = ToNumber<unsigned int>(args[1].getContent());
     }
-    // Draw the map.
-    std::string drawnMap;
-    for (int y = 0; y < map->getHeight(); ++y)
+    // Check if the relief has to be raised with a specific algorithm.
+    if (args.size() == 3)
     {
-        for (int x = 0; x < map->getWidth(); ++x)
+        if (args[2].getContent() == "noise")
         {
-            drawnMap += map->getCell(x, y)->getTile();
+            configuration.reliefMode = ReliefMode::Noise;
+        }
+        else if (args[2].getContent() != "mountains")
+        {
+            character->sendMsg("The relief can be 'mountains' or 'noise'.\n");
+            return false;
         }
-        drawnMap += "\n";
     }
-    // First send the configuration.
+    // The map is generated in background.
+    auto id = MapGenerationService::instance().generate(
+        character->getNameCapital(), configuration, heightMap);
     character->sendMsg(configuration.toString());
-    character->sendMsg(drawnMap);
-    character->sendMsg(Formatter::reset());
-    // Add the map to the list of generated maps.
-    Mud::instance().addGeneratedMap(map);
+    character->sendMsg("The map is being generated by the job %s.\n", id);
     return true;
 }
 
@@ -266,6 +269,12 @@ bool DoDeleteGenerateMap(Character * character, ArgumentHandler & args)
         return false;
     }
     auto map = generatedMap->second;
+    // Check if the map is being built.
+    if (MapGenerationService::instance().isBuilding(map))
+    {
+        character->sendMsg("The map '%s' is being built.", vnum);
+        return false;
+    }
     Mud::instance().mudGeneratedMaps.erase(generatedMap);
     map->destroy();
     return true;
@@ -273,7 +282,7 @@ bool DoDeleteGenerateMap(Character * character, ArgumentHandler & args)
 
 bool DoBuildGenerateMap(Character * character, ArgumentHandler & args)
 {
-    if (args.size() != 2)
+    if ((args.size() != 2) && (args.size() != 3))
     {
         character->sendMsg("You must provide the vnum of a generated map and "
                                "the name of the new map.");
@@ -281,16 +290,222 @@ bool DoBuildGenerateMap(Character * character, ArgumentHandler & args)
     }
     auto vnum = ToNumber<unsigned int>(args[0].getContent());
     auto mapName = args[1].getContent();
+    // Check if the rooms have to be materialized only near the characters.
+    int radius = 0;
+    if (args.size() == 3)
+    {
+        radius = ToNumber<int>(args[2].getContent());
+        if (radius <= 0)
+        {
+            character->sendMsg("The radius must be a positive number.\n");
+            return false;
+        }
+    }
     auto generatedMap = Mud::instance().mudGeneratedMaps.find(vnum);
     if (generatedMap == Mud::instance().mudGeneratedMaps.end())
     {
         character->sendMsg("Can't find the generated map '%s'.", vnum);
         return false;
     }
-    if (!generatedMap->second->buildMap(mapName, character->getNameCapital()))
+    // The rooms are created a few at a time, while the game goes on.
+    auto id = MapGenerationService::instance().build(
+        character->getNameCapital(), generatedMap->second, mapName, radius);
+    if (id == 0)
     {
-        character->sendMsg("Can't build the map '%s'.", vnum);
+        character->sendMsg("The map '%s' is already being built.", vnum);
         return false;
     }
+    character->sendMsg("The map is being built by the job %s.\n", id);
+    return true;
+}
+
+bool DoMapJobs(Character * character, ArgumentHandler & args)
+{
+    if (args.size() == 2)
+    {
+        if (args[0].getContent() != "cancel")
+        {
+            character->sendMsg("Usage: mud_map_jobs [cancel (job)]\n");
+            return false;
+        }
+        auto id = ToNumber<unsigned int>(args[1].getContent());
+        if (!MapGenerationService::instance().cancel(id))
+        {
+            character->sendMsg("There is no running job %s.\n", id);
+            return false;
+        }
+        return true;
+    }
+    if (!args.empty())
+    {
+        character->sendMsg("Usage: mud_map_jobs [cancel (job)]\n");
+        return false;
+    }
+    auto const & jobs = MapGenerationService::instance().getJobs();
+    if (jobs.empty())
+    {
+        character->sendMsg("There are no map jobs.\n");
+        return true;
+    }
+    Table table;
+    table.addColumn("JOB", align::right);
+    table.addColumn("TYPE", align::left);
+    table.addColumn("OWNER", align::left);
+    table.addColumn("STATUS", align::left);
+    table.addColumn("PROGRESS", align::right);
+    for (auto const & job : jobs)
+    {
+        TableRow row;
+        row.emplace_back(ToString(job->id));
+        row.emplace_back(job->getTypeName());
+        row.emplace_back(job->owner);
+        row.emplace_back(job->getStatusName());
+        row.emplace_back(ToString(job->progress.load()) + "%");
+        table.addRow(row);
+    }
+    character->sendMsg(table.getTable());
+    return true;
+}
+
+bool DoMemoryInfo(Character * character, ArgumentHandler & args)
+{
+    // Update the sampled subsystems.
+    Mud::instance().sampleMemoryUsage();
+    auto & tracker = MemoryTracker::instance();
+    if ((args.size() == 1) && (args[0].getContent() == "export"))
+    {
+        auto filename = Mud::instance().getMudSystemDirectory() +
+                        "memory.prom";
+        if (!tracker.exportToFile(filename))
+        {
+            character->sendMsg("Cannot export the counters.\n");
+            return false;
+        }
+        character->sendMsg("Counters exported to '%s'.\n", filename);
+        return true;
+    }
+    Table table;
+    table.addColumn("SUBSYSTEM", align::left);
+    table.addColumn("OBJECTS", align::right);
+    table.addColumn("CURRENT", align::right);
+    table.addColumn("PEAK", align::right);
+    for (size_t it = 0;
+         it < static_cast<size_t>(MemoryCategory::Count); ++it)
+    {
+        auto category = static_cast<MemoryCategory>(it);
+        TableRow row;
+        row.emplace_back(MemoryTracker::getCategoryName(category));
+        row.emplace_back(ToString(tracker.getCount(category)));
+        row.emplace_back(MemorySizeToString(tracker.getCurrent(category)));
+        row.emplace_back(MemorySizeToString(tracker.getPeak(category)));
+        table.addRow(row);
+    }
+    character->sendMsg(table.getTable());
+    character->sendMsg("Total : %s\n",
+                       MemorySizeToString(tracker.getTotal()));
+    return true;
+}
+
+bool DoBenchmark(Character * character, ArgumentHandler & args)
+{
+    size_t queries = 100;
+    if (args.size() == 1)
+    {
+        queries = ToNumber<size_t>(args[0].getContent());
+    }
+    if (queries == 0)
+    {
+        character->sendMsg("You must provide a valid number of queries.\n");
+        return false;
+    }
+    StructureBenchmark benchmark(queries);
+    if (!benchmark.run())
+    {
+        character->sendMsg("Error while running the benchmark.\n");
+        return false;
+    }
+    Table table;
+    table.addColumn("SCENARIO", align::left);
+    table.addColumn("ROOMS", align::right);
+    table.addColumn("OPERATION", align::left);
+    table.addColumn("MEAN (us)", align::right);
+    table.addColumn("MAX (us)", align::right);
+    for (auto const & result : benchmark.getResults())
+    {
+        TableRow row;
+        row.emplace_back(result.scenario);
+        row.emplace_back(ToString(result.rooms));
+        row.emplace_back(result.operation);
+        row.emplace_back(ToString(static_cast<long>(result.getMean())));
+        row.emplace_back(ToString(static_cast<long>(result.maximum)));
+        table.addRow(row);
+    }
+    character->sendMsg(table.getTable());
+    auto filename = Mud::instance().getMudSystemDirectory() + "benchmark";
+    if (!benchmark.exportToFile(filename))
+    {
+        character->sendMsg("Cannot export the results.\n");
+        return false;
+    }
+    character->sendMsg("Results exported to '%s.json' and '%s.csv'.\n",
+                       filename, filename);
+    return true;
+}
+
+bool DoSnapshot(Character * character, ArgumentHandler & args)
+{
+    auto snapshot = SQLiteDbms::instance().getSnapshot();
+    if (snapshot == nullptr)
+    {
+        character->sendMsg("The database is not kept in memory.\n");
+        return false;
+    }
+    if ((args.size() == 1) && (args[0].getContent() == "now"))
+    {
+        snapshot->request();
+        character->sendMsg("A snapshot of the database has been requested.\n");
+        return true;
+    }
+    if ((args.size() == 2) && (args[0].getContent() == "interval"))
+    {
+        auto interval = ToNumber<unsigned int>(args[1].getContent());
+        snapshot->setInterval(interval);
+        if (interval == 0)
+        {
+            character->sendMsg("The snapshots are taken only on request.\n");
+        }
+        else
+        {
+            character->sendMsg("A snapshot is taken every %s seconds.\n",
+                               interval);
+        }
+        return true;
+    }
+    if (!args.empty())
+    {
+        character->sendMsg("Usage: mud_snapshot [now|interval (seconds)]\n");
+        return false;
+    }
+    auto report = snapshot->getReport();
+    character->sendMsg("Interval     : %s s\n", snapshot->getInterval());
+    character->sendMsg("Completed    : %s\n", report.completed);
+    character->sendMsg("Failed       : %s\n", report.failed);
+    auto journal = SQLiteDbms::instance().getJournal();
+    if (journal != nullptr)
+    {
+        character->sendMsg("Journal      : %s changes, %s syncs\n",
+                           journal->getRecords(),
+                           journal->getSyncs());
+    }
+    if (report.completed == 0)
+    {
+        character->sendMsg("Last         : never\n");
+        return true;
+    }
+    character->sendMsg("Last         : %s s ago\n",
+                       time(nullptr) - report.lastCompleted);
+    character->sendMsg("Duration     : %s ms\n", report.duration);
+    character->sendMsg("Longest step : %s ms\n", report.longestStep);
+    character->sendMsg("Pages        : %s\n", report.pages);
     return true;
 }
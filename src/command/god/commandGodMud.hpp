@@ -61,4 +61,16 @@ bool DoDeleteGenerateMap(Character * character, ArgumentHandler & args);
 /// Builds a generated map.
 bool DoBuildGenerateMap(Character * character, ArgumentHandler & args);
 
+/// Shows (or cancels) the maps generated and built in background.
+bool DoMapJobs(Character * character, ArgumentHandler & args);
+
+/// Shows the memory used by each subsystem.
+bool DoMemoryInfo(Character * character, ArgumentHandler & args);
+
+/// Times the pathfinding and field of view on synthetic areas.
+bool DoBenchmark(Character * character, ArgumentHandler & args);
+
+/// Shows (or configures) the snapshots of the database.
+bool DoSnapshot(Character * character, ArgumentHandler & args);
+
 ///@}
\ No newline at end of file
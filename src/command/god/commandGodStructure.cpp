@@ -22,7 +22,8 @@
 #include "commandGodStructure.hpp"
 #include "structureUtils.hpp"
 #include "characterUtilities.hpp"
-#include "aStar.hpp"
+#include "hierarchicalPathFinder.hpp"
+#include "areaChunks.hpp"
 #include "mud.hpp"
 
 bool DoFindPath(Character * character, ArgumentHandler & args)
@@ -33,38 +34,36 @@ bool DoFindPath(Character * character, ArgumentHandler & args)
         return false;
     }
     auto roomVnum = ToNumber<int>(args[0].getContent());
-    auto room = character->room->area->getRoom(roomVnum);
+    auto room = Mud::instance().findRoom(roomVnum);
     if (room == nullptr)
     {
         character->sendMsg("The room %s doesn't exists.\n", roomVnum);
         return false;
     }
-    auto RoomCheckFunction = [&](Room * from, Room * to)
-    {
-        // Prepare the movement options.
-        MovementOptions options;
-        options.character = character;
-        // Prepare the error string.
-        std::string error;
-        return StructUtils::checkConnection(options, from, to, error);
-    };
-    AStar<Room *> aStar(RoomCheckFunction,
-                        StructUtils::getRoomDistance,
-                        StructUtils::roomsAreEqual,
-                        StructUtils::getNeighbours);
     std::vector<Room *> path;
-    if (!aStar.findPath(character->room, room, path))
+    if (!HierarchicalPathFinder::instance().findPath(character,
+                                                     character->room,
+                                                     room,
+                                                     path))
     {
         character->sendMsg("There is no path to that room.\n\n");
         return false;
     }
     character->sendMsg("You have to go:\n");
-    Coordinates previous = character->room->coord;
+    Room * previous = character->room;
     for (auto node : path)
     {
-        auto direction = StructUtils::getDirection(previous, node->coord);
-        previous = node->coord;
-        character->sendMsg("    %s\n", direction.toString());
+        if (HierarchicalPathFinder::isTravel(previous, node))
+        {
+            character->sendMsg("    travel\n");
+        }
+        else
+        {
+            auto direction = StructUtils::getDirection(previous->coord,
+                                                       node->coord);
+            character->sendMsg("    %s\n", direction.toString());
+        }
+        previous = node;
     }
     character->sendMsg("\n");
     return true;
@@ -193,7 +192,9 @@ bool DoRoomEdit(Character * character, ArgumentHandler & args)
         QueryList value = {std::make_pair("description", input)};
         QueryList where = {
             std::make_pair("vnum", ToString(character->room->vnum))};
-        if (!SQLiteDbms::instance().updateInto("Room", value, where))
+        // The rooms of the streamed areas are saved once modified.
+        if (!StructUtils::isTransient(character->room) &&
+            !SQLiteDbms::instance().updateInto("Room", value, where))
         {
             character->sendMsg("Command gone wrong.\n");
             return false;
@@ -213,7 +214,9 @@ bool DoRoomEdit(Character * character, ArgumentHandler & args)
         QueryList value = {std::make_pair("name", input)};
         QueryList where = {
             std::make_pair("vnum", ToString(character->room->vnum))};
-        if (!SQLiteDbms::instance().updateInto("Room", value, where))
+        // The rooms of the streamed areas are saved once modified.
+        if (!StructUtils::isTransient(character->room) &&
+            !SQLiteDbms::instance().updateInto("Room", value, where))
         {
             character->sendMsg("Command gone wrong.\n");
             return false;
@@ -233,12 +236,12 @@ bool DoRoomEdit(Character * character, ArgumentHandler & args)
         {
             if (input == "R")
             {
-                SetFlag(character->room->flags, RoomFlag::Rent);
+                character->room->setFlag(RoomFlag::Rent);
                 return true;
             }
             else if (input == "P")
             {
-                SetFlag(character->room->flags, RoomFlag::Peaceful);
+                character->room->setFlag(RoomFlag::Peaceful);
                 return true;
             }
             character->sendMsg("Not a valid flag.\n");
@@ -255,12 +258,12 @@ bool DoRoomEdit(Character * character, ArgumentHandler & args)
         {
             if (input == "R")
             {
-                ClearFlag(character->room->flags, RoomFlag::Rent);
+                character->room->clearFlag(RoomFlag::Rent);
                 return true;
             }
             else if (input == "P")
             {
-                ClearFlag(character->room->flags, RoomFlag::Peaceful);
+                character->room->clearFlag(RoomFlag::Peaceful);
                 return true;
             }
             character->sendMsg("Not a valid flag.\n");
@@ -396,6 +399,17 @@ bool DoAreaInfo(Character * character, ArgumentHandler & args)
     msg += " Height    :" + ToString(area->height) + "\n";
     msg += " Elevation :" + ToString(area->elevation) + "\n";
     msg += " N. Rooms  :" + ToString(area->map.size()) + "\n";
+    if (area->chunks != nullptr)
+    {
+        auto const & chunks = area->chunks;
+        msg += " Tiles     :" + ToString(chunks->getWidth()) + "x" +
+               ToString(chunks->getHeight()) + " (" +
+               ToString(chunks->getMemoryUsage() / 1024) + " KB)\n";
+        msg += " Chunks    :" + ToString(chunks->getLoadedChunks()) + " of " +
+               ToString(chunks->getNumberOfChunks()) + " loaded\n";
+        msg += " Transient :" + ToString(chunks->getTransientRooms()) + "\n";
+        msg += " Radius    :" + ToString(chunks->getRadius()) + "\n";
+    }
     character->sendMsg(msg);
     return true;
 }
@@ -23,6 +23,7 @@
 #include "structureUtils.hpp"
 #include "command.hpp"
 #include "room.hpp"
+#include "area.hpp"
 
 bool DoOrganize(Character * character, ArgumentHandler & args)
 {
@@ -164,7 +165,9 @@ bool DoOpen(Character * character, ArgumentHandler & args)
             return false;
         }
 
-        ClearFlag(door->flags, ItemFlag::Closed);
+        door->clearFlag(ItemFlag::Closed);
+        // The door does not block the sight anymore.
+        destination->area->invalidateFov();
 
         // Display message.
         if (HasFlag(roomExit->flags, ExitFlag::Hidden))
@@ -250,7 +253,7 @@ bool DoOpen(Character * character, ArgumentHandler & args)
             character->sendMsg("It is already opened.\n");
             return false;
         }
-        ClearFlag(container->flags, ItemFlag::Closed);
+        container->clearFlag(ItemFlag::Closed);
         // Send the message to the character.
         character->sendMsg("You open %s.\n", container->getName(true));
         // Send the message inside the room.
@@ -325,7 +328,9 @@ bool DoClose(Character * character, ArgumentHandler & args)
                 "There are someone on the way, you can't close the door.\n");
             return false;
         }
-        SetFlag(door->flags, ItemFlag::Closed);
+        door->setFlag(ItemFlag::Closed);
+        // The door now blocks the sight.
+        destination->area->invalidateFov();
         // Display message.
         if (HasFlag(roomExit->flags, ExitFlag::Hidden))
         {
@@ -411,7 +416,7 @@ bool DoClose(Character * character, ArgumentHandler & args)
             character->sendMsg("It cannot be closed.\n");
             return false;
         }
-        SetFlag(container->flags, ItemFlag::Closed);
+        container->setFlag(ItemFlag::Closed);
         // Send the message to the character.
         character->sendMsg("You close %s.\n", container->getName(true));
         // Send the message inside the room.
@@ -101,14 +101,14 @@ bool DoTurn(Character * character, ArgumentHandler & args)
     if (lightItem->active)
     {
         character->sendMsg("You turn off %s.\n", item->getName(true));
-        lightItem->active = false;
+        lightItem->setActive(false);
     }
     else
     {
         if (lightItem->getAutonomy() > 0)
         {
             character->sendMsg("You turn on %s.\n", item->getName(true));
-            lightItem->active = true;
+            lightItem->setActive(true);
         }
         else
         {
@@ -238,7 +238,7 @@ bool DoKindle(Character * character, ArgumentHandler & args)
             character->sendMsg("You kindled %s using %s.\n",
                                lightItem->getName(true),
                                ignitionSource->getName(true));
-            lightItem->active = true;
+            lightItem->setActive(true);
         }
         else
         {
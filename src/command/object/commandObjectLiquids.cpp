@@ -480,7 +480,7 @@ bool DoPour(Character * character, ArgumentHandler & args)
                                        liqConSrc->getName(true),
                                        destination->getName(true));
             // Turn off the light source.
-            lightItem->active = false;
+            lightItem->setActive(false);
         }
         return true;
     }
@@ -85,12 +85,14 @@ bool DoDeposit(Character * character, ArgumentHandler & args)
     if (item->quantity <= quantity)
     {
         shopBuilding->balance += item->getPrice(true);
+        shopBuilding->dirty = true;
         MudUpdater::instance().addItemToDestroy(item);
     }
     else
     {
-        item->quantity -= quantity;
+        item->setQuantity(item->quantity - quantity);
         shopBuilding->balance += item->getPrice(false) * quantity;
+        shopBuilding->dirty = true;
     }
     return true;
 }
@@ -210,6 +212,7 @@ bool DoBuy(Character * character, ArgumentHandler & args)
     if (item->quantity <= quantity)
     {
         shop->balance += requiredValue;
+        shop->dirty = true;
 
         shop->takeOut(item);
         character->addInventoryItem(item);
@@ -245,7 +248,7 @@ bool DoBuy(Character * character, ArgumentHandler & args)
         }
         else
         {
-            coin->quantity -= iterator.second;
+            coin->setQuantity(coin->quantity - iterator.second);
             coin->updateOnDB();
         }
     }
@@ -354,6 +357,7 @@ bool DoSell(Character * character, ArgumentHandler & args)
         shop->putInside(item);
         // Decrese the shop balance.
         shop->balance -= price;
+        shop->dirty = true;
         // Send a message.
         character->sendMsg("You sell %s to %s.\n",
                            item->getName(true),
@@ -380,6 +384,7 @@ bool DoSell(Character * character, ArgumentHandler & args)
         shop->putInside(newStack);
         // Decrese the shop balance.
         shop->balance -= price;
+        shop->dirty = true;
         // Send a message.
         character->sendMsg("You sell part of %s to %s.\n",
                            item->getName(true),
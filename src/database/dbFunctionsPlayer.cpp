@@ -32,12 +32,10 @@ bool SQLiteDbms::loadPlayer(Player * player)
     stopwatch.start();
     // Retrieve the information concerning the player.
     {
-        std::string query = "SELECT * FROM Player WHERE"
-                                " name = \"" + player->name + "\";";
-        // Execute the query.
-        auto result = dbConnection.executeSelect(query.c_str());
+        auto result = dbConnection.prepare(
+            "SELECT * FROM Player WHERE name = ?;");
         // Check the result.
-        if (result == nullptr)
+        if ((result == nullptr) || !result->bind(1, player->name))
         {
             this->showLastError();
             return false;
@@ -48,7 +46,7 @@ bool SQLiteDbms::loadPlayer(Player * player)
             result->release();
             return false;
         }
-        if (!this->loadPlayerInformation(result, player))
+        if (!this->loadPlayerInformation(result.get(), player))
         {
             this->showLastError();
             result->release();
@@ -89,11 +87,9 @@ bool SQLiteDbms::searchPlayer(const std::string & name)
 {
     bool outcome = false;
     // Prepare the query.
-    std::string query = "SELECT count(*) FROM Player WHERE"
-                            " name=\"" + name + "\";";
-    // Execute the query.
-    auto result = dbConnection.executeSelect(query.c_str());
-    if (result != nullptr)
+    auto result = dbConnection.prepare(
+        "SELECT count(*) FROM Player WHERE name = ?;");
+    if ((result != nullptr) && result->bind(1, name))
     {
         if (result->next())
         {
@@ -233,13 +229,10 @@ bool SQLiteDbms::loadPlayerInformation(ResultSet * result, Player * player)
 bool SQLiteDbms::loadPlayerItems(Player * player)
 {
     // Prepare the query.
-    std::string query =
-        "SELECT item, position FROM ItemPlayer WHERE owner = \"" +
-        player->name + "\";";
-    // Execute the query.
-    auto result = dbConnection.executeSelect(query.c_str());
+    auto result = dbConnection.prepare(
+        "SELECT item, position FROM ItemPlayer WHERE owner = ?;");
     // Check the result.
-    if (result == nullptr)
+    if ((result == nullptr) || !result->bind(1, player->name))
     {
         Logger::log(LogLevel::Error, "Query result is empty.");
         this->showLastError();
@@ -311,13 +304,10 @@ bool SQLiteDbms::loadPlayerItems(Player * player)
 bool SQLiteDbms::loadPlayerSkill(Player * player)
 {
     // Prepare the query.
-    std::string query =
-        "SELECT skill, value FROM PlayerSkill WHERE "
-            "player=\"" + player->name + "\";";
-    // Execute the query.
-    auto result = dbConnection.executeSelect(query.c_str());
+    auto result = dbConnection.prepare(
+        "SELECT skill, value FROM PlayerSkill WHERE player = ?;");
     // Check the result.
-    if (result == nullptr)
+    if ((result == nullptr) || !result->bind(1, player->name))
     {
         Logger::log(LogLevel::Error, "Query result is empty.");
         this->showLastError();
@@ -345,12 +335,10 @@ bool SQLiteDbms::loadPlayerSkill(Player * player)
 bool SQLiteDbms::loadPlayerLuaVariables(Player * player)
 {
     // Prepare the query.
-    std::string query = "SELECT name, value FROM PlayerVariable WHERE"
-                            " player=\"" + player->name + "\";";
-    // Execute the query.
-    auto result = dbConnection.executeSelect(query.c_str());
+    auto result = dbConnection.prepare(
+        "SELECT name, value FROM PlayerVariable WHERE player = ?;");
     // Check the result.
-    if (result == nullptr)
+    if ((result == nullptr) || !result->bind(1, player->name))
     {
         Logger::log(LogLevel::Error, "Query result is empty.");
         this->showLastError();
@@ -0,0 +1,144 @@
+/// @file   mapBulkWriter.cpp
+/// @brief  Implements the writer which saves the rooms of a newly built
+///          map in bulk.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#include "mapBulkWriter.hpp"
+#include "sqliteDbms.hpp"
+#include "logger.hpp"
+#include "utils.hpp"
+#include "area.hpp"
+#include "room.hpp"
+
+MapBulkWriter::MapBulkWriter() :
+    roomStatement(),
+    areaListStatement(),
+    exitStatement(),
+    inTransaction(),
+    rows()
+{
+    // Nothing to do.
+}
+
+MapBulkWriter::~MapBulkWriter()
+{
+    this->commit();
+}
+
+bool MapBulkWriter::begin()
+{
+    auto & dbms = SQLiteDbms::instance();
+    roomStatement = dbms.prepare(
+        "INSERT OR REPLACE INTO `Room` VALUES(?, ?, ?, ?, ?, ?, ?, ?);");
+    areaListStatement = dbms.prepare(
+        "INSERT OR REPLACE INTO `AreaList` VALUES(?, ?);");
+    exitStatement = dbms.prepare(
+        "INSERT OR REPLACE INTO `Exit` VALUES(?, ?, ?, ?);");
+    // Check if the statements have been compiled.
+    if ((roomStatement == nullptr) || (areaListStatement == nullptr) ||
+        (exitStatement == nullptr))
+    {
+        Logger::log(LogLevel::Error, "Cannot prepare the map statements.");
+        return false;
+    }
+    if (!inTransaction)
+    {
+        dbms.beginTransaction();
+        inTransaction = true;
+    }
+    return true;
+}
+
+void MapBulkWriter::commit()
+{
+    if (inTransaction)
+    {
+        SQLiteDbms::instance().endTransaction();
+        inTransaction = false;
+    }
+    // Release the statements, otherwise the database cannot be closed.
+    roomStatement.reset();
+    areaListStatement.reset();
+    exitStatement.reset();
+}
+
+bool MapBulkWriter::saveRoom(Room * room)
+{
+    if (!roomStatement->bind(1, room->vnum) ||
+        !roomStatement->bind(2, room->coord.x) ||
+        !roomStatement->bind(3, room->coord.y) ||
+        !roomStatement->bind(4, room->coord.z) ||
+        !roomStatement->bind(5, room->terrain->vnum) ||
+        !roomStatement->bind(6, room->name) ||
+        !roomStatement->bind(7, room->description) ||
+        !roomStatement->bind(8, room->flags) ||
+        !roomStatement->execute())
+    {
+        Logger::log(LogLevel::Error, "I was not able to save the room.");
+        return false;
+    }
+    ++rows;
+    return true;
+}
+
+bool MapBulkWriter::saveAreaList(Area * area, Room * room)
+{
+    if (!areaListStatement->bind(1, area->vnum) ||
+        !areaListStatement->bind(2, room->vnum) ||
+        !areaListStatement->execute())
+    {
+        Logger::log(LogLevel::Error, "I was not able to save the area list.");
+        return false;
+    }
+    ++rows;
+    return true;
+}
+
+bool MapBulkWriter::saveRoomExit(const std::shared_ptr<Exit> & roomExit)
+{
+    if (!exitStatement->bind(1, roomExit->source->vnum) ||
+        !exitStatement->bind(2, roomExit->destination->vnum) ||
+        !exitStatement->bind(3, roomExit->direction.toUInt()) ||
+        !exitStatement->bind(4, roomExit->flags) ||
+        !exitStatement->execute())
+    {
+        Logger::log(LogLevel::Error, "I was not able to save the exit.");
+        return false;
+    }
+    ++rows;
+    return true;
+}
+
+size_t MapBulkWriter::getRows() const
+{
+    return rows;
+}
+
+std::string MapBulkWriter::getRate(size_t rows, double microseconds)
+{
+    if (microseconds <= 0)
+    {
+        return "-";
+    }
+    auto rate = (static_cast<double>(rows) * 1000000.0) / microseconds;
+    return ToString(static_cast<long>(rate));
+}
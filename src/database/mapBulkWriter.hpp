@@ -0,0 +1,100 @@
+/// @file   mapBulkWriter.hpp
+/// @brief  Defines the writer which saves the rooms of a newly built map
+///          in bulk.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "sqliteStatement.hpp"
+
+#include <memory>
+#include <string>
+
+class Area;
+
+class Room;
+
+class Exit;
+
+/// @brief Saves the rooms of a newly built map, together with their
+///         position inside the area and their exits. All the rows written
+///         between begin() and commit() share a single transaction and
+///         the same compiled statements.
+class MapBulkWriter
+{
+private:
+    /// The statement which saves a room.
+    std::shared_ptr<SQLiteStatement> roomStatement;
+    /// The statement which saves a room inside the list of an area.
+    std::shared_ptr<SQLiteStatement> areaListStatement;
+    /// The statement which saves an exit.
+    std::shared_ptr<SQLiteStatement> exitStatement;
+    /// If a transaction is open.
+    bool inTransaction;
+    /// The number of rows written.
+    size_t rows;
+
+public:
+    /// @brief Constructor.
+    MapBulkWriter();
+
+    /// @brief Destructor, it completes the transaction left open, so that
+    ///         the database keeps matching the rooms created so far.
+    ~MapBulkWriter();
+
+    /// @brief Disable Copy Construct.
+    MapBulkWriter(MapBulkWriter const &) = delete;
+
+    /// @brief Disable Move construct.
+    MapBulkWriter(MapBulkWriter &&) = delete;
+
+    /// @brief Disable Copy assign.
+    MapBulkWriter & operator=(MapBulkWriter const &) = delete;
+
+    /// @brief Disable Move assign.
+    MapBulkWriter & operator=(MapBulkWriter &&) = delete;
+
+    /// @brief Compiles the statements and opens a transaction.
+    /// @return <b>True</b> if the writer is ready,<br>
+    ///         <b>False</b> otherwise.
+    bool begin();
+
+    /// @brief Completes the transaction and releases the statements.
+    void commit();
+
+    /// @brief Saves a room.
+    bool saveRoom(Room * room);
+
+    /// @brief Saves a room inside the list of rooms of an area.
+    bool saveAreaList(Area * area, Room * room);
+
+    /// @brief Saves an exit.
+    bool saveRoomExit(const std::shared_ptr<Exit> & roomExit);
+
+    /// @brief Provides the number of rows written so far.
+    size_t getRows() const;
+
+    /// @brief Provides the rows written per second, as a string.
+    /// @param rows         The number of rows.
+    /// @param microseconds The time spent writing them.
+    static std::string getRate(size_t rows, double microseconds);
+};
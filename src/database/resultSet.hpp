@@ -87,6 +87,13 @@ public:
     ///         <b>False</b> otherwise.
     virtual bool getDataDouble(const int & column, double & data) = 0;
 
+    /// @brief Get the given column data as a blob of bytes.
+    /// @param column The number of the column.
+    /// @param data   The bytes retrieved from the cell.
+    /// @return <b>True</b> if the data has been retrieved,<br>
+    ///         <b>False</b> otherwise.
+    virtual bool getDataBlob(const int & column, std::string & data) = 0;
+
     /// @brief Get the next column data as a string.
     /// @return The string retrieved from the cell.
     virtual std::string getNextString() = 0;
@@ -102,4 +109,8 @@ public:
     /// @brief Get the next column data as a double.
     /// @return The double retrieved from the cell.
     virtual double getNextDouble() = 0;
+
+    /// @brief Get the next column data as a blob of bytes.
+    /// @return The bytes retrieved from the cell.
+    virtual std::string getNextBlob() = 0;
 };
@@ -23,6 +23,8 @@
 #include "sqliteDbms.hpp"
 
 #include "sqliteLoadFunctions.hpp"
+#include "structureUtils.hpp"
+#include "areaChunks.hpp"
 #include "logger.hpp"
 #include "mud.hpp"
 #include "sqliteException.hpp"
@@ -65,6 +67,8 @@ SQLiteDbms::SQLiteDbms() :
         TableLoader("RaceCorpse", LoadRaceCorpse));
     loaders.emplace_back(
         TableLoader("Liquid", LoadLiquid));
+    loaders.emplace_back(
+        TableLoader("AreaTiles", LoadAreaTiles));
     loaders.emplace_back(
         TableLoader("Item", LoadItem));
     loaders.emplace_back(
@@ -158,6 +162,20 @@ bool SQLiteDbms::openDatabase()
         this->showLastError();
         return false;
     }
+    // The tiles of the streamed areas have been added later, thus their
+    // table is created if the database does not have it yet.
+    dbConnection.executeQuery("CREATE TABLE IF NOT EXISTS AreaTiles("
+                                  "area INTEGER PRIMARY KEY, "
+                                  "firstRoom INTEGER NOT NULL, "
+                                  "width INTEGER NOT NULL, "
+                                  "height INTEGER NOT NULL, "
+                                  "radius INTEGER NOT NULL, "
+                                  "tiles BLOB NOT NULL);");
+    if (dbConnection.getLastErrorCode() != SQLITE_OK)
+    {
+        this->showLastError();
+        return false;
+    }
     return true;
 }
 
@@ -209,95 +227,117 @@ bool SQLiteDbms::loadTables()
     return status;
 }
 
-bool SQLiteDbms::insertInto(std::string table,
-                            std::vector<std::string> args,
-                            bool orIgnore,
-                            bool orReplace)
+std::shared_ptr<SQLiteStatement> SQLiteDbms::prepareInsertInto(
+    const std::string & table,
+    size_t columns,
+    bool orIgnore,
+    bool orReplace)
 {
-    std::stringstream stream;
-    stream << "INSERT";
+    std::string query = "INSERT";
     if (orIgnore)
     {
-        stream << " OR IGNORE";
+        query += " OR IGNORE";
     }
     else if (orReplace)
     {
-        stream << " OR REPLACE";
+        query += " OR REPLACE";
     }
-    stream << " INTO `" << table << "`" << std::endl;
-    stream << "VALUES(" << std::endl;
-    for (auto it = args.begin(); it != args.end(); ++it)
+    query += " INTO `" + table + "` VALUES(";
+    for (size_t it = 0; it < columns; ++it)
     {
-        auto value = (*it);
-        if ((it + 1) == args.end())
-        {
-            stream << "\"" << value << "\");";
-        }
-        else
+        query += (it == 0) ? "?" : ", ?";
+    }
+    query += ");";
+    return dbConnection.prepare(query);
+}
+
+bool SQLiteDbms::insertInto(std::string table,
+                            std::vector<std::string> args,
+                            bool orIgnore,
+                            bool orReplace)
+{
+    auto statement = this->prepareInsertInto(table, args.size(), orIgnore,
+                                             orReplace);
+    if (statement == nullptr)
+    {
+        return false;
+    }
+    // The values are bound as text, the columns convert them to their type.
+    for (size_t it = 0; it < args.size(); ++it)
+    {
+        if (!statement->bind(static_cast<int>(it + 1), args[it]))
         {
-            stream << "\"" << value << "\", ";
+            statement->release();
+            return false;
         }
     }
-    return (dbConnection.executeQuery(stream.str().c_str()) != 0);
+    return statement->execute();
 }
 
 bool SQLiteDbms::deleteFrom(std::string table, QueryList where)
 {
-    std::stringstream stream;
-    stream << "DELETE FROM " << table << std::endl;
-    stream << "WHERE" << std::endl;
+    std::string query = "DELETE FROM `" + table + "` WHERE ";
     for (auto it = where.begin(); it != where.end(); ++it)
     {
-        auto clause = (*it);
-        if ((it + 1) == where.end())
-        {
-            stream << "    " << clause.first
-                   << " = \"" << clause.second << "\";" << std::endl;
-        }
-        else
+        query += (it == where.begin()) ? "" : " AND ";
+        query += it->first + " = ?";
+    }
+    query += ";";
+    auto statement = dbConnection.prepare(query);
+    if (statement == nullptr)
+    {
+        return false;
+    }
+    auto index = 1;
+    for (auto const & clause : where)
+    {
+        if (!statement->bind(index++, clause.second))
         {
-            stream << "    " << clause.first
-                   << " = \"" << clause.second << "\" AND" << std::endl;
+            statement->release();
+            return false;
         }
     }
-    return (dbConnection.executeQuery(stream.str().c_str()) != 0);
+    return statement->execute();
 }
 
 bool SQLiteDbms::updateInto(std::string table, QueryList value, QueryList where)
 {
-    std::stringstream stream;
-    stream << "UPDATE " << table << std::endl;
-    stream << "SET" << std::endl;
+    std::string query = "UPDATE `" + table + "` SET ";
     for (auto it = value.begin(); it != value.end(); ++it)
     {
-        auto clause = (*it);
-        if ((it + 1) == value.end())
-        {
-            stream << "    " << clause.first
-                   << " = \"" << clause.second << "\"" << std::endl;
-        }
-        else
-        {
-            stream << "    " << clause.first
-                   << " = \"" << clause.second << "\"," << std::endl;
-        }
+        query += (it == value.begin()) ? "" : ", ";
+        query += it->first + " = ?";
     }
-    stream << "WHERE" << std::endl;
+    query += " WHERE ";
     for (auto it = where.begin(); it != where.end(); ++it)
     {
-        auto clause = (*it);
-        if ((it + 1) == where.end())
+        query += (it == where.begin()) ? "" : " AND ";
+        query += it->first + " = ?";
+    }
+    query += ";";
+    auto statement = dbConnection.prepare(query);
+    if (statement == nullptr)
+    {
+        return false;
+    }
+    auto index = 1;
+    for (auto const & clause : value)
+    {
+        if (!statement->bind(index++, clause.second))
         {
-            stream << "    " << clause.first
-                   << " = \"" << clause.second << "\";" << std::endl;
+            statement->release();
+            return false;
         }
-        else
+    }
+    for (auto const & clause : where)
+    {
+        if (!statement->bind(index++, clause.second))
         {
-            stream << "    " << clause.first
-                   << " = \"" << clause.second << "\" AND" << std::endl;
+            statement->release();
+            return false;
         }
     }
-    return (dbConnection.executeQuery(stream.str().c_str()) != 0);
+    return statement->execute();
 }
 
 bool SQLiteDbms::updatePlayers()
@@ -323,38 +363,88 @@ bool SQLiteDbms::updatePlayers()
 
 bool SQLiteDbms::updateItems()
 {
-    // Start a transaction.
-//    dbConnection.beginTransaction();
+    bool result = true;
+    size_t saved = 0;
     for (auto it : Mud::instance().mudItems)
     {
+        if (!it.second->dirty)
+        {
+            continue;
+        }
         if (!it.second->updateOnDB())
         {
             Logger::log(LogLevel::Error,
                         "Can't save the item '%s'.", it.second->getName());
             this->showLastError();
+            result = false;
+            continue;
         }
+        ++saved;
     }
-    // Complete the transaction.
-//    dbConnection.endTransaction();
-    return true;
+    Logger::log(LogLevel::Debug, "Saved %s modified items.", saved);
+    return result;
 }
 
 bool SQLiteDbms::updateRooms()
 {
-    // Start a new transaction.
-//    dbConnection.beginTransaction();
+    bool result = true;
+    size_t saved = 0;
+    // Save the modified rooms of the streamed areas, the other rooms
+    // materialized from their tiles are not saved.
+    for (auto it : Mud::instance().mudAreas)
+    {
+        if ((it.second->chunks != nullptr) && !it.second->chunks->save())
+        {
+            Logger::log(LogLevel::Error,
+                        "Can't save the tiles of '%s'.", it.second->name);
+            result = false;
+        }
+    }
     for (auto it : Mud::instance().mudRooms)
     {
+        if (!it.second->dirty || StructUtils::isTransient(it.second))
+        {
+            continue;
+        }
         if (!it.second->updateOnDB())
         {
             Logger::log(LogLevel::Error,
                         "Can't save the room '%s'.", it.second->name);
             this->showLastError();
+            result = false;
+            continue;
         }
+        ++saved;
     }
-    // Complete the transaction.
-//    dbConnection.endTransaction();
-    return true;
+    Logger::log(LogLevel::Debug, "Saved %s modified rooms.", saved);
+    return result;
+}
+
+bool SQLiteDbms::flushChanges()
+{
+    // Start a new transaction.
+    dbConnection.beginTransaction();
+    bool result = this->updateItems();
+    result &= this->updateRooms();
+    // Complete the transaction, what has failed is still dirty.
+    dbConnection.endTransaction();
+    return result;
+}
+
+std::shared_ptr<SQLiteStatement> SQLiteDbms::prepare(
+    const std::string & query)
+{
+    return dbConnection.prepare(query);
+}
+
+SQLiteSnapshot * SQLiteDbms::getSnapshot() const
+{
+    return dbConnection.getSnapshot();
+}
+
+SQLiteJournal * SQLiteDbms::getJournal() const
+{
+    return dbConnection.getJournal();
 }
 
 void SQLiteDbms::beginTransaction()
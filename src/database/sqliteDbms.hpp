@@ -93,6 +93,19 @@ public:
     ///         <b>False</b> Otherwise.
     bool searchPlayer(const std::string & name);
 
+    /// @brief Provides the statement which inserts a row into a table, with
+    ///         a parameter for each column.
+    /// @param table     Name of the table.
+    /// @param columns   The number of columns.
+    /// @param orIgnore  Flag used to enable the OR IGNORE option.
+    /// @param orReplace Flag used to enable the OR REPLACE option.
+    /// @return The statement, nullptr if it cannot be compiled.
+    std::shared_ptr<SQLiteStatement> prepareInsertInto(
+        const std::string & table,
+        size_t columns,
+        bool orIgnore = true,
+        bool orReplace = false);
+
     /// @brief Execute an Insert Into query.
     /// @param table     Name of the table.
     /// @param args      Vector of arguments.
@@ -123,12 +136,33 @@ public:
     /// Updates all the connected players.
     bool updatePlayers();
 
-    /// Updates all the items.
+    /// Updates all the items modified since they have been saved.
     bool updateItems();
 
-    /// Update all the rooms.
+    /// Update all the rooms modified since they have been saved.
     bool updateRooms();
 
+    /// @brief Writes the modified items and rooms on the database, within a
+    ///         single transaction.
+    /// @return <b>True</b> if the operations succeeded,<br>
+    ///         <b>False</b> Otherwise.
+    bool flushChanges();
+
+    /// @brief Provides a statement which can be executed many times, it is
+    ///         compiled only the first time its text is used.
+    /// @param query The text of the statement, with '?' in place of the
+    ///               parameters.
+    /// @return The statement, nullptr if it cannot be compiled.
+    std::shared_ptr<SQLiteStatement> prepare(const std::string & query);
+
+    /// @brief Provides the snapshots of the database, nullptr if the
+    ///         database has not been loaded in memory.
+    SQLiteSnapshot * getSnapshot() const;
+
+    /// @brief Provides the journal of the changes, nullptr if the database
+    ///         has not been loaded in memory.
+    SQLiteJournal * getJournal() const;
+
     /// @brief Begin a transaction.
     void beginTransaction();
 
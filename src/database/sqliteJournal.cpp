@@ -0,0 +1,544 @@
+/// @file   sqliteJournal.cpp
+/// @brief  Implements the journal of the changes made to the database.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "sqliteJournal.hpp"
+#include "sqliteStatement.hpp"
+#include "logger.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <unistd.h>
+#include <fstream>
+#include <fcntl.h>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+
+/// @brief Appends the bytes of a value to the buffer.
+template<typename T>
+static void AppendValue(std::string & buffer, const T & value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// @brief Reads a value from the buffer, advancing the offset.
+template<typename T>
+static bool ReadValue(const std::string & buffer, size_t & offset, T & value)
+{
+    if (offset + sizeof(T) > buffer.size())
+    {
+        return false;
+    }
+    std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+/// @brief Reads a string preceded by its length, advancing the offset.
+static bool ReadString(const std::string & buffer,
+                       size_t & offset,
+                       std::string & value)
+{
+    uint32_t length = 0;
+    if (!ReadValue(buffer, offset, length) ||
+        (offset + length > buffer.size()))
+    {
+        return false;
+    }
+    value = buffer.substr(offset, length);
+    offset += length;
+    return true;
+}
+
+/// @brief Computes the FNV-1a hash of a record, used to find the records
+///         which have not been completely written.
+static uint32_t Checksum(const std::string & payload)
+{
+    uint32_t hash = 2166136261u;
+    for (auto c : payload)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/// @brief Binds the encoded values to the parameters of the statement.
+static bool BindParameters(SQLiteStatement & statement,
+                           const std::string & payload,
+                           size_t offset)
+{
+    while (offset < payload.size())
+    {
+        char type = payload[offset++];
+        uint16_t index = 0;
+        if (!ReadValue(payload, offset, index))
+        {
+            return false;
+        }
+        if (type == 'i')
+        {
+            int64_t value = 0;
+            if (!ReadValue(payload, offset, value) ||
+                !statement.bind(index, value))
+            {
+                return false;
+            }
+        }
+        else if (type == 'r')
+        {
+            double value = 0;
+            if (!ReadValue(payload, offset, value) ||
+                !statement.bind(index, value))
+            {
+                return false;
+            }
+        }
+        else if ((type == 't') || (type == 'b'))
+        {
+            std::string value;
+            if (!ReadString(payload, offset, value))
+            {
+                return false;
+            }
+            if (!((type == 't') ? statement.bind(index, value)
+                                : statement.bindBlob(index, value)))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+SQLiteJournal::SQLiteJournal(std::string _directory, std::string _name) :
+    directory(_directory),
+    name(_name),
+    queries(),
+    pending(),
+    transaction(),
+    inTransaction(),
+    transactionRecords(),
+    segment(),
+    descriptor(-1),
+    records(),
+    syncs(),
+    worker(),
+    mutex(),
+    fileMutex(),
+    condition(),
+    stopping()
+{
+    // Nothing to do.
+}
+
+SQLiteJournal::~SQLiteJournal()
+{
+    this->stop();
+}
+
+size_t SQLiteJournal::replay(sqlite3 * connection)
+{
+    size_t applied = 0;
+    sqlite3_exec(connection, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+    for (auto number : this->getSegments())
+    {
+        applied += this->replaySegment(connection, number);
+    }
+    sqlite3_exec(connection, "END TRANSACTION", nullptr, nullptr, nullptr);
+    if (applied > 0)
+    {
+        Logger::log(LogLevel::Global,
+                    "Replayed %s changes from the journal.", applied);
+    }
+    return applied;
+}
+
+bool SQLiteJournal::start()
+{
+    if (worker.joinable())
+    {
+        return true;
+    }
+    // Start a segment which follows the ones already on disk.
+    auto segments = this->getSegments();
+    {
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        segment = segments.empty() ? 0 : segments.back() + 1;
+        descriptor = open(this->getSegmentPath(segment).c_str(),
+                          O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (descriptor < 0)
+        {
+            Logger::log(LogLevel::Error, "Cannot open the journal %s.",
+                        this->getSegmentPath(segment));
+            return false;
+        }
+    }
+    stopping = false;
+    worker = std::thread(&SQLiteJournal::work, this);
+    return true;
+}
+
+void SQLiteJournal::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+    // Write what has been recorded after the worker has stopped.
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        data.swap(pending);
+    }
+    if (!data.empty())
+    {
+        this->flush(data);
+    }
+    if (descriptor >= 0)
+    {
+        close(descriptor);
+        descriptor = -1;
+    }
+}
+
+void SQLiteJournal::record(const std::string & query,
+                           const std::string & parameters)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = queries.find(query);
+    if (it == queries.end())
+    {
+        auto number = static_cast<uint32_t>(queries.size());
+        it = queries.emplace(query, number).first;
+        // The text is written anyway, even if the transaction is discarded.
+        std::string payload(1, 'Q');
+        AppendValue(payload, number);
+        payload.append(query);
+        appendRecord(pending, payload);
+    }
+    std::string payload(1, 'E');
+    AppendValue(payload, it->second);
+    payload.append(parameters);
+    if (inTransaction)
+    {
+        appendRecord(transaction, payload);
+        ++transactionRecords;
+    }
+    else
+    {
+        appendRecord(pending, payload);
+        ++records;
+    }
+}
+
+void SQLiteJournal::begin()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    inTransaction = true;
+}
+
+void SQLiteJournal::commit()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.append(transaction);
+    records += transactionRecords;
+    transaction.clear();
+    transactionRecords = 0;
+    inTransaction = false;
+}
+
+void SQLiteJournal::rollback()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    transaction.clear();
+    transactionRecords = 0;
+    inTransaction = false;
+}
+
+unsigned int SQLiteJournal::rotate()
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    // Complete the current segment.
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        data.swap(pending);
+    }
+    if (!data.empty() && this->flush(data))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++syncs;
+    }
+    if (descriptor >= 0)
+    {
+        close(descriptor);
+    }
+    ++segment;
+    descriptor = open(this->getSegmentPath(segment).c_str(),
+                      O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (descriptor < 0)
+    {
+        Logger::log(LogLevel::Error, "Cannot open the journal %s.",
+                    this->getSegmentPath(segment));
+    }
+    // The new segment starts with the text of the known statements, so
+    // that it can be replayed without the previous ones.
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string definitions;
+    for (auto it : queries)
+    {
+        std::string payload(1, 'Q');
+        AppendValue(payload, it.second);
+        payload.append(it.first);
+        appendRecord(definitions, payload);
+    }
+    pending.insert(0, definitions);
+    return segment;
+}
+
+void SQLiteJournal::discard(unsigned int until)
+{
+    for (auto number : this->getSegments())
+    {
+        if (number < until)
+        {
+            std::remove(this->getSegmentPath(number).c_str());
+        }
+    }
+}
+
+size_t SQLiteJournal::getRecords() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+size_t SQLiteJournal::getSyncs() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncs;
+}
+
+void SQLiteJournal::encodeInteger(std::string & parameters,
+                                  int index,
+                                  int64_t value)
+{
+    parameters.push_back('i');
+    AppendValue(parameters, static_cast<uint16_t>(index));
+    AppendValue(parameters, value);
+}
+
+void SQLiteJournal::encodeReal(std::string & parameters,
+                               int index,
+                               double value)
+{
+    parameters.push_back('r');
+    AppendValue(parameters, static_cast<uint16_t>(index));
+    AppendValue(parameters, value);
+}
+
+void SQLiteJournal::encodeText(std::string & parameters,
+                               int index,
+                               const std::string & value)
+{
+    parameters.push_back('t');
+    AppendValue(parameters, static_cast<uint16_t>(index));
+    AppendValue(parameters, static_cast<uint32_t>(value.size()));
+    parameters.append(value);
+}
+
+void SQLiteJournal::encodeBlob(std::string & parameters,
+                               int index,
+                               const std::string & value)
+{
+    parameters.push_back('b');
+    AppendValue(parameters, static_cast<uint16_t>(index));
+    AppendValue(parameters, static_cast<uint32_t>(value.size()));
+    parameters.append(value);
+}
+
+void SQLiteJournal::work()
+{
+    long intervalLength = syncInterval;
+    auto interval = std::chrono::milliseconds(intervalLength);
+    bool last = false;
+    while (!last)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait_for(lock, interval, [this]
+            {
+                return stopping;
+            });
+            last = stopping;
+        }
+        // Write at once all the records gathered during the interval.
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        std::string data;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            data.swap(pending);
+        }
+        if (!data.empty() && this->flush(data))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++syncs;
+        }
+    }
+}
+
+bool SQLiteJournal::flush(const std::string & data)
+{
+    if (descriptor < 0)
+    {
+        return false;
+    }
+    size_t written = 0;
+    while (written < data.size())
+    {
+        auto result = write(descriptor,
+                            data.data() + written,
+                            data.size() - written);
+        if (result < 0)
+        {
+            Logger::log(LogLevel::Error, "Cannot write the journal %s.",
+                        this->getSegmentPath(segment));
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    if (fdatasync(descriptor) != 0)
+    {
+        Logger::log(LogLevel::Error, "Cannot synchronize the journal %s.",
+                    this->getSegmentPath(segment));
+        return false;
+    }
+    return true;
+}
+
+void SQLiteJournal::appendRecord(std::string & buffer,
+                                 const std::string & payload)
+{
+    AppendValue(buffer, Checksum(payload));
+    AppendValue(buffer, static_cast<uint32_t>(payload.size()));
+    buffer.append(payload);
+}
+
+std::string SQLiteJournal::getSegmentPath(unsigned int number) const
+{
+    return directory + name + "." + ToString(number) + ".journal";
+}
+
+std::vector<unsigned int> SQLiteJournal::getSegments() const
+{
+    std::vector<unsigned int> segments;
+    auto prefix = name + ".";
+    std::string suffix(".journal");
+    for (auto const & file : GetAllFilesInFolder(directory, suffix))
+    {
+        if (!BeginWith(file, prefix) ||
+            (file.size() <= prefix.size() + suffix.size()))
+        {
+            continue;
+        }
+        auto number = file.substr(prefix.size(),
+                                  file.size() - prefix.size() -
+                                  suffix.size());
+        if (IsNumber(number))
+        {
+            segments.emplace_back(ToNumber<unsigned int>(number));
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+size_t SQLiteJournal::replaySegment(sqlite3 * connection,
+                                    unsigned int number)
+{
+    auto path = this->getSegmentPath(number);
+    std::ifstream file(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+    std::unordered_map<uint32_t, std::unique_ptr<SQLiteStatement>> statements;
+    size_t applied = 0;
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        // Stop at the first record which has not been completely written.
+        std::string payload;
+        uint32_t checksum = 0;
+        if (!ReadValue(data, offset, checksum) ||
+            !ReadString(data, offset, payload) ||
+            (Checksum(payload) != checksum))
+        {
+            Logger::log(LogLevel::Warning,
+                        "The journal %s is truncated.", path);
+            break;
+        }
+        size_t position = 1;
+        uint32_t query = 0;
+        if (!ReadValue(payload, position, query))
+        {
+            continue;
+        }
+        if (payload[0] == 'Q')
+        {
+            statements[query] = std::unique_ptr<SQLiteStatement>(
+                new SQLiteStatement(connection, payload.substr(position)));
+            continue;
+        }
+        auto it = statements.find(query);
+        if ((it == statements.end()) || !it->second->isValid())
+        {
+            Logger::log(LogLevel::Error,
+                        "The journal %s refers to an unknown statement.",
+                        path);
+            continue;
+        }
+        if (BindParameters(*it->second, payload, position) &&
+            it->second->execute())
+        {
+            ++applied;
+        }
+        else
+        {
+            it->second->release();
+            Logger::log(LogLevel::Error, "Cannot replay '%s'.",
+                        it->second->getQuery());
+        }
+    }
+    return applied;
+}
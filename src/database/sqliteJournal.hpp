@@ -0,0 +1,192 @@
+/// @file   sqliteJournal.hpp
+/// @brief  Defines the journal of the changes made to the database.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <sqlite3.h>
+#include <condition_variable>
+#include <unordered_map>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+/// @brief Appends the changes made to the in-memory database to a journal,
+///         so that those made after the last snapshot survive a crash.
+/// @details
+/// Each change is recorded as the statement which has made it, followed by
+/// the values bound to its parameters. The text of a statement is written
+/// only once, then it is referred by its number. The records are gathered
+/// by the game thread and written by a background thread, which
+/// synchronizes the file once for all the records gathered meanwhile.
+/// The changes made inside a transaction are recorded once it is committed.
+/// The journal is divided in segments: when a snapshot begins a new segment
+/// is started, and the previous ones are removed once the snapshot has been
+/// taken. The statements only write the values they are given, thus
+/// replaying a change which is already in the snapshot is harmless.
+class SQLiteJournal
+{
+public:
+    /// The interval between two synchronizations of the file, in ms.
+    static const long syncInterval = 50;
+
+private:
+    /// The directory of the database.
+    std::string directory;
+    /// The name of the database, the segments are named after it.
+    std::string name;
+    /// The number given to the text of each recorded statement.
+    std::unordered_map<std::string, uint32_t> queries;
+    /// The records waiting to be written.
+    std::string pending;
+    /// The records of the transaction in progress.
+    std::string transaction;
+    /// If a transaction is in progress.
+    bool inTransaction;
+    /// The number of changes made by the transaction in progress.
+    size_t transactionRecords;
+    /// The number of the segment being written.
+    unsigned int segment;
+    /// The descriptor of the segment being written.
+    int descriptor;
+    /// The number of recorded changes.
+    size_t records;
+    /// The number of synchronizations of the file.
+    size_t syncs;
+    /// The thread which writes the records.
+    std::thread worker;
+    /// Protects the records, the statements and the counters.
+    mutable std::mutex mutex;
+    /// Protects the segment being written.
+    std::mutex fileMutex;
+    /// Wakes up the worker when it must stop.
+    std::condition_variable condition;
+    /// If the worker must stop.
+    bool stopping;
+
+public:
+    /// @brief Constructor.
+    /// @param _directory The directory of the database.
+    /// @param _name      The name of the database.
+    SQLiteJournal(std::string _directory, std::string _name);
+
+    /// @brief Destructor, it writes the remaining records.
+    ~SQLiteJournal();
+
+    /// @brief Disable Copy Construct.
+    SQLiteJournal(SQLiteJournal const &) = delete;
+
+    /// @brief Disable Move construct.
+    SQLiteJournal(SQLiteJournal &&) = delete;
+
+    /// @brief Disable Copy assign.
+    SQLiteJournal & operator=(SQLiteJournal const &) = delete;
+
+    /// @brief Disable Move assign.
+    SQLiteJournal & operator=(SQLiteJournal &&) = delete;
+
+    /// @brief Applies the changes of the segments left on disk to the
+    ///         database, it must be called before starting the journal.
+    /// @param connection The connection to the database.
+    /// @return The number of applied changes.
+    size_t replay(sqlite3 * connection);
+
+    /// @brief Opens a new segment and starts the worker.
+    /// @return <b>True</b> if the segment has been opened,<br>
+    ///         <b>False</b> otherwise.
+    bool start();
+
+    /// @brief Writes the remaining records and stops the worker.
+    void stop();
+
+    /// @brief Records a change.
+    /// @param query      The text of the statement.
+    /// @param parameters The values bound to the statement, encoded.
+    void record(const std::string & query, const std::string & parameters);
+
+    /// @brief The following changes are recorded once committed.
+    void begin();
+
+    /// @brief Records the changes of the transaction.
+    void commit();
+
+    /// @brief Discards the changes of the transaction.
+    void rollback();
+
+    /// @brief Writes the pending records, then starts a new segment.
+    /// @return The number of the new segment.
+    unsigned int rotate();
+
+    /// @brief Removes the segments which precede the given one.
+    /// @param until The number of the first segment which is kept.
+    void discard(unsigned int until);
+
+    /// @brief Provides the number of recorded changes.
+    size_t getRecords() const;
+
+    /// @brief Provides the number of synchronizations of the file.
+    size_t getSyncs() const;
+
+    /// @brief Encodes an integer bound to a parameter.
+    static void encodeInteger(std::string & parameters,
+                              int index,
+                              int64_t value);
+
+    /// @brief Encodes a real value bound to a parameter.
+    static void encodeReal(std::string & parameters, int index, double value);
+
+    /// @brief Encodes a string bound to a parameter.
+    static void encodeText(std::string & parameters,
+                           int index,
+                           const std::string & value);
+
+    /// @brief Encodes a blob bound to a parameter.
+    static void encodeBlob(std::string & parameters,
+                           int index,
+                           const std::string & value);
+
+private:
+    /// @brief The loop of the worker.
+    void work();
+
+    /// @brief Writes the given records to the segment and synchronizes it.
+    /// @return <b>True</b> if the records have been written,<br>
+    ///         <b>False</b> otherwise.
+    bool flush(const std::string & data);
+
+    /// @brief Appends a record, preceded by its checksum and its length.
+    static void appendRecord(std::string & buffer,
+                             const std::string & payload);
+
+    /// @brief Provides the path of the given segment.
+    std::string getSegmentPath(unsigned int number) const;
+
+    /// @brief Provides the numbers of the segments on disk, in order.
+    std::vector<unsigned int> getSegments() const;
+
+    /// @brief Applies the changes of a segment to the database.
+    /// @param connection The connection to the database.
+    /// @param number     The number of the segment.
+    /// @return The number of applied changes.
+    size_t replaySegment(sqlite3 * connection, unsigned int number);
+};
@@ -27,6 +27,7 @@
 #include "modelFactory.hpp"
 #include "itemFactory.hpp"
 #include "shopItem.hpp"
+#include "areaChunks.hpp"
 #include "logger.hpp"
 #include "mud.hpp"
 
@@ -315,7 +316,7 @@ bool LoadModel(ResultSet * result)
     itemModel->name = result->getNextString();
     itemModel->article = result->getNextString();
     itemModel->shortdesc = result->getNextString();
-    itemModel->keys = SplitString(result->getNextString(), " ");
+    itemModel->keys = Intern(SplitString(result->getNextString(), " "));
     itemModel->description = result->getNextString();
     itemModel->modelFlags = result->getNextUnsignedInteger();
     itemModel->baseWeight = result->getNextDouble();
@@ -500,7 +501,7 @@ bool LoadMobile(ResultSet * result)
         result->getNextInteger());
     mobile->room = mobile->respawnRoom;
     mobile->name = result->getNextString();
-    mobile->keys = GetWords(result->getNextString());
+    mobile->keys = Intern(GetWords(result->getNextString()));
     mobile->shortdesc = result->getNextString();
     mobile->staticdesc = result->getNextString();
     mobile->description = result->getNextString();
@@ -550,10 +551,11 @@ bool LoadRoom(ResultSet * result)
     room->terrain = Mud::instance().findTerrain(
         result->getNextUnsignedInteger());
     room->name = result->getNextString();
-    room->description = result->getNextString();
+    auto description = result->getNextString();
     room->flags = result->getNextUnsignedInteger();
     // Translate new_line.
-    FindAndReplace(&room->description, "%r", "\n");
+    FindAndReplace(&description, "%r", "\n");
+    room->description = description;
     // Check the correctness.
     if (!room->check())
     {
@@ -710,6 +712,32 @@ bool LoadAreaList(ResultSet * result)
     return true;
 }
 
+bool LoadAreaTiles(ResultSet * result)
+{
+    auto areaVnum = result->getNextInteger();
+    auto firstVnum = result->getNextInteger();
+    auto width = result->getNextInteger();
+    auto height = result->getNextInteger();
+    auto radius = result->getNextInteger();
+    auto area = Mud::instance().findArea(areaVnum);
+    // Check the correctness.
+    if (area == nullptr)
+    {
+        throw SQLiteException(
+            "Can't find the area " + ToString(areaVnum));
+    }
+    area->chunks = std::unique_ptr<AreaChunks>(
+        new AreaChunks(area, firstVnum, width, height, radius));
+    if (!area->chunks->setTileData(result->getNextBlob()))
+    {
+        throw SQLiteException(
+            "Wrong tiles for the area " + ToString(areaVnum));
+    }
+    // The vnums of the rooms which are not materialized are reserved.
+    Mud::instance().reserveRoomVnums(area->chunks->getLastVnum());
+    return true;
+}
+
 bool LoadWriting(ResultSet * result)
 {
     // Create an empty Writing.
@@ -106,6 +106,9 @@ bool LoadArea(ResultSet * result);
 ///         associated with every area.
 bool LoadAreaList(ResultSet * result);
 
+/// @brief Function used to retrieve the tiles of the streamed areas.
+bool LoadAreaTiles(ResultSet * result);
+
 /// @brief Function used to retrieve the writings
 bool LoadWriting(ResultSet * result);
 
@@ -0,0 +1,279 @@
+/// @file   sqliteSnapshot.cpp
+/// @brief  Implements the periodic snapshot of the in-memory database.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "sqliteSnapshot.hpp"
+#include "sqliteJournal.hpp"
+#include "stopwatch.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstdio>
+
+SnapshotReport::SnapshotReport() :
+    completed(),
+    failed(),
+    pages(),
+    duration(),
+    longestStep(),
+    lastCompleted()
+{
+    // Nothing to do.
+}
+
+SQLiteSnapshot::SQLiteSnapshot(sqlite3 * _connection,
+                               std::string _path,
+                               unsigned int _interval,
+                               std::mutex & _transactionMutex,
+                               SQLiteJournal * _journal) :
+    connection(_connection),
+    path(_path),
+    transactionMutex(_transactionMutex),
+    journal(_journal),
+    worker(),
+    mutex(),
+    condition(),
+    stopping(false),
+    requested(false),
+    interval(_interval),
+    report()
+{
+    // Nothing to do.
+}
+
+SQLiteSnapshot::~SQLiteSnapshot()
+{
+    this->stop();
+}
+
+bool SQLiteSnapshot::start()
+{
+    // The worker shares the connection with the game thread.
+    if (sqlite3_threadsafe() != 1)
+    {
+        Logger::log(LogLevel::Warning, "SQLite is not serialized, the "
+            "database is saved only at shutdown.");
+        return false;
+    }
+    if (!worker.joinable())
+    {
+        stopping = false;
+        worker = std::thread(&SQLiteSnapshot::work, this);
+    }
+    return true;
+}
+
+void SQLiteSnapshot::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void SQLiteSnapshot::setInterval(unsigned int _interval)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        interval = _interval;
+    }
+    condition.notify_all();
+}
+
+unsigned int SQLiteSnapshot::getInterval() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return interval;
+}
+
+void SQLiteSnapshot::request()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requested = true;
+    }
+    condition.notify_all();
+}
+
+SnapshotReport SQLiteSnapshot::getReport() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return report;
+}
+
+void SQLiteSnapshot::work()
+{
+    auto last = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        auto due = last + std::chrono::seconds(interval);
+        // Wait for the interval to elapse or for a request.
+        if (!requested &&
+            ((interval == 0) || (std::chrono::steady_clock::now() < due)))
+        {
+            if (interval == 0)
+            {
+                condition.wait(lock);
+            }
+            else
+            {
+                condition.wait_until(lock, due);
+            }
+            continue;
+        }
+        requested = false;
+        lock.unlock();
+        Stopwatch<std::chrono::microseconds> stopwatch("Snapshot");
+        stopwatch.start();
+        int pages = 0;
+        double longestStep = 0;
+        auto taken = this->takeSnapshot(pages, longestStep);
+        auto duration = stopwatch.stop() / 1000;
+        last = std::chrono::steady_clock::now();
+        lock.lock();
+        if (!taken)
+        {
+            ++report.failed;
+            continue;
+        }
+        ++report.completed;
+        report.pages = pages;
+        report.duration = duration;
+        report.longestStep = longestStep;
+        report.lastCompleted = time(nullptr);
+        Logger::log(LogLevel::Global,
+                    "Snapshot of the database taken in %s ms, %s pages, "
+                        "longest step %s ms.",
+                    duration, pages, longestStep);
+    }
+}
+
+bool SQLiteSnapshot::takeSnapshot(int & pages, double & longestStep)
+{
+    // The changes recorded from now on might not be in the snapshot.
+    auto segment = (journal != nullptr) ? journal->rotate() : 0;
+    auto temporary = path + ".tmp";
+    std::remove(temporary.c_str());
+    sqlite3 * destination = nullptr;
+    if (sqlite3_open(temporary.c_str(), &destination) != SQLITE_OK)
+    {
+        Logger::log(LogLevel::Error, "Cannot open the snapshot %s.",
+                    temporary);
+        sqlite3_close(destination);
+        return false;
+    }
+    // The file is synchronized once it is complete, outside of the steps.
+    sqlite3_exec(destination,
+                 "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;",
+                 nullptr, nullptr, nullptr);
+    auto backup = sqlite3_backup_init(destination, "main",
+                                      connection, "main");
+    if (backup == nullptr)
+    {
+        Logger::log(LogLevel::Error, "Cannot start the snapshot : %s.",
+                    std::string(sqlite3_errmsg(destination)));
+        sqlite3_close(destination);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    auto code = SQLITE_OK;
+    long pauseLength = stepPause;
+    auto pause = std::chrono::milliseconds(pauseLength);
+    Stopwatch<std::chrono::microseconds> stopwatch("Step");
+    while (!stopping.load())
+    {
+        {
+            // Copy the pages only between two transactions, the game thread
+            // cannot begin a transaction during a step.
+            std::lock_guard<std::mutex> lock(transactionMutex);
+            if (sqlite3_get_autocommit(connection) == 0)
+            {
+                code = SQLITE_BUSY;
+            }
+            else
+            {
+                // The game thread waits for the database only during a step.
+                stopwatch.start();
+                code = sqlite3_backup_step(backup, pagesPerStep);
+                longestStep = std::max(longestStep, stopwatch.stop() / 1000);
+            }
+        }
+        if ((code != SQLITE_OK) &&
+            (code != SQLITE_BUSY) &&
+            (code != SQLITE_LOCKED))
+        {
+            break;
+        }
+        // Pause between the steps, unless the worker is stopped.
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, pause, [this]()
+        {
+            return stopping.load();
+        });
+    }
+    pages = sqlite3_backup_pagecount(backup);
+    sqlite3_backup_finish(backup);
+    sqlite3_close(destination);
+    if (code != SQLITE_DONE)
+    {
+        if (!stopping.load())
+        {
+            Logger::log(LogLevel::Error, "Snapshot stopped with code %s.",
+                        code);
+        }
+        std::remove(temporary.c_str());
+        return false;
+    }
+    // Flush the snapshot to the disk, then replace the database file.
+    auto descriptor = open(temporary.c_str(), O_RDONLY);
+    if ((descriptor < 0) || (fsync(descriptor) != 0))
+    {
+        Logger::log(LogLevel::Error, "Cannot synchronize the snapshot.");
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+        std::remove(temporary.c_str());
+        return false;
+    }
+    close(descriptor);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        Logger::log(LogLevel::Error, "Cannot replace %s with the snapshot.",
+                    path);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    // The changes recorded before the snapshot are not needed anymore.
+    if (journal != nullptr)
+    {
+        journal->discard(segment);
+    }
+    return true;
+}
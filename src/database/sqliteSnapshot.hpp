@@ -0,0 +1,166 @@
+/// @file   sqliteSnapshot.hpp
+/// @brief  Defines the periodic snapshot of the in-memory database.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <sqlite3.h>
+#include <condition_variable>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <ctime>
+
+class SQLiteJournal;
+
+/// @brief The outcome of the snapshots of the database.
+class SnapshotReport
+{
+public:
+    /// The number of completed snapshots.
+    unsigned int completed;
+    /// The number of failed snapshots.
+    unsigned int failed;
+    /// The number of pages copied by the last snapshot.
+    int pages;
+    /// The duration of the last snapshot, in milliseconds.
+    double duration;
+    /// The longest step of the last snapshot, in milliseconds. During a
+    /// step the game thread cannot access the database.
+    double longestStep;
+    /// When the last snapshot has been completed.
+    time_t lastCompleted;
+
+    /// @brief Constructor.
+    SnapshotReport();
+};
+
+/// @brief Copies the in-memory database to its file from a background
+///         thread, at regular intervals.
+/// @details
+/// The pages are copied by the backup API a few at a time, pausing between
+/// two steps, so that the game thread is never kept waiting for long. The
+/// copy is written to a temporary file which then replaces the database
+/// file, thus a crash during a snapshot leaves the previous one intact.
+/// The changes made during a snapshot through the same connection are
+/// copied as well. The pages are copied only while no transaction is in
+/// progress, otherwise the snapshot could contain a transaction half done
+/// or one which is then rolled back. When a snapshot begins the journal starts a new segment,
+/// the previous ones are removed once the snapshot has been taken.
+class SQLiteSnapshot
+{
+public:
+    /// The default interval between two snapshots, in seconds.
+    static const unsigned int defaultInterval = 300;
+
+private:
+    /// The number of pages copied at each step.
+    static const int pagesPerStep = 64;
+    /// The pause between two steps, in milliseconds.
+    static const long stepPause = 2;
+    /// The connection to the in-memory database.
+    sqlite3 * connection;
+    /// The path of the database file.
+    std::string path;
+    /// Held while the game thread begins or ends a transaction.
+    std::mutex & transactionMutex;
+    /// The journal of the changes, nullptr if there is none.
+    SQLiteJournal * journal;
+    /// The thread which takes the snapshots.
+    std::thread worker;
+    /// Protects the interval, the request and the report.
+    mutable std::mutex mutex;
+    /// Wakes up the worker before the interval has elapsed.
+    std::condition_variable condition;
+    /// If the worker must stop, it is atomic since the steps of a snapshot
+    /// check it without holding the mutex.
+    std::atomic<bool> stopping;
+    /// If a snapshot has been requested.
+    bool requested;
+    /// The interval between two snapshots in seconds, 0 if the snapshots
+    /// are only taken when requested.
+    unsigned int interval;
+    /// The outcome of the snapshots.
+    SnapshotReport report;
+
+public:
+    /// @brief Constructor.
+    /// @param _connection The connection to the in-memory database.
+    /// @param _path       The path of the database file.
+    /// @param _interval   The interval between two snapshots, in seconds.
+    /// @param _transactionMutex The mutex held while a transaction begins
+    ///                           or ends.
+    /// @param _journal    The journal of the changes.
+    SQLiteSnapshot(sqlite3 * _connection,
+                   std::string _path,
+                   unsigned int _interval,
+                   std::mutex & _transactionMutex,
+                   SQLiteJournal * _journal = nullptr);
+
+    /// @brief Destructor, it stops the worker.
+    ~SQLiteSnapshot();
+
+    /// @brief Disable Copy Construct.
+    SQLiteSnapshot(SQLiteSnapshot const &) = delete;
+
+    /// @brief Disable Move construct.
+    SQLiteSnapshot(SQLiteSnapshot &&) = delete;
+
+    /// @brief Disable Copy assign.
+    SQLiteSnapshot & operator=(SQLiteSnapshot const &) = delete;
+
+    /// @brief Disable Move assign.
+    SQLiteSnapshot & operator=(SQLiteSnapshot &&) = delete;
+
+    /// @brief Starts the worker.
+    /// @return <b>True</b> if the worker has been started,<br>
+    ///         <b>False</b> if SQLite cannot be used by more threads.
+    bool start();
+
+    /// @brief Stops the worker, a snapshot in progress is abandoned.
+    void stop();
+
+    /// @brief Sets the interval between two snapshots, in seconds, 0 takes
+    ///         the snapshots only when requested.
+    void setInterval(unsigned int _interval);
+
+    /// @brief Provides the interval between two snapshots, in seconds.
+    unsigned int getInterval() const;
+
+    /// @brief Asks the worker to take a snapshot as soon as possible.
+    void request();
+
+    /// @brief Provides the outcome of the snapshots.
+    SnapshotReport getReport() const;
+
+private:
+    /// @brief The loop of the worker.
+    void work();
+
+    /// @brief Copies the database to the temporary file, then replaces the
+    ///         database file with it.
+    /// @param pages       Where the number of copied pages is stored.
+    /// @param longestStep Where the longest step is stored, in ms.
+    /// @return <b>True</b> if the snapshot has been taken,<br>
+    ///         <b>False</b> otherwise.
+    bool takeSnapshot(int & pages, double & longestStep);
+};
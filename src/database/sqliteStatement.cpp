@@ -0,0 +1,402 @@
+/// @file   sqliteStatement.cpp
+/// @brief  Implements a prepared statement, which can be executed many
+///          times with different parameters.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#include "sqliteStatement.hpp"
+#include "sqliteException.hpp"
+#include "sqliteJournal.hpp"
+#include "logger.hpp"
+#include "utils.hpp"
+
+SQLiteStatement::SQLiteStatement(sqlite3 * _connection,
+                                 std::string _query,
+                                 SQLiteJournal * _journal) :
+    connection(_connection),
+    statement(),
+    query(_query),
+    errorCode(SQLITE_OK),
+    errorMessage(),
+    currentColumn(),
+    journal(_journal),
+    parameters()
+{
+    this->check(sqlite3_prepare_v2(connection, query.c_str(), -1,
+                                   &statement, nullptr));
+    // Only the statements which change the database are recorded.
+    if ((statement == nullptr) || (sqlite3_stmt_readonly(statement) != 0))
+    {
+        journal = nullptr;
+    }
+}
+
+SQLiteStatement::~SQLiteStatement()
+{
+    sqlite3_finalize(statement);
+}
+
+bool SQLiteStatement::isValid() const
+{
+    return statement != nullptr;
+}
+
+bool SQLiteStatement::bind(int index, int value)
+{
+    if (!this->check(sqlite3_bind_int(statement, index, value)))
+    {
+        return false;
+    }
+    if (journal != nullptr)
+    {
+        SQLiteJournal::encodeInteger(parameters, index, value);
+    }
+    return true;
+}
+
+bool SQLiteStatement::bind(int index, unsigned int value)
+{
+    return this->bind(index, static_cast<int64_t>(value));
+}
+
+bool SQLiteStatement::bind(int index, int64_t value)
+{
+    if (!this->check(sqlite3_bind_int64(statement, index,
+                                        static_cast<sqlite3_int64>(value))))
+    {
+        return false;
+    }
+    if (journal != nullptr)
+    {
+        SQLiteJournal::encodeInteger(parameters, index, value);
+    }
+    return true;
+}
+
+bool SQLiteStatement::bind(int index, double value)
+{
+    if (!this->check(sqlite3_bind_double(statement, index, value)))
+    {
+        return false;
+    }
+    if (journal != nullptr)
+    {
+        SQLiteJournal::encodeReal(parameters, index, value);
+    }
+    return true;
+}
+
+bool SQLiteStatement::bind(int index, const std::string & value)
+{
+    if (!this->check(sqlite3_bind_text(statement,
+                                       index,
+                                       value.c_str(),
+                                       static_cast<int>(value.size()),
+                                       SQLITE_TRANSIENT)))
+    {
+        return false;
+    }
+    if (journal != nullptr)
+    {
+        SQLiteJournal::encodeText(parameters, index, value);
+    }
+    return true;
+}
+
+bool SQLiteStatement::bindBlob(int index, const std::string & value)
+{
+    if (!this->check(sqlite3_bind_blob(statement,
+                                       index,
+                                       value.data(),
+                                       static_cast<int>(value.size()),
+                                       SQLITE_TRANSIENT)))
+    {
+        return false;
+    }
+    if (journal != nullptr)
+    {
+        SQLiteJournal::encodeBlob(parameters, index, value);
+    }
+    return true;
+}
+
+bool SQLiteStatement::execute()
+{
+    if (statement == nullptr)
+    {
+        return false;
+    }
+    auto code = sqlite3_step(statement);
+    // Record the change once it has been made.
+    if ((journal != nullptr) &&
+        (code == SQLITE_DONE) &&
+        (sqlite3_changes(connection) > 0))
+    {
+        journal->record(query, parameters);
+    }
+    parameters.clear();
+    // Reset the statement even when it fails, so that it can be reused.
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+    return this->check((code == SQLITE_DONE) ? SQLITE_OK : code);
+}
+
+bool SQLiteStatement::isBusy() const
+{
+    return (statement != nullptr) && (sqlite3_stmt_busy(statement) != 0);
+}
+
+const std::string & SQLiteStatement::getQuery() const
+{
+    return query;
+}
+
+int SQLiteStatement::getLastErrorCode() const
+{
+    return errorCode;
+}
+
+std::string SQLiteStatement::getLastErrorMsg() const
+{
+    return errorMessage;
+}
+
+bool SQLiteStatement::next()
+{
+    // Reset the column number.
+    currentColumn = 0;
+    if (statement == nullptr)
+    {
+        return false;
+    }
+    auto code = sqlite3_step(statement);
+    if (code == SQLITE_ROW)
+    {
+        return true;
+    }
+    this->check((code == SQLITE_DONE) ? SQLITE_OK : code);
+    return false;
+}
+
+bool SQLiteStatement::release()
+{
+    // The statement is only reset, so that it can be executed again.
+    currentColumn = 0;
+    parameters.clear();
+    if (statement != nullptr)
+    {
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+    }
+    return true;
+}
+
+int SQLiteStatement::getColumnCount()
+{
+    return (statement != nullptr) ? sqlite3_column_count(statement) : 0;
+}
+
+bool SQLiteStatement::getColumnName(const int & column,
+                                    std::string & columnName)
+{
+    if (!this->checkColumn(column, SQLITE_NULL, nullptr))
+    {
+        return false;
+    }
+    columnName = sqlite3_column_name(statement, column);
+    return true;
+}
+
+bool SQLiteStatement::getDataString(const int & column, std::string & data)
+{
+    if (!this->checkColumn(column, SQLITE_TEXT, "a Text"))
+    {
+        return false;
+    }
+    auto ptr = reinterpret_cast<const char *>(
+        sqlite3_column_text(statement, column));
+    if (ptr == nullptr)
+    {
+        return false;
+    }
+    data = std::string(ptr);
+    return true;
+}
+
+bool SQLiteStatement::getDataInteger(const int & column, int & data)
+{
+    if (!this->checkColumn(column, SQLITE_INTEGER, "an Integer"))
+    {
+        return false;
+    }
+    data = sqlite3_column_int(statement, column);
+    return true;
+}
+
+bool SQLiteStatement::getDataUnsignedInteger(const int & column,
+                                             unsigned int & data)
+{
+    if (!this->checkColumn(column, SQLITE_INTEGER, "an Unsigned Integer"))
+    {
+        return false;
+    }
+    auto retrievedData = sqlite3_column_int(statement, column);
+    if (retrievedData < 0)
+    {
+        errorMessage = "Column at index (" + ToString(column) +
+                       ") does not contain an Unsigned Integer.";
+        errorCode = SQLITE_MISMATCH;
+        return false;
+    }
+    data = static_cast<unsigned int>(retrievedData);
+    return true;
+}
+
+bool SQLiteStatement::getDataDouble(const int & column, double & data)
+{
+    // An integer is a valid double too.
+    if ((statement == nullptr) ||
+        (sqlite3_column_type(statement, column) != SQLITE_INTEGER))
+    {
+        if (!this->checkColumn(column, SQLITE_FLOAT, "a Double"))
+        {
+            return false;
+        }
+    }
+    data = sqlite3_column_double(statement, column);
+    return true;
+}
+
+bool SQLiteStatement::getDataBlob(const int & column, std::string & data)
+{
+    if (!this->checkColumn(column, SQLITE_BLOB, "a Blob"))
+    {
+        return false;
+    }
+    // The bytes can contain zeros, thus their number is retrieved too.
+    auto ptr = reinterpret_cast<const char *>(
+        sqlite3_column_blob(statement, column));
+    auto size = sqlite3_column_bytes(statement, column);
+    if ((ptr == nullptr) || (size < 0))
+    {
+        return false;
+    }
+    data.assign(ptr, static_cast<size_t>(size));
+    return true;
+}
+
+std::string SQLiteStatement::getNextString()
+{
+    std::string data;
+    if (this->getDataString(currentColumn, data))
+    {
+        // Increase the column index.
+        currentColumn++;
+        return data;
+    }
+    throw SQLiteException(errorCode, errorMessage);
+}
+
+int SQLiteStatement::getNextInteger()
+{
+    int data;
+    if (this->getDataInteger(currentColumn, data))
+    {
+        // Increase the column index.
+        currentColumn++;
+        return data;
+    }
+    throw SQLiteException(errorCode, errorMessage);
+}
+
+unsigned int SQLiteStatement::getNextUnsignedInteger()
+{
+    unsigned int data;
+    if (this->getDataUnsignedInteger(currentColumn, data))
+    {
+        // Increase the column index.
+        currentColumn++;
+        return data;
+    }
+    throw SQLiteException(errorCode, errorMessage);
+}
+
+double SQLiteStatement::getNextDouble()
+{
+    double data;
+    if (this->getDataDouble(currentColumn, data))
+    {
+        // Increase the column index.
+        currentColumn++;
+        return data;
+    }
+    throw SQLiteException(errorCode, errorMessage);
+}
+
+std::string SQLiteStatement::getNextBlob()
+{
+    std::string data;
+    if (this->getDataBlob(currentColumn, data))
+    {
+        // Increase the column index.
+        currentColumn++;
+        return data;
+    }
+    throw SQLiteException(errorCode, errorMessage);
+}
+
+bool SQLiteStatement::check(int code)
+{
+    errorCode = code;
+    if (code == SQLITE_OK)
+    {
+        return true;
+    }
+    errorMessage = (connection != nullptr) ? sqlite3_errmsg(connection) : "";
+    Logger::log(LogLevel::Error, "Error code :" + ToString(errorCode));
+    Logger::log(LogLevel::Error, "Last error :" + this->getLastErrorMsg());
+    Logger::log(LogLevel::Error, "Statement  :" + query);
+    return false;
+}
+
+bool SQLiteStatement::checkColumn(int column, int type, const char * typeName)
+{
+    // Check if the given column is inside the boundaries.
+    if ((statement == nullptr) ||
+        (column < 0) ||
+        (column >= sqlite3_column_count(statement)))
+    {
+        errorMessage = "Column index (" + ToString(column) +
+                       ") is outside the boundaries.";
+        errorCode = SQLITE_CONSTRAINT;
+        return false;
+    }
+    // Check the type of the value, when it is required.
+    if ((typeName != nullptr) &&
+        (sqlite3_column_type(statement, column) != type))
+    {
+        errorMessage = "Column at index (" + ToString(column) +
+                       ") does not contain " + typeName + ".";
+        errorCode = SQLITE_MISMATCH;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,198 @@
+/// @file   sqliteStatement.hpp
+/// @brief  Defines a prepared statement, which can be executed many times
+///          with different parameters.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "resultSet.hpp"
+
+#include <sqlite3.h>
+#include <cstdint>
+#include <string>
+
+class SQLiteJournal;
+
+/// @brief A statement compiled once and executed many times, binding new
+///         values to its parameters every time. The rows produced by a
+///         query are read through the ResultSet interface, releasing them
+///         resets the statement. The statement is finalized when it is
+///         destroyed.
+class SQLiteStatement :
+    public ResultSet
+{
+private:
+    /// The connection which has compiled the statement.
+    sqlite3 * connection;
+    /// The compiled statement.
+    sqlite3_stmt * statement;
+    /// The text of the statement.
+    std::string query;
+    /// Last error code.
+    int errorCode;
+    /// Last error message.
+    std::string errorMessage;
+    /// Current column of the row.
+    int currentColumn;
+    /// The journal where the changes are recorded, nullptr if the
+    /// statement does not change the database.
+    SQLiteJournal * journal;
+    /// The values bound to the parameters, encoded for the journal.
+    std::string parameters;
+
+public:
+    /// @brief Constructor, it compiles the statement.
+    /// @param _connection The connection to the database.
+    /// @param _query      The text of the statement, with '?' in place of
+    ///                     the parameters.
+    /// @param _journal    The journal where the changes are recorded.
+    SQLiteStatement(sqlite3 * _connection,
+                    std::string _query,
+                    SQLiteJournal * _journal = nullptr);
+
+    /// @brief Destructor.
+    ~SQLiteStatement();
+
+    /// @brief Disable Copy Construct.
+    SQLiteStatement(SQLiteStatement const &) = delete;
+
+    /// @brief Disable Move construct.
+    SQLiteStatement(SQLiteStatement &&) = delete;
+
+    /// @brief Disable Copy assign.
+    SQLiteStatement & operator=(SQLiteStatement const &) = delete;
+
+    /// @brief Disable Move assign.
+    SQLiteStatement & operator=(SQLiteStatement &&) = delete;
+
+    /// @brief Checks if the statement has been compiled.
+    bool isValid() const;
+
+    /// @brief Binds an integer to a parameter.
+    /// @param index The index of the parameter, starting from 1.
+    /// @param value The value.
+    /// @return <b>True</b> if the value has been bound,<br>
+    ///         <b>False</b> otherwise.
+    bool bind(int index, int value);
+
+    /// @brief Binds an unsigned integer to a parameter.
+    bool bind(int index, unsigned int value);
+
+    /// @brief Binds a 64-bit integer to a parameter.
+    bool bind(int index, int64_t value);
+
+    /// @brief Binds a real value to a parameter.
+    bool bind(int index, double value);
+
+    /// @brief Binds a string to a parameter, the string is copied.
+    bool bind(int index, const std::string & value);
+
+    /// @brief Binds a blob to a parameter, the bytes are copied.
+    bool bindBlob(int index, const std::string & value);
+
+    /// @brief Binds the given values to the parameters, in order, starting
+    ///         from the first one. If a value cannot be bound, the values
+    ///         already bound are discarded.
+    /// @return <b>True</b> if all the values have been bound,<br>
+    ///         <b>False</b> otherwise.
+    template<typename ... Args>
+    bool bindAll(const Args & ... args)
+    {
+        if (this->bindFrom(1, args...))
+        {
+            return true;
+        }
+        // Do not leave the values to the next use of a cached statement.
+        this->release();
+        return false;
+    }
+
+    /// @brief Executes the statement with the bound values, then resets
+    ///         it so that it can be executed again.
+    /// @return <b>True</b> if the statement has been executed,<br>
+    ///         <b>False</b> otherwise.
+    bool execute();
+
+    /// @brief Checks if the statement is being executed, thus if it has
+    ///         rows which have not been released yet.
+    bool isBusy() const;
+
+    /// @brief Provides the text of the statement.
+    const std::string & getQuery() const;
+
+    /// @brief Get the last error code.
+    int getLastErrorCode() const;
+
+    /// @brief Get the last error message.
+    std::string getLastErrorMsg() const;
+
+    bool next() override;
+
+    bool release() override;
+
+    int getColumnCount() override;
+
+    bool getColumnName(const int & column, std::string & columnName) override;
+
+    bool getDataString(const int & column, std::string & data) override;
+
+    bool getDataInteger(const int & column, int & data) override;
+
+    bool getDataUnsignedInteger(const int & column,
+                                unsigned int & data) override;
+
+    bool getDataDouble(const int & column, double & data) override;
+
+    bool getDataBlob(const int & column, std::string & data) override;
+
+    std::string getNextString() override;
+
+    int getNextInteger() override;
+
+    unsigned int getNextUnsignedInteger() override;
+
+    double getNextDouble() override;
+
+    std::string getNextBlob() override;
+
+private:
+    /// @brief Checks the outcome of an operation and logs the errors.
+    bool check(int code);
+
+    /// @brief Checks if the given column exists and contains a value of the
+    ///         given type.
+    bool checkColumn(int column, int type, const char * typeName);
+
+    /// @brief Stops the recursion of bindAll.
+    bool bindFrom(int)
+    {
+        return true;
+    }
+
+    /// @brief Binds the values to the parameters, starting from the given
+    ///         index.
+    template<typename T, typename ... Args>
+    bool bindFrom(int index, const T & value, const Args & ... args)
+    {
+        return this->bind(index, value) && this->bindFrom(index + 1, args...);
+    }
+};
@@ -25,12 +25,18 @@
 #include "logger.hpp"
 #include "utils.hpp"
 
+#include <limits>
+
 SQLiteWrapper::SQLiteWrapper() :
     dbDetails(),
     errorMessage(),
     errorCode(),
     num_col(),
-    currentColumn()
+    currentColumn(),
+    statements(),
+    journal(),
+    transactionMutex(),
+    snapshot()
 {
     // Nothing to do.
 }
@@ -74,6 +80,28 @@ bool SQLiteWrapper::openConnection(const std::string & dbName,
                 return false;
             }
         }
+        // Apply the changes made after the last snapshot, then record the
+        // following ones.
+        journal = std::unique_ptr<SQLiteJournal>(
+            new SQLiteJournal(dbDetails.dbDirectory, dbDetails.dbName));
+        auto replayed = journal->replay(dbDetails.dbConnection);
+        if (!journal->start())
+        {
+            journal.reset();
+        }
+        // Periodically copy the database back to the file.
+        snapshot = std::unique_ptr<SQLiteSnapshot>(
+            new SQLiteSnapshot(dbDetails.dbConnection,
+                               dbPath,
+                               SQLiteSnapshot::defaultInterval,
+                               transactionMutex,
+                               journal.get()));
+        snapshot->start();
+        // Fold the replayed changes into the database file.
+        if (replayed > 0)
+        {
+            snapshot->request();
+        }
     }
     else
     {
@@ -106,6 +134,14 @@ bool SQLiteWrapper::closeConnection()
 {
     if (dbDetails.dbConnection)
     {
+        // Stop the snapshots and the journal before the final save.
+        snapshot.reset();
+        if (journal != nullptr)
+        {
+            journal->stop();
+        }
+        // The connection cannot be closed while there are statements.
+        statements.clear();
         bool retry = false;
         int numberOfRetries = 0;
         do
@@ -121,6 +157,11 @@ bool SQLiteWrapper::closeConnection()
                     Logger::log(LogLevel::Error, "Error while saving the "
                         "in-memory database to file.");
                 }
+                else if (journal != nullptr)
+                {
+                    // The file contains all the changes.
+                    journal->discard(std::numeric_limits<unsigned int>::max());
+                }
             }
             errorCode = sqlite3_close(dbDetails.dbConnection);
             if (errorCode == SQLITE_OK)
@@ -189,19 +230,74 @@ int SQLiteWrapper::executeQuery(const char * query)
     return sqlite3_total_changes(dbDetails.dbConnection);
 }
 
+std::shared_ptr<SQLiteStatement> SQLiteWrapper::prepare(
+    const std::string & query)
+{
+    if (!this->isConnected())
+    {
+        return nullptr;
+    }
+    // Check if the statement has already been compiled, a statement whose
+    // rows are still being read cannot be shared.
+    auto it = statements.find(query);
+    if ((it != statements.end()) && !it->second->isBusy())
+    {
+        return it->second;
+    }
+    auto statement = std::make_shared<SQLiteStatement>(dbDetails.dbConnection,
+                                                       query,
+                                                       journal.get());
+    if (!statement->isValid())
+    {
+        errorCode = statement->getLastErrorCode();
+        errorMessage = statement->getLastErrorMsg();
+        return nullptr;
+    }
+    if (it == statements.end())
+    {
+        statements.emplace(query, statement);
+    }
+    return statement;
+}
+
+SQLiteSnapshot * SQLiteWrapper::getSnapshot() const
+{
+    return snapshot.get();
+}
+
+SQLiteJournal * SQLiteWrapper::getJournal() const
+{
+    return journal.get();
+}
+
 void SQLiteWrapper::beginTransaction()
 {
+    std::lock_guard<std::mutex> lock(transactionMutex);
     executeQuery("BEGIN TRANSACTION");
+    if ((journal != nullptr) && (errorCode == SQLITE_OK))
+    {
+        journal->begin();
+    }
 }
 
 void SQLiteWrapper::endTransaction()
 {
+    std::lock_guard<std::mutex> lock(transactionMutex);
     executeQuery("END TRANSACTION");
+    if ((journal != nullptr) && (errorCode == SQLITE_OK))
+    {
+        journal->commit();
+    }
 }
 
 void SQLiteWrapper::rollbackTransection()
 {
+    std::lock_guard<std::mutex> lock(transactionMutex);
     executeQuery("ROLLBACK TRANSACTION");
+    if (journal != nullptr)
+    {
+        journal->rollback();
+    }
 }
 
 bool SQLiteWrapper::isConnected()
@@ -359,6 +455,37 @@ bool SQLiteWrapper::getDataDouble(const int & column, double & data)
     return true;
 }
 
+bool SQLiteWrapper::getDataBlob(const int & column, std::string & data)
+{
+    // Check if the given column is inside the boundaries.
+    if ((column < 0) || (column > num_col))
+    {
+        errorMessage = "Column index (" + ToString(column) +
+                       ") is outside the boundaries.";
+        errorCode = SQLITE_CONSTRAINT;
+        return false;
+    }
+    // Check if the retrieved data is a blob.
+    if (sqlite3_column_type(dbDetails.dbStatement, column) != SQLITE_BLOB)
+    {
+        errorMessage = "Column at index (" + ToString(column) +
+                       ") does not contain a Blob.";
+        errorCode = SQLITE_MISMATCH;
+        return false;
+    }
+    // The bytes can contain zeros, thus their number is retrieved too.
+    auto ptr = reinterpret_cast<const char *>(
+        sqlite3_column_blob(dbDetails.dbStatement, column));
+    auto size = sqlite3_column_bytes(dbDetails.dbStatement, column);
+    if ((ptr == nullptr) || (size < 0))
+    {
+        return false;
+    }
+    // Set the data.
+    data.assign(ptr, static_cast<size_t>(size));
+    return true;
+}
+
 std::string SQLiteWrapper::getNextString()
 {
     std::string data;
@@ -407,6 +534,18 @@ double SQLiteWrapper::getNextDouble()
     throw SQLiteException(errorCode, errorMessage);
 }
 
+std::string SQLiteWrapper::getNextBlob()
+{
+    std::string data;
+    if (this->getDataBlob(currentColumn, data))
+    {
+        // Increase the column index.
+        currentColumn++;
+        return data;
+    }
+    throw SQLiteException(errorCode, errorMessage);
+}
+
 int SQLiteWrapper::loadOrSaveDb(bool save)
 {
     // Prepare the path to the database.
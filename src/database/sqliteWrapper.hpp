@@ -23,7 +23,13 @@
 #pragma once
 
 #include "resultSet.hpp"
+#include "sqliteStatement.hpp"
+#include "sqliteSnapshot.hpp"
+#include "sqliteJournal.hpp"
 #include <sqlite3.h>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
 
 /// @brief Class necessary to execute query on the Database.
 class SQLiteWrapper :
@@ -62,6 +68,20 @@ private:
     /// Current column.
     int currentColumn;
 
+    /// The compiled statements, indexed by their text.
+    std::unordered_map<std::string,
+        std::shared_ptr<SQLiteStatement>> statements;
+
+    /// The journal of the changes made to the in-memory database.
+    std::unique_ptr<SQLiteJournal> journal;
+
+    /// Held while a transaction begins or ends, so that the snapshots are
+    /// not taken in the middle of a transaction.
+    std::mutex transactionMutex;
+
+    /// The snapshots of the in-memory database.
+    std::unique_ptr<SQLiteSnapshot> snapshot;
+
 public:
     /// @brief Constructor.
     SQLiteWrapper();
@@ -103,6 +123,22 @@ public:
     /// @return The number of affected data by the query.
     int executeQuery(const char * query);
 
+    /// @brief Provides a statement which can be executed many times, the
+    ///         statement is compiled only the first time its text is used,
+    ///         then it is kept until the connection is closed.
+    /// @param query The text of the statement, with '?' in place of the
+    ///               parameters.
+    /// @return The statement, nullptr if it cannot be compiled.
+    std::shared_ptr<SQLiteStatement> prepare(const std::string & query);
+
+    /// @brief Provides the snapshots of the database, nullptr if the
+    ///         database has not been loaded in memory.
+    SQLiteSnapshot * getSnapshot() const;
+
+    /// @brief Provides the journal of the changes, nullptr if the database
+    ///         has not been loaded in memory.
+    SQLiteJournal * getJournal() const;
+
     /// @brief Begin a transaction.
     void beginTransaction();
 
@@ -135,6 +171,8 @@ private:
 
     bool getDataDouble(const int & column, double & data) override;
 
+    bool getDataBlob(const int & column, std::string & data) override;
+
     std::string getNextString() override;
 
     int getNextInteger() override;
@@ -143,6 +181,8 @@ private:
 
     double getNextDouble() override;
 
+    std::string getNextBlob() override;
+
     /// @brief Manages the database contents from disk to memory and
     /// vice-versa.
     /// For more deailts, see:
@@ -21,6 +21,7 @@
 
 #include "sqliteWriteFunctions.hpp"
 #include "sqliteDbms.hpp"
+#include "areaChunks.hpp"
 #include "logger.hpp"
 #include "player.hpp"
 #include "area.hpp"
@@ -28,49 +29,50 @@
 
 bool SavePlayer(Player * player)
 {
-    std::vector<std::string> args;
-    // Prepare the arguments of the query.
-    args.push_back(player->name);
-    args.push_back(player->password);
-    args.push_back(ToString(player->race->vnum));
-    args.push_back(ToString(player->getAbility(Ability::Strength, false)));
-    args.push_back(ToString(player->getAbility(Ability::Agility, false)));
-    args.push_back(ToString(player->getAbility(Ability::Perception, false)));
-    args.push_back(ToString(player->getAbility(Ability::Constitution, false)));
-    args.push_back(ToString(player->getAbility(Ability::Intelligence, false)));
-    args.push_back(ToString(static_cast<int>(player->gender)));
-    args.push_back(ToString(player->age));
-    args.push_back(player->description);
-    args.push_back(ToString(player->weight));
-    args.push_back(ToString(player->faction->vnum));
-    args.push_back(ToString(player->level));
-    args.push_back(ToString(player->experience));
-    args.push_back(ToString(player->room->vnum));
-    args.push_back(player->prompt);
-    args.push_back(ToString(player->flags));
-    args.push_back(ToString(player->health));
-    args.push_back(ToString(player->stamina));
-    args.push_back(ToString(player->hunger));
-    args.push_back(ToString(player->thirst));
-    args.push_back(ToString(player->rent_room));
-    // Start a transaction.
-    if (!SQLiteDbms::instance().insertInto("Player", args, false, true))
-    {
-        return false;
-    }
-    return true;
+    auto statement = SQLiteDbms::instance().prepareInsertInto("Player", 23,
+                                                              false, true);
+    return (statement != nullptr) &&
+           statement->bindAll(
+               player->name,
+               player->password,
+               player->race->vnum,
+               player->getAbility(Ability::Strength, false),
+               player->getAbility(Ability::Agility, false),
+               player->getAbility(Ability::Perception, false),
+               player->getAbility(Ability::Constitution, false),
+               player->getAbility(Ability::Intelligence, false),
+               static_cast<int>(player->gender),
+               player->age,
+               player->description,
+               player->weight,
+               player->faction->vnum,
+               player->level,
+               player->experience,
+               player->room->vnum,
+               player->prompt,
+               player->flags,
+               player->health,
+               player->stamina,
+               player->hunger,
+               player->thirst,
+               player->rent_room) &&
+           statement->execute();
 }
 
 bool SavePlayerSkills(Player * player)
 {
+    auto statement = SQLiteDbms::instance().prepareInsertInto("PlayerSkill",
+                                                              3, false, true);
+    if (statement == nullptr)
+    {
+        return false;
+    }
     for (const auto & skillData : player->skillManager.skills)
     {
-        std::vector<std::string> args;
-        args.push_back(player->name);
-        args.push_back(ToString(skillData->skillVnum));
-        args.push_back(ToString(skillData->skillLevel));
-        if (!SQLiteDbms::instance().insertInto("PlayerSkill", args, false,
-                                               true))
+        if (!statement->bindAll(player->name,
+                                skillData->skillVnum,
+                                skillData->skillLevel) ||
+            !statement->execute())
         {
             return false;
         }
@@ -80,15 +82,18 @@ bool SavePlayerSkills(Player * player)
 
 bool SavePlayerLuaVariables(Player * player)
 {
-    // Prepare the arguments of the query for lua variables table.
+    auto statement = SQLiteDbms::instance().prepareInsertInto(
+        "PlayerVariable", 3, false, true);
+    if (statement == nullptr)
+    {
+        return false;
+    }
     for (auto iterator : player->luaVariables)
     {
-        std::vector<std::string> args;
-        args.push_back(player->name);
-        args.push_back(iterator.first);
-        args.push_back(iterator.second);
-        if (!SQLiteDbms::instance().insertInto("PlayerVariable", args,
-                                               false, true))
+        if (!statement->bindAll(player->name,
+                                iterator.first,
+                                iterator.second) ||
+            !statement->execute())
         {
             return false;
         }
@@ -100,100 +105,106 @@ bool SaveItemPlayer(Player * player,
                     Item * item,
                     const unsigned int & bodyPartVnum)
 {
-    std::vector<std::string> args;
-    args.emplace_back(player->name);
-    args.emplace_back(ToString(item->vnum));
-    args.emplace_back(ToString(bodyPartVnum));
-    // Start a transaction.
-    SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("ItemPlayer", args, false, true))
-    {
-        SQLiteDbms::instance().rollbackTransection();
-        return false;
-    }
-    SQLiteDbms::instance().endTransaction();
-    return true;
+    auto statement = SQLiteDbms::instance().prepareInsertInto("ItemPlayer",
+                                                              3, false, true);
+    return (statement != nullptr) &&
+           statement->bindAll(player->name, item->vnum, bodyPartVnum) &&
+           statement->execute();
 }
 
 bool SaveShopItem(ShopItem * item,
                   const bool & transaction)
 {
-    // Prepare the vector used to insert into the database.
-    std::vector<std::string> args;
-    args.push_back(ToString(item->vnum));
-    args.push_back(item->shopName);
-    args.push_back(ToString(item->shopBuyTax));
-    args.push_back(ToString(item->shopSellTax));
-    args.push_back(ToString(item->balance));
-    if (item->shopKeeper != nullptr)
+    auto statement = SQLiteDbms::instance().prepareInsertInto("Shop", 8,
+                                                              false, true);
+    if (statement == nullptr)
     {
-        args.push_back(item->shopKeeper->id);
+        return false;
     }
-    else
+    if (transaction)
     {
-        args.push_back("");
+        SQLiteDbms::instance().beginTransaction();
     }
-    args.push_back(ToString(item->openingHour));
-    args.push_back(ToString(item->closingHour));
-    if (!transaction)
+    if (!statement->bindAll(item->vnum,
+                            item->shopName,
+                            item->shopBuyTax,
+                            item->shopSellTax,
+                            item->balance,
+                            (item->shopKeeper != nullptr) ?
+                            item->shopKeeper->id : std::string(),
+                            item->openingHour,
+                            item->closingHour) ||
+        !statement->execute())
     {
-        return SQLiteDbms::instance().insertInto("Shop", args, false, true);
+        if (transaction)
+        {
+            SQLiteDbms::instance().rollbackTransection();
+        }
+        return false;
     }
-    SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("Shop", args, false, true))
+    if (transaction)
     {
-        SQLiteDbms::instance().rollbackTransection();
-        return false;
+        SQLiteDbms::instance().endTransaction();
     }
-    SQLiteDbms::instance().endTransaction();
     return true;
 }
 
 bool SaveItem(Item * item,
               const bool & transaction)
 {
-    // Prepare the vector used to insert into the database.
-    std::vector<std::string> args;
-    args.push_back(ToString(item->vnum));
-    args.push_back(ToString(item->model->vnum));
-    args.push_back(ToString(item->quantity));
-    args.push_back(item->maker);
-    args.push_back(ToString(item->price));
-    args.push_back(ToString(item->weight));
-    args.push_back(ToString(item->condition));
-    args.push_back(ToString(item->maxCondition));
-    args.push_back(ToString(item->composition->vnum));
-    args.push_back(ToString(item->quality.toUInt()));
-    args.push_back(ToString(item->flags));
-    if (!transaction)
+    auto statement = SQLiteDbms::instance().prepareInsertInto("Item", 11,
+                                                              false, true);
+    if (statement == nullptr)
     {
-        return SQLiteDbms::instance().insertInto("Item", args, false, true);
+        return false;
     }
-    SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("Item", args, false, true))
+    if (transaction)
     {
-        SQLiteDbms::instance().rollbackTransection();
+        SQLiteDbms::instance().beginTransaction();
+    }
+    if (!statement->bindAll(item->vnum,
+                            item->model->vnum,
+                            item->quantity,
+                            item->maker,
+                            item->price,
+                            item->weight,
+                            item->condition,
+                            item->maxCondition,
+                            item->composition->vnum,
+                            item->quality.toUInt(),
+                            item->flags) ||
+        !statement->execute())
+    {
+        if (transaction)
+        {
+            SQLiteDbms::instance().rollbackTransection();
+        }
         return false;
     }
-    SQLiteDbms::instance().endTransaction();
+    if (transaction)
+    {
+        SQLiteDbms::instance().endTransaction();
+    }
     return true;
 }
 
 bool SaveArea(Area * area)
 {
-    std::vector<std::string> args;
-    args.push_back(ToString(area->vnum));
-    args.push_back(area->name);
-    args.push_back(area->builder);
-    args.push_back(ToString(area->width));
-    args.push_back(ToString(area->height));
-    args.push_back(ToString(area->elevation));
-    args.push_back("0");
-    args.push_back(ToString(static_cast<unsigned int>(area->type)));
-    args.push_back(ToString(static_cast<unsigned int>(area->status)));
+    auto statement = SQLiteDbms::instance().prepareInsertInto("Area", 9,
+                                                              false, true);
     // Start a transaction.
     SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("Area", args, false, true))
+    if ((statement == nullptr) ||
+        !statement->bindAll(area->vnum,
+                            area->name,
+                            area->builder,
+                            area->width,
+                            area->height,
+                            area->elevation,
+                            0,
+                            static_cast<unsigned int>(area->type),
+                            static_cast<unsigned int>(area->status)) ||
+        !statement->execute())
     {
         Logger::log(LogLevel::Error, "I was not able to save the area.");
         SQLiteDbms::instance().rollbackTransection();
@@ -205,19 +216,9 @@ bool SaveArea(Area * area)
 
 bool SaveRoom(Room * room)
 {
-    // Insert into table Room the newly created room.
-    std::vector<std::string> args;
-    args.push_back(ToString(room->vnum));
-    args.push_back(ToString(room->coord.x));
-    args.push_back(ToString(room->coord.y));
-    args.push_back(ToString(room->coord.z));
-    args.push_back(ToString(room->terrain->vnum));
-    args.push_back(room->name);
-    args.push_back(room->description);
-    args.push_back(ToString(room->flags));
     // Start a transaction.
     SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("Room", args, false, true))
+    if (!room->updateOnDB())
     {
         Logger::log(LogLevel::Error, "I was not able to save the room.");
         SQLiteDbms::instance().rollbackTransection();
@@ -229,13 +230,13 @@ bool SaveRoom(Room * room)
 
 bool SaveAreaList(Area * area, Room * room)
 {
-    // Insert Room in AreaList.
-    std::vector<std::string> args;
-    args.push_back(ToString(area->vnum));
-    args.push_back(ToString(room->vnum));
+    auto statement = SQLiteDbms::instance().prepareInsertInto("AreaList", 2,
+                                                              false, true);
     // Start a transaction.
     SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("AreaList", args, false, true))
+    if ((statement == nullptr) ||
+        !statement->bindAll(area->vnum, room->vnum) ||
+        !statement->execute())
     {
         Logger::log(LogLevel::Error, "I was not able to save the area list.");
         SQLiteDbms::instance().rollbackTransection();
@@ -245,17 +246,43 @@ bool SaveAreaList(Area * area, Room * room)
     return true;
 }
 
+bool SaveAreaTiles(Area * area)
+{
+    auto const & chunks = area->chunks;
+    if (chunks == nullptr)
+    {
+        return false;
+    }
+    // The tiles are too many to be written inside the text of a query.
+    auto statement = SQLiteDbms::instance().prepare(
+        "INSERT OR REPLACE INTO AreaTiles VALUES(?, ?, ?, ?, ?, ?);");
+    if ((statement == nullptr) ||
+        !statement->bind(1, area->vnum) ||
+        !statement->bind(2, chunks->getFirstVnum()) ||
+        !statement->bind(3, chunks->getWidth()) ||
+        !statement->bind(4, chunks->getHeight()) ||
+        !statement->bind(5, chunks->getRadius()) ||
+        !statement->bindBlob(6, chunks->getTileData()) ||
+        !statement->execute())
+    {
+        Logger::log(LogLevel::Error, "I was not able to save the tiles.");
+        return false;
+    }
+    return true;
+}
+
 bool SaveRoomExit(const std::shared_ptr<Exit> & roomExit)
 {
-    // Update the values on Database.
-    std::vector<std::string> args;
-    args.push_back(ToString(roomExit->source->vnum));
-    args.push_back(ToString(roomExit->destination->vnum));
-    args.push_back(ToString(roomExit->direction.toUInt()));
-    args.push_back(ToString(roomExit->flags));
+    auto statement = SQLiteDbms::instance().prepareInsertInto("Exit", 4,
+                                                              false, true);
     // Start a transaction.
     SQLiteDbms::instance().beginTransaction();
-    if (!SQLiteDbms::instance().insertInto("Exit", args, false, true))
+    if ((statement == nullptr) ||
+        !statement->bindAll(roomExit->source->vnum,
+                            roomExit->destination->vnum,
+                            roomExit->direction.toUInt(),
+                            roomExit->flags) ||
+        !statement->execute())
     {
         Logger::log(LogLevel::Error, "I was not able to save the exit.");
         SQLiteDbms::instance().rollbackTransection();
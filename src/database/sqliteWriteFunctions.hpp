@@ -69,5 +69,9 @@ bool SaveRoom(Room * room);
 /// @brief Allows to save the given pair of room and area inside the database.
 bool SaveAreaList(Area * area, Room * room);
 
+/// @brief Allows to save the tiles of the given streamed area inside the
+/// database.
+bool SaveAreaTiles(Area * area);
+
 /// @brief Allows to save the given exit inside the database.
 bool SaveRoomExit(const std::shared_ptr<Exit> & roomExit);
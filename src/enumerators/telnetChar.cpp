@@ -58,7 +58,8 @@ std::string TelnetChar::toString() const
     if (value == DONT) return "DONT";
     if (value == IAC) return "IAC";
     if (value == DRAW_MAP) return "DRAW_MAP";
-    if (value == DRAW_MAP) return "DRAW_MAP";
+    if (value == CLR_MAP) return "CLR_MAP";
+    if (value == UPD_MAP) return "UPD_MAP";
     if (value == FORMAT) return "FORMAT";
     return "NONE";
 }
@@ -58,6 +58,7 @@ public:
         MCCP = 86,                      ///< Mud Client Compression Protocol
         DRAW_MAP = 91,                  ///< MUD SPECIFIC: I will send the map.
         CLR_MAP = 92,                   ///< MUD SPECIFIC: Please, clear the already drawn map.
+        UPD_MAP = 93,                   ///< MUD SPECIFIC: I will send the changed tiles of the map.
         FORMAT = 100,                   ///< MUD SPECIFIC: I will send a format string.
         SubNegotiationEnd = 240,
         NoOperation = 241,
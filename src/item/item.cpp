@@ -24,6 +24,8 @@
 
 #include "mud.hpp"
 #include "logger.hpp"
+#include "memoryTracker.hpp"
+#include "sqliteWriteFunctions.hpp"
 
 Item::Item() :
     vnum(),
@@ -42,6 +44,7 @@ Item::Item() :
     container(),
     occupiedBodyParts(),
     content(),
+    dirty(),
     itemMutex()
 {
 }
@@ -54,6 +57,19 @@ Item::~Item()
                 this->getNameCapital());
 }
 
+void * Item::operator new(size_t size)
+{
+    auto ptr = ::operator new(size);
+    MemoryTracker::instance().allocate(MemoryCategory::Item, size);
+    return ptr;
+}
+
+void Item::operator delete(void * ptr, size_t size)
+{
+    MemoryTracker::instance().deallocate(MemoryCategory::Item, size);
+    ::operator delete(ptr);
+}
+
 bool Item::check()
 {
     bool safe = true;
@@ -123,20 +139,12 @@ void Item::removeFromMud()
 
 bool Item::updateOnDB()
 {
-    // Prepare the vector used to insert into the database.
-    std::vector<std::string> arguments;
-    arguments.push_back(ToString(this->vnum));
-    arguments.push_back(ToString(model->vnum));
-    arguments.push_back(ToString(this->quantity));
-    arguments.push_back(this->maker);
-    arguments.push_back(ToString(this->price));
-    arguments.push_back(ToString(this->weight));
-    arguments.push_back(ToString(this->condition));
-    arguments.push_back(ToString(this->maxCondition));
-    arguments.push_back(ToString(this->composition->vnum));
-    arguments.push_back(ToString(this->quality.toUInt()));
-    arguments.push_back(ToString(this->flags));
-    return SQLiteDbms::instance().insertInto("Item", arguments, false, true);
+    if (!SaveItem(this, false))
+    {
+        return false;
+    }
+    dirty = false;
+    return true;
 }
 
 bool Item::removeOnDB()
@@ -162,6 +170,30 @@ bool Item::removeOnDB()
     return false;
 }
 
+void Item::setQuantity(unsigned int _quantity)
+{
+    quantity = _quantity;
+    dirty = true;
+}
+
+void Item::setCondition(double _condition)
+{
+    condition = _condition;
+    dirty = true;
+}
+
+void Item::setFlag(ItemFlag flag)
+{
+    SetFlag(flags, flag);
+    dirty = true;
+}
+
+void Item::clearFlag(ItemFlag flag)
+{
+    ClearFlag(flags, flag);
+    dirty = true;
+}
+
 void Item::getSheet(Table & sheet) const
 {
     // Add the columns.
@@ -272,7 +304,7 @@ Item * Item::removeFromStack(Character * actor, unsigned int & _quantity)
         if (newStack != nullptr)
         {
             // Actually reduce the quantity.
-            this->quantity -= _quantity;
+            this->setQuantity(this->quantity - _quantity);
             // Update this item, since its quantity has changed.
             this->updateOnDB();
             // Return the new stack.
@@ -285,7 +317,7 @@ Item * Item::removeFromStack(Character * actor, unsigned int & _quantity)
 
 bool Item::hasKey(std::string key)
 {
-    for (auto iterator : model->keys)
+    for (auto const & iterator : model->keys)
     {
         // Get the name of the item.
         std::string name = iterator;
@@ -309,7 +341,14 @@ void Item::triggerDecay()
 {
     if (!HasFlag(model->modelFlags, ModelFlag::Unbreakable))
     {
+        // The worn condition is saved once a whole point has been lost, so
+        // that the hourly decay does not make every item dirty.
+        auto previous = std::floor(condition);
         condition -= this->getDecayRate();
+        if (std::floor(condition) < previous)
+        {
+            dirty = true;
+        }
         if (condition < 0)
         {
             // Take everything out from the item.
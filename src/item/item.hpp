@@ -88,6 +88,8 @@ public:
     std::vector<std::shared_ptr<BodyPart>> occupiedBodyParts;
     /// List of items contained in this one.
     ItemVector content;
+    /// If the item has been modified since it has been saved on database.
+    bool dirty;
     /// Mutex used to protect the actions on the item.
     std::mutex itemMutex;
 
@@ -109,6 +111,13 @@ public:
     /// @brief Destructor.
     virtual ~Item();
 
+
+    /// @brief Allocates the memory for an item, keeping track of its usage.
+    static void * operator new(size_t size);
+
+    /// @brief Releases the memory of an item, keeping track of its usage.
+    static void operator delete(void * ptr, size_t size);
+
     /// @brief Check the correctness of the item.
     /// @return <b>True</b> if the item has correct values,<br>
     ///         <b>False</b> otherwise.
@@ -127,6 +136,24 @@ public:
     ///         <b>False</b> otherwise.
     virtual bool removeOnDB();
 
+    /// @brief Sets the number of stacked items, the item is saved with the
+    ///         next changes.
+    /// @param _quantity The new quantity.
+    void setQuantity(unsigned int _quantity);
+
+    /// @brief Sets the condition of the item, the item is saved with the
+    ///         next changes.
+    /// @param _condition The new condition.
+    void setCondition(double _condition);
+
+    /// @brief Sets the given flag, the item is saved with the next changes.
+    /// @param flag The flag to set.
+    void setFlag(ItemFlag flag);
+
+    /// @brief Clears the given flag, the item is saved with the next changes.
+    /// @param flag The flag to clear.
+    void clearFlag(ItemFlag flag);
+
     /// @brief Fills the provided table with the information
     ///         concerning the item.
     /// @param sheet The table that has to be filled.
@@ -35,7 +35,7 @@ void ItemVector::push_back_item(Item *& item)
         auto content = (*it);
         if (item->canStackWith(content))
         {
-            content->quantity += item->quantity;
+            content->setQuantity(content->quantity + item->quantity);
             MudUpdater::instance().addItemToDestroy(item);
             item = content;
             content->updateOnDB();
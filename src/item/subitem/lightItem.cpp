@@ -27,16 +27,24 @@
 #include "updater.hpp"
 #include "logger.hpp"
 #include "formatter.hpp"
+#include "character.hpp"
+#include "area.hpp"
+#include "room.hpp"
 
 LightItem::LightItem() :
-    active()
+    active(),
+    lightArea()
 {
     // Nothing to do.
 }
 
 LightItem::~LightItem()
 {
-    // Nothing to do.
+    // Remove the light source from the light map.
+    if (lightArea != nullptr)
+    {
+        lightArea->lightMap.removeSource(this);
+    }
 }
 
 std::string LightItem::getName(bool colored) const
@@ -121,6 +129,55 @@ bool LightItem::isActive() const
                              LightModelFlags::AlwaysActive);
 }
 
+void LightItem::setActive(bool _active)
+{
+    active = _active;
+    this->updateLightMap();
+}
+
+Room * LightItem::getLightRoom() const
+{
+    if (room != nullptr)
+    {
+        return room;
+    }
+    if ((owner != nullptr) && (owner->room != nullptr))
+    {
+        for (auto it : owner->equipment)
+        {
+            if (it == this)
+            {
+                return owner->room;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void LightItem::updateLightMap()
+{
+    Area * currentArea = nullptr;
+    if (this->isActive())
+    {
+        auto lightRoom = this->getLightRoom();
+        if (lightRoom != nullptr)
+        {
+            currentArea = lightRoom->area;
+        }
+    }
+    // Remove the light source from the previous area.
+    if ((lightArea != nullptr) && (lightArea != currentArea))
+    {
+        lightArea->lightMap.removeSource(this);
+    }
+    // Add (or update) the light source inside the current area.
+    if (currentArea != nullptr)
+    {
+        currentArea->lightMap.addSource(this);
+    }
+    lightArea = currentArea;
+}
+
 bool LightItem::canRefillWith(Item * item, std::string & error) const
 {
     if (item == nullptr)
@@ -235,7 +292,7 @@ void LightItem::updateTicImpl()
             //  the condition is below zero.
             if (this->condition < 0)
             {
-                active = false;
+                this->setActive(false);
             }
         }
         else
@@ -243,7 +300,7 @@ void LightItem::updateTicImpl()
             auto loadedFuel = this->getAlreadyLoadedFuel();
             if (loadedFuel.empty())
             {
-                active = false;
+                this->setActive(false);
             }
             else
             {
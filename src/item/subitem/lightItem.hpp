@@ -24,6 +24,8 @@
 
 #include "item.hpp"
 
+class Area;
+
 /// @brief Holds details about lights.
 class LightItem :
     public Item
@@ -31,6 +33,8 @@ class LightItem :
 public:
     /// Activity status.
     bool active;
+    /// The area whose light map contains this light source.
+    Area * lightArea;
 
     LightItem();
 
@@ -49,6 +53,18 @@ public:
     /// @brief Checks if the light source is active.
     bool isActive() const;
 
+    /// @brief Turns on or off the light source.
+    void setActive(bool _active);
+
+    /// @brief Provides the room from which the light source is shining, i.e.
+    ///         the room where it lies or the room of the character which
+    ///         has it equipped.
+    Room * getLightRoom() const;
+
+    /// @brief Updates the contribution of the light source to the light map
+    ///         of the area where it is currently shining.
+    void updateLightMap();
+
     /// @brief Determines if this can be refilled with the given item.
     /// @param item  The item, probably the fuel.
     /// @param error The error message in case it cannot be used as fuel.
@@ -24,6 +24,7 @@
 #include "shopModel.hpp"
 #include "logger.hpp"
 #include "mud.hpp"
+#include "sqliteWriteFunctions.hpp"
 
 ShopItem::ShopItem() :
     shopName(),
@@ -48,17 +49,9 @@ bool ShopItem::updateOnDB()
     {
         return false;
     }
-    // Prepare the vector used to insert into the database.
-    std::vector<std::string> arguments;
-    arguments.emplace_back(ToString(vnum));
-    arguments.emplace_back(shopName);
-    arguments.emplace_back(ToString(shopBuyTax));
-    arguments.emplace_back(ToString(shopSellTax));
-    arguments.emplace_back(ToString(balance));
-    arguments.emplace_back((shopKeeper != nullptr) ? shopKeeper->id : "");
-    arguments.emplace_back(ToString(openingHour));
-    arguments.emplace_back(ToString(closingHour));
-    return SQLiteDbms::instance().insertInto("Shop", arguments, false, true);
+    // Keep the shop dirty until its own row has been saved too.
+    dirty = !SaveShopItem(this, false);
+    return !dirty;
 }
 
 bool ShopItem::removeOnDB()
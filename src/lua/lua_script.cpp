@@ -30,9 +30,49 @@
 #include "toolModel.hpp"
 #include "shopItem.hpp"
 #include "logger.hpp"
-#include "aStar.hpp"
+#include "memoryTracker.hpp"
+#include "hierarchicalPathFinder.hpp"
+#include "pathRequestService.hpp"
 #include "mud.hpp"
 
+namespace luabridge
+{
+/// @brief Stack specialization for InternedString, which is exposed to lua
+///         as a normal string.
+template<>
+struct Stack<InternedString>
+{
+    static inline void push(lua_State * L, InternedString const & str)
+    {
+        lua_pushlstring(L, str.c_str(), str.size());
+    }
+
+    static inline InternedString get(lua_State * L, int index)
+    {
+        size_t len;
+        const char * str = luaL_checklstring(L, index, &len);
+        return InternedString(std::string(str, len));
+    }
+};
+
+/// @brief Stack specialization for `InternedString const &`.
+template<>
+struct Stack<InternedString const &>
+{
+    static inline void push(lua_State * L, InternedString const & str)
+    {
+        lua_pushlstring(L, str.c_str(), str.size());
+    }
+
+    static inline InternedString get(lua_State * L, int index)
+    {
+        size_t len;
+        const char * str = luaL_checklstring(L, index, &len);
+        return InternedString(std::string(str, len));
+    }
+};
+}
+
 void LuaLog(std::string message)
 {
     if (!message.empty())
@@ -89,33 +129,59 @@ std::vector<Direction> LuaFindPath(
     {
         return path;
     }
-    auto RoomCheckFunction = [&](Room * from, Room * to)
-    {
-        // Preapre the options.
-        MovementOptions options;
-        options.character = character;
-        // Prepare the error string.
-        std::string error;
-        return StructUtils::checkConnection(options, from, to, error);
-    };
     // Find the path from the actor to the target.
-    AStar<Room *> aStar(RoomCheckFunction,
-                        StructUtils::getRoomDistance,
-                        StructUtils::roomsAreEqual,
-                        StructUtils::getNeighbours);
     std::vector<Room *> visitedRooms;
-    if (aStar.findPath(character->room, destination, visitedRooms))
+    if (HierarchicalPathFinder::instance().findPath(character,
+                                                    character->room,
+                                                    destination,
+                                                    visitedRooms))
     {
-        Coordinates previous = character->room->coord;
+        Room * previous = character->room;
         for (auto node : visitedRooms)
         {
-            path.emplace_back(StructUtils::getDirection(previous, node->coord));
-            previous = node->coord;
+            // Travel points cannot be expressed by a direction, the path
+            // stops there and the script has to use the travel command.
+            if (HierarchicalPathFinder::isTravel(previous, node))
+            {
+                break;
+            }
+            path.emplace_back(StructUtils::getDirection(previous->coord,
+                                                        node->coord));
+            previous = node;
         }
     }
     return path;
 }
 
+unsigned int LuaRequestPath(Character * character, Room * destination)
+{
+    return PathRequestService::instance().request(
+        character, std::vector<Room *>(1, destination));
+}
+
+unsigned int LuaRequestPaths(Character * character,
+                             const std::vector<Room *> & destinations)
+{
+    return PathRequestService::instance().request(character, destinations);
+}
+
+bool LuaIsPathReady(unsigned int handle)
+{
+    return PathRequestService::instance().isReady(handle);
+}
+
+std::vector<Direction> LuaGetPath(unsigned int handle, Room * destination)
+{
+    std::vector<Direction> path;
+    PathRequestService::instance().getPath(handle, destination, path);
+    return path;
+}
+
+void LuaReleasePath(unsigned int handle)
+{
+    PathRequestService::instance().release(handle);
+}
+
 std::vector<Room *> LuaGetRoomsInSight(Character * character)
 {
     std::vector<Room *> result;
@@ -169,6 +235,101 @@ std::vector<Item *> LuaGetItemsInSight(Character * character)
     return result;
 }
 
+/// @brief Keeps track of the memory used by a single lua state.
+struct LuaMemoryUsage
+{
+    /// The number of bytes currently used.
+    size_t current;
+    /// The highest number of bytes used.
+    size_t peak;
+};
+
+/// @brief The allocation function used by all the lua states.
+static void * LuaAllocator(void * ud, void * ptr, size_t osize, size_t nsize)
+{
+    auto usage = static_cast<LuaMemoryUsage *>(ud);
+    // When ptr is NULL, osize encodes the kind of object being allocated.
+    auto oldSize = (ptr == nullptr) ? 0 : osize;
+    if (nsize == 0)
+    {
+        free(ptr);
+        usage->current -= oldSize;
+        MemoryTracker::instance().resize(MemoryCategory::Lua, oldSize, 0);
+        return nullptr;
+    }
+    auto block = realloc(ptr, nsize);
+    if (block != nullptr)
+    {
+        usage->current = usage->current - oldSize + nsize;
+        usage->peak = std::max(usage->peak, usage->current);
+        MemoryTracker::instance().resize(MemoryCategory::Lua, oldSize, nsize);
+    }
+    return block;
+}
+
+/// @brief The function called in case of unprotected errors.
+static int LuaPanic(lua_State * L)
+{
+    Logger::log(LogLevel::Fatal,
+                "Unprotected error in lua: %s",
+                std::string(lua_tostring(L, -1)));
+    return 0;
+}
+
+/// @brief Provides the memory usage structure of the given state.
+static LuaMemoryUsage * LuaGetUsage(lua_State * L)
+{
+    void * ud = nullptr;
+    if ((L == nullptr) || (lua_getallocf(L, &ud) != LuaAllocator))
+    {
+        return nullptr;
+    }
+    return static_cast<LuaMemoryUsage *>(ud);
+}
+
+lua_State * LuaNewState()
+{
+    auto usage = new LuaMemoryUsage();
+    auto L = lua_newstate(LuaAllocator, usage);
+    if (L == nullptr)
+    {
+        Logger::log(LogLevel::Fatal, "Cannot create a new lua state.");
+        delete (usage);
+        return nullptr;
+    }
+    lua_atpanic(L, LuaPanic);
+    // Keep track of the number of lua states.
+    MemoryTracker::instance().allocate(MemoryCategory::Lua, 0);
+    return L;
+}
+
+void LuaCloseState(lua_State * L)
+{
+    if (L == nullptr)
+    {
+        return;
+    }
+    auto usage = LuaGetUsage(L);
+    lua_close(L);
+    if (usage != nullptr)
+    {
+        MemoryTracker::instance().deallocate(MemoryCategory::Lua, 0);
+        delete (usage);
+    }
+}
+
+size_t LuaGetMemoryUsage(lua_State * L)
+{
+    auto usage = LuaGetUsage(L);
+    return (usage != nullptr) ? usage->current : 0;
+}
+
+size_t LuaGetPeakMemoryUsage(lua_State * L)
+{
+    auto usage = LuaGetUsage(L);
+    return (usage != nullptr) ? usage->peak : 0;
+}
+
 void LoadLuaEnvironmet(lua_State * L, const std::string & scriptFile)
 {
     // -------------------------------------------------------------------------
@@ -183,6 +344,11 @@ void LoadLuaEnvironmet(lua_State * L, const std::string & scriptFile)
         .addFunction("stop", LuaStopScript)
         .addFunction("loadItem", LuaLoadItem)
         .addFunction("findPath", LuaFindPath)
+        .addFunction("requestPath", LuaRequestPath)
+        .addFunction("requestPaths", LuaRequestPaths)
+        .addFunction("isPathReady", LuaIsPathReady)
+        .addFunction("getPath", LuaGetPath)
+        .addFunction("releasePath", LuaReleasePath)
         .addFunction("getRoomsInSight", LuaGetRoomsInSight)
         .addFunction("getCharactersInSight", LuaGetCharactersInSight)
         .addFunction("getItemsInSight", LuaGetItemsInSight)
@@ -73,6 +73,34 @@ std::vector<Direction> LuaFindPath(
     Character * character,
     Room * destination);
 
+/// @brief Requests the path from the character to the destination, the
+///         search is performed in background.
+/// @param character    The character which has to move.
+/// @param destination  The destination to reach.
+/// @return The handle of the request, 0 if the request is not valid.
+unsigned int LuaRequestPath(Character * character, Room * destination);
+
+/// @brief Requests the paths from the character to all the destinations,
+///         by means of a single search performed in background.
+/// @param character    The character which has to move.
+/// @param destinations The destinations to reach.
+/// @return The handle of the request, 0 if the request is not valid.
+unsigned int LuaRequestPaths(Character * character,
+                             const std::vector<Room *> & destinations);
+
+/// @brief Checks if the request has been resolved.
+bool LuaIsPathReady(unsigned int handle);
+
+/// @brief Provides the path towards one of the destinations of a resolved
+///         request.
+/// @param handle       The handle of the request.
+/// @param destination  The destination.
+/// @return The path (as list of directions) to the destination.
+std::vector<Direction> LuaGetPath(unsigned int handle, Room * destination);
+
+/// @brief Discards the result of a request.
+void LuaReleasePath(unsigned int handle);
+
 /// @brief Returns the list of rooms in sight.
 std::vector<Room *> LuaGetRoomsInSight(Character * character);
 
@@ -82,6 +110,20 @@ std::vector<Character *> LuaGetCharactersInSight(Character * character);
 /// @brief Returns the list of items in sight.
 std::vector<Item *> LuaGetItemsInSight(Character * character);
 
+/// @brief Creates a new lua state whose memory usage is tracked.
+/// @return The newly created lua state.
+lua_State * LuaNewState();
+
+/// @brief Closes a lua state created by means of LuaNewState.
+/// @param L The lua state to close.
+void LuaCloseState(lua_State * L);
+
+/// @brief Provides the number of bytes currently used by the lua state.
+size_t LuaGetMemoryUsage(lua_State * L);
+
+/// @brief Provides the highest number of bytes used by the lua state.
+size_t LuaGetPeakMemoryUsage(lua_State * L);
+
 /// @brief Register every mud element inside the Lua environment.
 void LoadLuaEnvironmet(lua_State * L, const std::string & scriptFile);
 
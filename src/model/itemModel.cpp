@@ -90,7 +90,7 @@ void ItemModel::getSheet(Table & sheet) const
     sheet.addRow({"Article", this->article});
     sheet.addRow({"Short Description", this->shortdesc});
     std::string keyGroup;
-    for (auto it : this->keys)
+    for (auto const & it : this->keys)
     {
         keyGroup += " " + it;
     }
@@ -28,6 +28,7 @@
 #include "material.hpp"
 #include "table.hpp"
 #include "utils.hpp"
+#include "stringPool.hpp"
 
 #include <string>
 #include <vector>
@@ -115,7 +116,7 @@ public:
     /// The model short description.
     std::string shortdesc;
     /// The model keys.
-    std::vector<std::string> keys;
+    std::vector<InternedString> keys;
     /// The model description.
     std::string description;
     /// Store here the position where the model can be equipped.
@@ -29,6 +29,13 @@
 #include "CMacroWrapper.hpp"
 #include "stopwatch.hpp"
 #include "logger.hpp"
+#include "memoryTracker.hpp"
+#include "stringPool.hpp"
+#include "lightItem.hpp"
+#include "hierarchicalPathFinder.hpp"
+#include "flowField.hpp"
+#include "pathRequestService.hpp"
+#include "areaChunks.hpp"
 
 /// Input file descriptor.
 static fd_set in_set;
@@ -80,7 +87,12 @@ Mud::Mud() :
     mudTerrains(),
     mudBodyParts()
 {
-    // Nothing to do.
+    // The rooms and the characters notify the pathfinders when they are
+    // destroyed, thus they must be created before the mud (and destroyed
+    // after it).
+    HierarchicalPathFinder::instance();
+    FlowFieldService::instance();
+    PathRequestService::instance();
 }
 
 Mud::~Mud()
@@ -166,14 +178,9 @@ bool Mud::savePlayers()
     return SQLiteDbms::instance().updatePlayers();
 }
 
-bool Mud::saveItems()
+bool Mud::saveChanges()
 {
-    return SQLiteDbms::instance().updateItems();
-}
-
-bool Mud::saveRooms()
-{
-    return SQLiteDbms::instance().updateRooms();
+    return SQLiteDbms::instance().flushChanges();
 }
 
 bool Mud::saveMud()
@@ -183,14 +190,33 @@ bool Mud::saveMud()
                 "Saving information on Database for : Players...");
     result &= Mud::instance().savePlayers();
     Logger::log(LogLevel::Global,
-                "Saving information on Database for : Items...");
-    result &= Mud::instance().saveItems();
-    Logger::log(LogLevel::Global,
-                "Saving information on Database for : Rooms...");
-    result &= Mud::instance().saveRooms();
+                "Saving information on Database for : Items and Rooms...");
+    result &= Mud::instance().saveChanges();
     return result;
 }
 
+void Mud::sampleMemoryUsage()
+{
+    auto & tracker = MemoryTracker::instance();
+    // Sample the memory used by SQLite.
+    tracker.sample(MemoryCategory::Database,
+                   static_cast<size_t>(sqlite3_memory_used()),
+                   1);
+    // Sample the memory used by the generated maps.
+    size_t mapsUsage = 0;
+    for (auto const & it : mudGeneratedMaps)
+    {
+        mapsUsage += it.second->getMemoryUsage();
+    }
+    tracker.sample(MemoryCategory::MapWrapper,
+                   mapsUsage,
+                   mudGeneratedMaps.size());
+    // Sample the memory used by the pool of interned strings.
+    tracker.sample(MemoryCategory::Strings,
+                   StringPool::instance().getMemoryUsage(),
+                   StringPool::instance().size());
+}
+
 void Mud::addPlayer(Player * player)
 {
     mudPlayers.insert(mudPlayers.end(), player);
@@ -270,15 +296,13 @@ bool Mud::addRoom(Room * room)
 
 bool Mud::remRoom(Room * room)
 {
-    for (auto it = mudRooms.begin(); it != mudRooms.end(); ++it)
+    auto it = mudRooms.find(room->vnum);
+    if ((it == mudRooms.end()) || (it->second != room))
     {
-        if (it->second->vnum == room->vnum)
-        {
-            mudRooms.erase(it);
-            return true;
-        }
+        return false;
     }
-    return false;
+    mudRooms.erase(it);
+    return true;
 }
 
 bool Mud::addCorpse(Item * corpse)
@@ -363,7 +387,13 @@ bool Mud::addLiquid(Liquid * liquid)
 
 bool Mud::addTravelPoint(Room * source, Room * target)
 {
-    return mudTravelPoints.insert(std::make_pair(source, target)).second;
+    if (mudTravelPoints.insert(std::make_pair(source, target)).second)
+    {
+        // The travel point connects the clusters of the two rooms.
+        HierarchicalPathFinder::instance().invalidate(source);
+        return true;
+    }
+    return false;
 }
 
 void Mud::addCommand(const std::shared_ptr<Command> & command)
@@ -446,7 +476,20 @@ Area * Mud::findArea(int vnum)
 Room * Mud::findRoom(int vnum)
 {
     auto it = mudRooms.find(vnum);
-    return (it == mudRooms.end()) ? nullptr : it->second;
+    if (it != mudRooms.end())
+    {
+        return it->second;
+    }
+    // The room could belong to a streamed area.
+    for (auto iterator : mudAreas)
+    {
+        auto const & chunks = iterator.second->chunks;
+        if ((chunks != nullptr) && chunks->contains(vnum))
+        {
+            return chunks->getRoom(vnum);
+        }
+    }
+    return nullptr;
 }
 
 Race * Mud::findRace(int vnum)
@@ -692,6 +735,11 @@ int Mud::getMaxVnumRoom() const
     return _maxVnumRoom;
 }
 
+void Mud::reserveRoomVnums(int vnum)
+{
+    _maxVnumRoom = std::max(_maxVnumRoom, vnum);
+}
+
 int Mud::getMaxVnumItem() const
 {
     return _maxVnumItem;
@@ -932,6 +980,14 @@ bool Mud::initDatabase()
         Logger::log(LogLevel::Error, "Error loading tables!");
         return false;
     }
+    // Register the light sources inside the light maps of the areas.
+    for (auto it : mudItems)
+    {
+        if (it.second->getType() == ModelType::Light)
+        {
+            static_cast<LightItem *>(it.second)->updateLightMap();
+        }
+    }
     return true;
 }
 
@@ -212,21 +212,21 @@ public:
     ///         <b>False</b> Otherwise.
     bool savePlayers();
 
-    /// @brief Update all the items on the database.
+    /// @brief Update the items and the rooms modified since they have been
+    ///         saved on the database.
     /// @return <b>True</b> if the operations succeeded,<br>
     ///         <b>False</b> Otherwise.
-    bool saveItems();
-
-    /// @brief Update all the rooms on the database.
-    /// @return <b>True</b> if the operations succeeded,<br>
-    ///         <b>False</b> Otherwise.
-    bool saveRooms();
+    bool saveChanges();
 
     /// @brief Update the mud dynimic information like: Players and Items.
     /// @return <b>True</b> if the operations succeeded,<br>
     ///         <b>False</b> Otherwise.
     bool saveMud();
 
+    /// @brief Updates the memory usage of the sampled subsystems
+    ///         (i.e. the database, the generated maps and the strings).
+    void sampleMemoryUsage();
+
     /// @defgroup GlobalAddRemove Global Add and Remove Functions
     /// @brief All the functions necessary to add and remove objects from their
     ///         correspondent global list.
@@ -334,7 +334,8 @@ public:
     /// Find an area given its vnum.
     Area * findArea(int vnum);
 
-    /// Find a room given its vnum.
+    /// Find a room given its vnum, the rooms of the streamed areas are
+    /// materialized if necessary.
     Room * findRoom(int vnum);
 
     /// Find a race given its vnum.
@@ -423,6 +424,11 @@ public:
     /// @return The maximum rooms vnum.
     int getMaxVnumRoom() const;
 
+    /// @brief Reserves the room vnums up to the given one, so that they are
+    ///         not used by the new rooms.
+    /// @param vnum The last reserved vnum.
+    void reserveRoomVnums(int vnum);
+
     /// @brief Returns the current maximum vnum used for items.
     /// @return The maximum items vnum.
     int getMaxVnumItem() const;
@@ -24,188 +24,207 @@
 
 #include "pathFinder.hpp"
 #include "aStarNode.hpp"
+#include <unordered_map>
 #include <algorithm>
 
 /// @brief The AStar algorithm.
-template<typename T>
+/// @details
+/// The open set is a binary heap, while the nodes are kept inside a pool
+/// indexed by element. Both the pool and the index keep their storage
+/// between two searches, so the same instance should be reused whenever
+/// possible.
+template<typename T, typename Hash = std::hash<T>>
 class AStar :
     public PathFinder<T>
 {
 private:
-    /// List of AStar nodes.
-    std::vector<std::shared_ptr<AStarNode<T>>> nodes;
-    /// The starting node.
-    std::shared_ptr<AStarNode<T>> startNode;
-    /// The ending node.
-    std::shared_ptr<AStarNode<T>> endNode;
+    /// @brief An entry of the open set.
+    class OpenEntry
+    {
+    public:
+        /// The 'f' value of the node when it has been pushed.
+        int f;
+        /// The 'h' value of the node, used to break ties.
+        int h;
+        /// The position of the node inside the pool.
+        size_t node;
+
+        /// @brief Constructor.
+        OpenEntry(int _f, int _h, size_t _node) :
+            f(_f),
+            h(_h),
+            node(_node)
+        {
+            // Nothing to do.
+        }
+
+        /// @brief Orders the entries so that the heap top has the lowest 'f'.
+        bool operator<(const OpenEntry & right) const
+        {
+            if (f != right.f) return f > right.f;
+            return h > right.h;
+        }
+    };
+
+    /// Pool of AStar nodes.
+    std::vector<AStarNode<T>> nodes;
+    /// Position of the nodes inside the pool, by element.
+    std::unordered_map<T, size_t, Hash> index;
+    /// The open set.
+    std::vector<OpenEntry> openSet;
+    /// The maximum cost of a path, a negative value means no limit.
+    int costLimit;
+    /// The number of nodes expanded during the last search.
+    size_t expandedNodes;
 
 public:
     /// @brief Create a new instance of AStar.
     AStar(const std::function<bool(T e1, T e2)> & _checkConnection,
           const std::function<int(T e1, T e2)> & _getDistance,
           const std::function<bool(T e1, T e2)> & _areEqual,
-          const std::function<std::vector<T>(T e)> & _getNeighbours) :
+          const std::function<std::vector<T>(T e)> & _getNeighbours,
+          const int & _costLimit = -1) :
         PathFinder<T>(
             _checkConnection,
             _getDistance,
             _areEqual,
             _getNeighbours),
         nodes(),
-        startNode(),
-        endNode()
+        index(),
+        openSet(),
+        costLimit(_costLimit),
+        expandedNodes()
     {
         // Nothing to do.
     }
 
-    bool findPath(T start, T end, std::vector<T> & path) override
+    /// @brief Sets the maximum cost of a path, paths which would cost more
+    ///         are not explored. A negative value means no limit.
+    void setCostLimit(const int & _costLimit)
     {
-        // Create the starting and end nodes.
-        startNode = std::make_shared<AStarNode<T>>(start);
-        endNode = std::make_shared<AStarNode<T>>(end);
-        // Add the starting and ending nodes to the list of nodes.
-        nodes.emplace_back(startNode);
-        nodes.emplace_back(endNode);
-        // Rise the endNode flag for the end node.
-        endNode->setIsEndNode();
-        // Set the G-Value and H-Value for the starting node.
-        startNode->setG(0);
-        startNode->setH(this->getDistance(start, end));
-        // Start the search.
-        if (this->search(startNode))
-        {
-            // If a path was found, follow the parents from the end node to build a list of locations.
-            auto node = endNode;
-            while (node->getParentNode() != nullptr)
-            {
-                path.emplace_back(node->getElement());
-                node = node->getParentNode();
-            }
-            std::reverse(path.begin(), path.end());
-            return true;
-        }
-        return false;
+        costLimit = _costLimit;
     }
 
-private:
-    /// @brief Recursive function used to search the path from the
-    ///         current node to the ending node.
-    /// @param currentNode The current node beeing visited.
-    /// @return <b>True</b> if, by visiting the current node,
-    ///                     we have reached the end node,<br>
-    ///         <b>False</b> otherwise.
-    bool search(std::shared_ptr<AStarNode<T>> currentNode)
+    /// @brief Provides the number of nodes expanded during the last search.
+    size_t getExpandedNodes() const
     {
-        // Set the current node to Closed since it cannot be traversed more than once
-        currentNode->setNodeState(AStarNodeState::Closed);
-        auto neighbours(this->getAStarNeighbours(currentNode));
-        // Continue the search for each neighbour.
-        for (std::shared_ptr<AStarNode<T>> & neighbour : neighbours)
+        return expandedNodes;
+    }
+
+    bool findPath(T start, T end, std::vector<T> & path) override
+    {
+        path.clear();
+        // Clear the data of the previous search, keeping the storage.
+        nodes.clear();
+        index.clear();
+        openSet.clear();
+        expandedNodes = 0;
+        // Check if the end is reachable within the cost limit.
+        auto h = this->getDistance(start, end);
+        if ((costLimit >= 0) && (h > costLimit))
         {
-            // Ignore already-closed nodes
-            if (neighbour->getNodeState() == AStarNodeState::Closed)
+            return false;
+        }
+        // Create the starting node and put it inside the open set.
+        auto startNode = this->getNode(start, end);
+        nodes[startNode].setG(0);
+        this->open(startNode);
+        while (!openSet.empty())
+        {
+            // Take the node with the lowest 'f' value.
+            std::pop_heap(openSet.begin(), openSet.end());
+            auto entry = openSet.back();
+            openSet.pop_back();
+            auto current = entry.node;
+            // Skip the outdated entries of nodes which have already been
+            // reached through a shorter path.
+            if ((nodes[current].getNodeState() == AStarNodeState::Closed) ||
+                (nodes[current].getF() != entry.f))
             {
                 continue;
             }
-            // Evaluate the G-value for the neighbour.
-            int gTemp = currentNode->getG() +
-                        this->getDistance(currentNode->getElement(),
-                                          neighbour->getElement());
-            // Already-open nodes are only added to the list if their G-value
-            // is lower going via this route.
-            if (neighbour->getNodeState() == AStarNodeState::Open)
+            // Check whether the end node has been reached.
+            if (this->areEqual(nodes[current].getElement(), end))
             {
-                if (gTemp < neighbour->getG())
-                {
-                    // Change the parent of the neighbour node.
-                    neighbour->setParentNode(currentNode);
-                    // Set the new G-Value.
-                    neighbour->setG(gTemp);
-                    // Check whether the end node has been reached.
-                    if (this->areEqual(endNode->getElement(),
-                                       neighbour->getElement()))
-                    {
-                        return true;
-                    }
-                    // If not, check the next set of nodes.
-                    if (this->search(neighbour))
-                    {
-                        return true;
-                    }
-                }
+                this->buildPath(current, path);
+                return true;
             }
-            else
+            // Set the current node to Closed since it cannot be traversed
+            // more than once.
+            nodes[current].setNodeState(AStarNodeState::Closed);
+            ++expandedNodes;
+            auto element = nodes[current].getElement();
+            for (T neighbour : this->getNeighbours(element))
             {
-                // Change the state of the node as Open.
-                neighbour->setNodeState(AStarNodeState::Open);
-                // Change the parent of the neighbour node.
-                neighbour->setParentNode(currentNode);
-                // Set the new G-Value.
-                neighbour->setG(gTemp);
-                // Check whether the end node has been reached.
-                if (this->areEqual(endNode->getElement(),
-                                   neighbour->getElement()))
+                // Check if the neighbour is valid.
+                if (!this->checkConnection(element, neighbour))
+                {
+                    continue;
+                }
+                auto next = this->getNode(neighbour, end);
+                // Ignore already-closed nodes.
+                if (nodes[next].getNodeState() == AStarNodeState::Closed)
                 {
-                    return true;
+                    continue;
                 }
-                // If not, check the next set of nodes.
-                if (this->search(neighbour))
+                // Evaluate the G-value for the neighbour.
+                int gTemp = nodes[current].getG() +
+                            this->getDistance(element, neighbour);
+                // Skip the neighbour if the path would cost too much.
+                if ((costLimit >= 0) &&
+                    ((gTemp + nodes[next].getH()) > costLimit))
                 {
-                    return true;
+                    continue;
                 }
+                // Already-open nodes are updated only if their G-value
+                // is lower going via this route.
+                if ((nodes[next].getNodeState() == AStarNodeState::Open) &&
+                    (gTemp >= nodes[next].getG()))
+                {
+                    continue;
+                }
+                nodes[next].setParentNode(current);
+                nodes[next].setG(gTemp);
+                this->open(next);
             }
         }
-        // The method returns false if this path leads to be a dead end.
         return false;
     }
 
-    /// @brief Provides the list of neighbours of the given node wrapped by
-    /// an AStarNode.
-    std::vector<std::shared_ptr<AStarNode<T>>> getAStarNeighbours(
-        std::shared_ptr<AStarNode<T>> currentNode)
+private:
+    /// @brief Provides the position of the node wrapping the given element,
+    ///         creating it if necessary.
+    size_t getNode(T element, T end)
     {
-        // Prepare a structure which will contain all the neighbours.
-        std::vector<std::shared_ptr<AStarNode<T>>> neighbours;
-        // Check if the given neighbour.
-        for (T neighbour : this->getNeighbours(currentNode->getElement()))
+        auto it = index.find(element);
+        if (it != index.end())
         {
-            // Check if the neighbour is valid.
-            if (this->checkConnection(currentNode->getElement(), neighbour))
-            {
-                // Check if there is already a wrapper for the given node.
-                bool found = false;
-                for (const std::shared_ptr<AStarNode<T>> & aStarNode : nodes)
-                {
-                    if (this->areEqual(aStarNode->getElement(), neighbour))
-                    {
-                        neighbours.emplace_back(aStarNode);
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found)
-                {
-                    auto newNode = std::make_shared<AStarNode<T>>(neighbour);
-                    newNode->setG(currentNode->getG() +
-                                  this->getDistance(currentNode->getElement(),
-                                                    neighbour));
-                    newNode->setH(
-                        this->getDistance(neighbour,
-                                          endNode->getElement()));
-                    nodes.emplace_back(newNode);
-                    neighbours.emplace_back(newNode);
-                }
-            }
+            return it->second;
         }
-        // Reorder the neighbours so that the one with the lesser
-        // G-Value comes first.
-        std::sort(neighbours.begin(),
-                  neighbours.end(),
-                  [](const std::shared_ptr<AStarNode<T>> & left,
-                     const std::shared_ptr<AStarNode<T>> & right)
-                  {
-                      return left->getF() < right->getF();
-                  });
-        return neighbours;
+        auto position = nodes.size();
+        nodes.emplace_back(element);
+        nodes.back().setH(this->getDistance(element, end));
+        index.insert(std::make_pair(element, position));
+        return position;
+    }
+
+    /// @brief Puts the given node inside the open set.
+    void open(const size_t & node)
+    {
+        nodes[node].setNodeState(AStarNodeState::Open);
+        openSet.emplace_back(nodes[node].getF(), nodes[node].getH(), node);
+        std::push_heap(openSet.begin(), openSet.end());
     }
-};
 
+    /// @brief Follows the parents from the end node to build the path,
+    ///         the starting element is not part of the path.
+    void buildPath(size_t node, std::vector<T> & path)
+    {
+        while (nodes[node].getParentNode() != AStarNode<T>::noParent)
+        {
+            path.emplace_back(nodes[node].getElement());
+            node = nodes[node].getParentNode();
+        }
+        std::reverse(path.begin(), path.end());
+    }
+};
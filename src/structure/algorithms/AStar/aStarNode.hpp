@@ -23,8 +23,8 @@
 #pragma once
 
 #include "pathFinderNode.hpp"
-#include <memory>
-#include <vector>
+#include <cstddef>
+#include <limits>
 
 /// @brief The states of an AStar node.
 using AStarNodeState = enum class AStarNodeState_t
@@ -34,11 +34,16 @@ using AStarNodeState = enum class AStarNodeState_t
     Closed      /// <! The node is on the 'closed' state.
 };
 
-/// @brief A supporting node for the AStart algorithm.
+/// @brief A node of the AStar algorithm, nodes are stored inside a pool and
+///         refer to their parent by means of its position inside the pool.
 template<typename T>
 class AStarNode :
     public PathFinderNode<T>
 {
+public:
+    /// Value used to identify a node without parent.
+    static const size_t noParent = std::numeric_limits<size_t>::max();
+
 private:
     /// Node state.
     AStarNodeState nodeState;
@@ -49,12 +54,9 @@ private:
     /// The straight-line distance from this node to the end node.
     int h;
 
-    /// The previous node in path. It is used when recontructing the path
-    ///  from the end node to the beginning.
-    std::shared_ptr<AStarNode<T>> parentNode;
-
-    /// Identifies the end node.
-    bool endNodeFlag;
+    /// The position of the previous node in path. It is used when
+    ///  recontructing the path from the end node to the beginning.
+    size_t parentNode;
 
 public:
     /// @brief Constructor.
@@ -63,8 +65,7 @@ public:
         nodeState(),
         g(),
         h(),
-        parentNode(),
-        endNodeFlag()
+        parentNode(noParent)
     {
         // Nothing to do.
     }
@@ -87,18 +88,12 @@ public:
         h = _h;
     }
 
-    /// @brief Allows to set the parent node.
-    void setParentNode(std::shared_ptr<AStarNode<T>> _parentNode)
+    /// @brief Allows to set the position of the parent node.
+    void setParentNode(const size_t & _parentNode)
     {
         parentNode = _parentNode;
     }
 
-    /// @brief Allows to set if this node is the end node.
-    void setIsEndNode()
-    {
-        endNodeFlag = true;
-    }
-
     /// @brief Provides the state of the node.
     AStarNodeState getNodeState() const
     {
@@ -111,21 +106,21 @@ public:
         return g;
     }
 
+    /// @brief Provides the 'h' value.
+    int getH() const
+    {
+        return h;
+    }
+
     /// @brief Provides the 'f' value.
     int getF() const
     {
         return g + h;
     }
 
-    /// @brief Privdes the parent node.
-    std::shared_ptr<AStarNode<T>> getParentNode()
+    /// @brief Provides the position of the parent node.
+    size_t getParentNode() const
     {
         return parentNode;
     }
-
-    /// @brief Gives information if this node is the end node.
-    bool isEndNode() const
-    {
-        return endNodeFlag;
-    }
 };
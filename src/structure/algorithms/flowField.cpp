@@ -0,0 +1,203 @@
+/// @file   flowField.cpp
+/// @brief  Shared distance maps used by the characters chasing a target.
+/// @author Enrico Fraccaroli
+/// @date   09 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "flowField.hpp"
+
+#include "structureUtils.hpp"
+#include "area.hpp"
+#include "room.hpp"
+
+#include <queue>
+
+FlowField::FlowField(Room * _target, bool _mobile, int maxDistance) :
+    target(_target),
+    area(_target->area),
+    mobile(_mobile),
+    distances(),
+    successors(),
+    lastUse()
+{
+    auto Compare = [](const std::pair<int, Room *> & left,
+                      const std::pair<int, Room *> & right)
+    {
+        return left.first > right.first;
+    };
+    std::priority_queue<std::pair<int, Room *>,
+                        std::vector<std::pair<int, Room *>>,
+                        decltype(Compare)> openSet(Compare);
+    // Prepare the movement options, the checks on the state of the
+    // character are performed when it actually moves.
+    MovementOptions options;
+    std::string error;
+    distances[target] = 0;
+    openSet.push(std::make_pair(0, target));
+    while (!openSet.empty())
+    {
+        auto current = openSet.top();
+        openSet.pop();
+        auto room = current.second;
+        if (current.first != distances[room])
+        {
+            continue;
+        }
+        // Search the rooms from which the current one can be reached.
+        for (auto const & it : room->exits)
+        {
+            auto previous = it->destination;
+            if ((previous == nullptr) || (previous->area != area))
+            {
+                continue;
+            }
+            if (!StructUtils::checkConnection(options, previous, room, error))
+            {
+                continue;
+            }
+            // Check if the exit is forbidden for mobiles.
+            auto connection = previous->findExit(it->direction.getOpposite());
+            if (mobile && (connection != nullptr) &&
+                HasFlag(connection->flags, ExitFlag::NoMob))
+            {
+                continue;
+            }
+            auto distance = current.first +
+                            StructUtils::getRoomDistance(previous, room);
+            if (distance > maxDistance)
+            {
+                continue;
+            }
+            auto found = distances.find(previous);
+            if ((found != distances.end()) && (found->second <= distance))
+            {
+                continue;
+            }
+            distances[previous] = distance;
+            successors[previous] = room;
+            openSet.push(std::make_pair(distance, previous));
+        }
+    }
+}
+
+int FlowField::getDistance(Room * room) const
+{
+    auto it = distances.find(room);
+    return (it == distances.end()) ? -1 : it->second;
+}
+
+bool FlowField::getPath(Room * room, std::vector<Room *> & path) const
+{
+    path.clear();
+    if (this->getDistance(room) < 0)
+    {
+        return false;
+    }
+    // Follow the moves which have been validated while computing the field.
+    while (room != target)
+    {
+        auto it = successors.find(room);
+        if (it == successors.end())
+        {
+            path.clear();
+            return false;
+        }
+        room = it->second;
+        path.emplace_back(room);
+    }
+    return true;
+}
+
+FlowFieldService::FlowFieldService() :
+    fields(),
+    uses(),
+    computedFields()
+{
+    // Nothing to do.
+}
+
+FlowFieldService::~FlowFieldService()
+{
+    // Nothing to do.
+}
+
+FlowFieldService & FlowFieldService::instance()
+{
+    // Since it's a static variable, if the class has already been created,
+    // It won't be created again. And it **is** thread-safe in C++11.
+    static FlowFieldService instance;
+    // Return a reference to our instance.
+    return instance;
+}
+
+const FlowField & FlowFieldService::getField(Room * target, bool mobile)
+{
+    auto key = std::make_tuple(target->vnum, mobile);
+    auto it = fields.find(key);
+    if ((it == fields.end()) || (it->second.target != target))
+    {
+        if (it != fields.end())
+        {
+            fields.erase(it);
+        }
+        // Discard the least recently used field.
+        if (fields.size() >= maxFields)
+        {
+            auto oldest = fields.begin();
+            for (auto field = fields.begin(); field != fields.end(); ++field)
+            {
+                if (field->second.lastUse < oldest->second.lastUse)
+                {
+                    oldest = field;
+                }
+            }
+            fields.erase(oldest);
+        }
+        it = fields.insert(std::make_pair(
+            key, FlowField(target, mobile, maxDistance))).first;
+        ++computedFields;
+    }
+    it->second.lastUse = ++uses;
+    return it->second;
+}
+
+void FlowFieldService::invalidate(Area * area)
+{
+    for (auto it = fields.begin(); it != fields.end();)
+    {
+        if (it->second.area == area)
+        {
+            it = fields.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+size_t FlowFieldService::getNumberOfFields() const
+{
+    return fields.size();
+}
+
+size_t FlowFieldService::getComputedFields() const
+{
+    return computedFields;
+}
@@ -0,0 +1,127 @@
+/// @file   flowField.hpp
+/// @brief  Shared distance maps used by the characters chasing a target.
+/// @author Enrico Fraccaroli
+/// @date   09 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <unordered_map>
+#include <cstddef>
+#include <vector>
+#include <tuple>
+#include <map>
+
+class Area;
+
+class Room;
+
+/// @brief The distance of the rooms of an area from a target room,
+///         computed by means of a reverse Dijkstra search.
+class FlowField
+{
+public:
+    /// The target of the field.
+    Room * target;
+    /// The area of the target.
+    Area * area;
+    /// If the field has been computed for mobiles.
+    bool mobile;
+    /// The distance of each reached room from the target.
+    std::unordered_map<Room *, int> distances;
+    /// The room towards which each reached room moves, through an exit
+    /// which has been checked while computing the field.
+    std::unordered_map<Room *, Room *> successors;
+    /// The last time the field has been used.
+    unsigned long lastUse;
+
+    /// @brief Constructor.
+    FlowField(Room * _target, bool _mobile, int maxDistance);
+
+    /// @brief Provides the distance of the room from the target.
+    /// @param room The room.
+    /// @return The distance, or -1 if the room has not been reached.
+    int getDistance(Room * room) const;
+
+    /// @brief Follows the field from the given room to the target.
+    /// @param room The starting room.
+    /// @param path Where the path is stored, the starting room is not
+    ///              part of it.
+    /// @return <b>True</b> if the field leads to the target,<br>
+    ///         <b>False</b> otherwise.
+    bool getPath(Room * room, std::vector<Room *> & path) const;
+};
+
+/// @brief Keeps the flow fields of the chased targets, so that all the
+///         characters chasing the same target share the same search.
+class FlowFieldService
+{
+private:
+    /// The maximum number of fields kept at the same time.
+    static const size_t maxFields = 64;
+    /// The maximum distance covered by a field.
+    static const int maxDistance = 32;
+    /// The fields, by target room and movement class (mobile or not).
+    std::map<std::tuple<int, bool>, FlowField> fields;
+    /// Counter used to find the least recently used field.
+    unsigned long uses;
+    /// The number of fields which have been computed.
+    size_t computedFields;
+
+    /// @brief Constructor.
+    FlowFieldService();
+
+    /// @brief Destructor.
+    ~FlowFieldService();
+
+public:
+    /// @brief Disable Copy Construct.
+    FlowFieldService(FlowFieldService const &) = delete;
+
+    /// @brief Disable Move construct.
+    FlowFieldService(FlowFieldService &&) = delete;
+
+    /// @brief Disable Copy assign.
+    FlowFieldService & operator=(FlowFieldService const &) = delete;
+
+    /// @brief Disable Move assign.
+    FlowFieldService & operator=(FlowFieldService &&) = delete;
+
+    /// @brief Get the singleton istance of the service.
+    /// @return The static and unique service.
+    static FlowFieldService & instance();
+
+    /// @brief Provides the field which leads to the given room, it is
+    ///         computed only if it is not already available.
+    /// @param target The target room.
+    /// @param mobile If the field is used by mobiles.
+    /// @return The flow field.
+    const FlowField & getField(Room * target, bool mobile);
+
+    /// @brief Discards the fields of the given area, it must be called
+    ///         every time the rooms, exits or doors of the area change.
+    /// @param area The area which has changed.
+    void invalidate(Area * area);
+
+    /// @brief Provides the number of fields currently kept.
+    size_t getNumberOfFields() const;
+
+    /// @brief Provides the number of fields which have been computed.
+    size_t getComputedFields() const;
+};
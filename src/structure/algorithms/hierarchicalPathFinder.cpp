@@ -0,0 +1,522 @@
+/// @file   hierarchicalPathFinder.cpp
+/// @brief  Hierarchical pathfinder, based on clusters of rooms.
+/// @author Enrico Fraccaroli
+/// @date   08 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "hierarchicalPathFinder.hpp"
+
+#include "structureUtils.hpp"
+#include "aStar.hpp"
+#include "area.hpp"
+#include "room.hpp"
+#include "mud.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <queue>
+#include <deque>
+
+HierarchicalPathFinder::Cluster::Cluster() :
+    portals()
+{
+    // Nothing to do.
+}
+
+HierarchicalPathFinder::HierarchicalPathFinder() :
+    clusters(),
+    incoming(),
+    abstractSearches(),
+    localSearches(),
+    generation(),
+    changes(),
+    cleared()
+{
+    // Nothing to do.
+}
+
+HierarchicalPathFinder::~HierarchicalPathFinder()
+{
+    // Nothing to do.
+}
+
+HierarchicalPathFinder & HierarchicalPathFinder::instance()
+{
+    // Since it's a static variable, if the class has already been created,
+    // It won't be created again. And it **is** thread-safe in C++11.
+    static HierarchicalPathFinder instance;
+    // Return a reference to our instance.
+    return instance;
+}
+
+bool HierarchicalPathFinder::findPath(Character * character,
+                                      Room * start,
+                                      Room * end,
+                                      std::vector<Room *> & path)
+{
+    path.clear();
+    if ((start == nullptr) || (end == nullptr))
+    {
+        return false;
+    }
+    if ((start->area == nullptr) || (end->area == nullptr))
+    {
+        return false;
+    }
+    if (start == end)
+    {
+        return true;
+    }
+    // Nearby destinations are searched directly.
+    if ((start->area == end->area) &&
+        ((getClusterKey(start) == getClusterKey(end)) ||
+         (StructUtils::getDistance(start->coord, end->coord) <= clusterSize)))
+    {
+        if (this->findLocalPath(character, start, end, nullptr, path))
+        {
+            return true;
+        }
+        path.clear();
+    }
+    // Search the route between the clusters.
+    ++abstractSearches;
+    auto endKey = getClusterKey(end);
+    auto toEnd = explore(end, true);
+    auto Heuristic = [&end](Room * room)
+    {
+        if (room->area != end->area) return 0;
+        return StructUtils::getDistance(room->coord, end->coord);
+    };
+    auto Compare = [](const std::pair<int, Room *> & left,
+                      const std::pair<int, Room *> & right)
+    {
+        return left.first > right.first;
+    };
+    std::priority_queue<std::pair<int, Room *>,
+                        std::vector<std::pair<int, Room *>>,
+                        decltype(Compare)> openSet(Compare);
+    std::unordered_map<Room *, int> cost;
+    std::unordered_map<Room *, Room *> parent;
+    cost[start] = 0;
+    openSet.push(std::make_pair(Heuristic(start), start));
+    bool found = false;
+    while (!openSet.empty())
+    {
+        auto current = openSet.top();
+        openSet.pop();
+        auto room = current.second;
+        auto g = cost[room];
+        // Skip the outdated entries.
+        if (current.first != (g + Heuristic(room)))
+        {
+            continue;
+        }
+        if (room == end)
+        {
+            found = true;
+            break;
+        }
+        auto edges = this->getEdges(room);
+        // The rooms of the last cluster are connected to the destination.
+        if (getClusterKey(room) == endKey)
+        {
+            auto it = toEnd.find(room);
+            if (it != toEnd.end())
+            {
+                edges.emplace_back(std::make_pair(end, it->second));
+            }
+        }
+        for (auto const & edge : edges)
+        {
+            auto gTemp = g + edge.second;
+            auto it = cost.find(edge.first);
+            if ((it != cost.end()) && (it->second <= gTemp))
+            {
+                continue;
+            }
+            cost[edge.first] = gTemp;
+            parent[edge.first] = room;
+            openSet.push(std::make_pair(gTemp + Heuristic(edge.first),
+                                        edge.first));
+        }
+    }
+    if (found)
+    {
+        // Rebuild the route from the parents.
+        std::vector<Room *> route;
+        for (auto room = end; room != start; room = parent[room])
+        {
+            route.emplace_back(room);
+        }
+        route.emplace_back(start);
+        std::reverse(route.begin(), route.end());
+        // Refine the segments of the route.
+        for (size_t it = 1; found && (it < route.size()); ++it)
+        {
+            auto from = route[it - 1];
+            auto to = route[it];
+            if (isTravel(from, to))
+            {
+                path.emplace_back(to);
+                continue;
+            }
+            auto key = getClusterKey(from);
+            found = this->findLocalPath(
+                character, from, to,
+                (key == getClusterKey(to)) ? &key : nullptr,
+                path);
+        }
+        if (found)
+        {
+            return true;
+        }
+    }
+    path.clear();
+    // The abstract graph ignores the checks which depend on the character,
+    // as last resort search the whole area.
+    if (start->area == end->area)
+    {
+        return this->findLocalPath(character, start, end, nullptr, path);
+    }
+    return false;
+}
+
+void HierarchicalPathFinder::invalidate(Room * room)
+{
+    if ((room == nullptr) || (room->area == nullptr))
+    {
+        return;
+    }
+    this->invalidate(room->area, room->coord);
+}
+
+void HierarchicalPathFinder::invalidate(Area * area,
+                                        const Coordinates & coordinates)
+{
+    ++generation;
+    changes[area->vnum] = generation;
+    auto key = getClusterKey(area, coordinates);
+    clusters.erase(key);
+    // The clusters with edges towards this one are outdated too.
+    auto it = incoming.find(key);
+    if (it != incoming.end())
+    {
+        for (auto const & other : it->second)
+        {
+            clusters.erase(other);
+        }
+        incoming.erase(it);
+    }
+}
+
+void HierarchicalPathFinder::clear()
+{
+    ++generation;
+    cleared = generation;
+    clusters.clear();
+    incoming.clear();
+}
+
+size_t HierarchicalPathFinder::getNumberOfClusters() const
+{
+    return clusters.size();
+}
+
+size_t HierarchicalPathFinder::getNumberOfPortals() const
+{
+    size_t portals = 0;
+    for (auto const & it : clusters)
+    {
+        portals += it.second.portals.size();
+    }
+    return portals;
+}
+
+size_t HierarchicalPathFinder::getAbstractSearches() const
+{
+    return abstractSearches;
+}
+
+size_t HierarchicalPathFinder::getLocalSearches() const
+{
+    return localSearches;
+}
+
+size_t HierarchicalPathFinder::getGeneration() const
+{
+    return generation;
+}
+
+size_t HierarchicalPathFinder::getGeneration(Area * area) const
+{
+    auto it = changes.find(area->vnum);
+    if (it == changes.end())
+    {
+        return cleared;
+    }
+    return std::max(it->second, cleared);
+}
+
+bool HierarchicalPathFinder::isTravel(Room * from, Room * to)
+{
+    if (!HasFlag(from->flags, RoomFlag::TravelPoint))
+    {
+        return false;
+    }
+    return Mud::instance().findTravelPoint(from) == to;
+}
+
+HierarchicalPathFinder::ClusterKey HierarchicalPathFinder::getClusterKey(
+    Room * room)
+{
+    return getClusterKey(room->area, room->coord);
+}
+
+HierarchicalPathFinder::ClusterKey HierarchicalPathFinder::getClusterKey(
+    Area * area,
+    const Coordinates & coordinates)
+{
+    return std::make_tuple(
+        area->vnum,
+        (coordinates.x < 0) ? -1 : (coordinates.x / clusterSize),
+        (coordinates.y < 0) ? -1 : (coordinates.y / clusterSize),
+        coordinates.z);
+}
+
+HierarchicalPathFinder::Cluster & HierarchicalPathFinder::getCluster(
+    Room * room)
+{
+    auto key = getClusterKey(room);
+    auto it = clusters.find(key);
+    if (it != clusters.end())
+    {
+        return it->second;
+    }
+    auto & cluster = clusters[key];
+    // Search the portals of the cluster.
+    auto min_x = std::get<1>(key) * clusterSize;
+    auto min_y = std::get<2>(key) * clusterSize;
+    Coordinates coordinates(0, 0, std::get<3>(key));
+    for (coordinates.x = min_x;
+         coordinates.x < (min_x + clusterSize); ++coordinates.x)
+    {
+        for (coordinates.y = min_y;
+             coordinates.y < (min_y + clusterSize); ++coordinates.y)
+        {
+            auto current = room->area->getRoom(coordinates);
+            if (current == nullptr)
+            {
+                continue;
+            }
+            for (auto next : getNext(current))
+            {
+                auto nextKey = getClusterKey(next);
+                if (nextKey == key)
+                {
+                    continue;
+                }
+                cluster.portals[current].emplace_back(std::make_pair(next, 1));
+                incoming[nextKey].insert(key);
+            }
+        }
+    }
+    // Connect the portals of the cluster.
+    for (auto & portal : cluster.portals)
+    {
+        for (auto const & reached : explore(portal.first, false))
+        {
+            if ((reached.first != portal.first) &&
+                (cluster.portals.find(reached.first) != cluster.portals.end()))
+            {
+                portal.second.emplace_back(reached);
+            }
+        }
+    }
+    return cluster;
+}
+
+bool HierarchicalPathFinder::isTraversable(Room * from, Room * to)
+{
+    // Check if there is water inside the destination room.
+    if (to->liquidContent.first != nullptr)
+    {
+        return false;
+    }
+    // Get the connection between the two.
+    auto direction = StructUtils::getDirection(from->coord, to->coord);
+    auto connection = from->findExit(direction);
+    if ((connection == nullptr) || (connection->destination != to))
+    {
+        return false;
+    }
+    // If the direction is upstairs, check if there is a stair.
+    if ((direction == Direction::Up) &&
+        !HasFlag(connection->flags, ExitFlag::Stairs))
+    {
+        return false;
+    }
+    // Check if the destination has a floor.
+    auto destDown = to->findExit(Direction::Down);
+    if ((destDown != nullptr) && !HasFlag(destDown->flags, ExitFlag::Stairs))
+    {
+        return false;
+    }
+    return true;
+}
+
+std::vector<Room *> HierarchicalPathFinder::getNext(Room * room)
+{
+    std::vector<Room *> result;
+    for (auto const & it : room->exits)
+    {
+        if ((it->destination != nullptr) &&
+            isTraversable(room, it->destination))
+        {
+            result.emplace_back(it->destination);
+        }
+    }
+    if (HasFlag(room->flags, RoomFlag::TravelPoint))
+    {
+        auto destination = Mud::instance().findTravelPoint(room);
+        if (destination != nullptr)
+        {
+            result.emplace_back(destination);
+        }
+    }
+    return result;
+}
+
+std::vector<Room *> HierarchicalPathFinder::getPrevious(Room * room)
+{
+    std::vector<Room *> result;
+    // Exits are created in pairs, the rooms which lead here are among the
+    // destinations of the exits of the room.
+    for (auto const & it : room->exits)
+    {
+        if ((it->destination != nullptr) &&
+            isTraversable(it->destination, room))
+        {
+            result.emplace_back(it->destination);
+        }
+    }
+    // Travel points are bidirectional too.
+    if (HasFlag(room->flags, RoomFlag::TravelPoint))
+    {
+        auto source = Mud::instance().findTravelPoint(room);
+        if ((source != nullptr) && isTravel(source, room))
+        {
+            result.emplace_back(source);
+        }
+    }
+    return result;
+}
+
+std::map<Room *, int> HierarchicalPathFinder::explore(Room * origin,
+                                                      bool reverse)
+{
+    std::map<Room *, int> distances;
+    auto key = getClusterKey(origin);
+    std::deque<Room *> queue;
+    distances[origin] = 0;
+    queue.emplace_back(origin);
+    while (!queue.empty())
+    {
+        auto room = queue.front();
+        queue.pop_front();
+        auto distance = distances[room] + 1;
+        for (auto other : (reverse ? getPrevious(room) : getNext(room)))
+        {
+            if ((getClusterKey(other) != key) ||
+                (distances.find(other) != distances.end()))
+            {
+                continue;
+            }
+            distances[other] = distance;
+            queue.emplace_back(other);
+        }
+    }
+    return distances;
+}
+
+std::vector<std::pair<Room *, int>> HierarchicalPathFinder::getEdges(
+    Room * room)
+{
+    auto & cluster = this->getCluster(room);
+    auto it = cluster.portals.find(room);
+    if (it != cluster.portals.end())
+    {
+        return it->second;
+    }
+    // The room is not a portal, connect it to the portals it can reach.
+    std::vector<std::pair<Room *, int>> edges;
+    for (auto const & reached : explore(room, false))
+    {
+        if (cluster.portals.find(reached.first) != cluster.portals.end())
+        {
+            edges.emplace_back(reached);
+        }
+    }
+    return edges;
+}
+
+bool HierarchicalPathFinder::findLocalPath(Character * character,
+                                           Room * start,
+                                           Room * end,
+                                           const ClusterKey * cluster,
+                                           std::vector<Room *> & path)
+{
+    ++localSearches;
+    auto CheckFunction = [&](Room * from, Room * to)
+    {
+        // Prepare the movement options.
+        MovementOptions options;
+        options.character = character;
+        // Prepare the error string.
+        std::string error;
+        return StructUtils::checkConnection(options, from, to, error);
+    };
+    auto NeighboursFunction = [&](Room * room)
+    {
+        auto neighbours = StructUtils::getNeighbours(room);
+        if (cluster != nullptr)
+        {
+            // Do not leave the cluster.
+            neighbours.erase(
+                std::remove_if(neighbours.begin(), neighbours.end(),
+                               [&](Room * other)
+                               {
+                                   return (other != end) &&
+                                          (other->area != nullptr) &&
+                                          (getClusterKey(other) != *cluster);
+                               }), neighbours.end());
+        }
+        return neighbours;
+    };
+    AStar<Room *> aStar(CheckFunction,
+                        StructUtils::getRoomDistance,
+                        StructUtils::roomsAreEqual,
+                        NeighboursFunction);
+    std::vector<Room *> segment;
+    if (!aStar.findPath(start, end, segment))
+    {
+        return false;
+    }
+    path.insert(path.end(), segment.begin(), segment.end());
+    return true;
+}
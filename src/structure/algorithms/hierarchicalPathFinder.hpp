@@ -0,0 +1,199 @@
+/// @file   hierarchicalPathFinder.hpp
+/// @brief  Hierarchical pathfinder, based on clusters of rooms.
+/// @author Enrico Fraccaroli
+/// @date   08 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <tuple>
+#include <map>
+#include <set>
+
+class Character;
+
+class Room;
+
+class Area;
+
+class Coordinates;
+
+/// @brief A pathfinder which searches first a route between clusters of
+///         rooms and then refines only the local segments of the route.
+/// @details
+/// Each area is split in clusters of rooms. The rooms which lead outside of
+/// their cluster (by means of an exit or a travel point) are the portals,
+/// and the portals of the same cluster are connected by edges weighted with
+/// the length of the local path between them. The abstract graph only
+/// considers the static features of the map (exits, stairs, water), the
+/// checks which depend on the character are performed while refining.
+/// Clusters are built when they are first needed and discarded when the
+/// topology of their rooms changes.
+class HierarchicalPathFinder
+{
+public:
+    /// The key of a cluster (area, x, y, z).
+    using ClusterKey = std::tuple<int, int, int, int>;
+
+private:
+    /// @brief A cluster of rooms.
+    class Cluster
+    {
+    public:
+        /// The portals of the cluster and their edges, with their cost.
+        std::map<Room *, std::vector<std::pair<Room *, int>>> portals;
+
+        /// @brief Constructor.
+        Cluster();
+    };
+
+    /// The size of the side of a cluster.
+    static const int clusterSize = 16;
+    /// The clusters which have been built.
+    std::map<ClusterKey, Cluster> clusters;
+    /// The clusters which have edges towards a cluster.
+    std::map<ClusterKey, std::set<ClusterKey>> incoming;
+    /// The number of searches performed on the abstract graph.
+    size_t abstractSearches;
+    /// The number of searches performed room by room.
+    size_t localSearches;
+    /// Counter increased every time the topology of the map changes.
+    size_t generation;
+    /// The generation of the last change of each area, by vnum.
+    std::map<int, size_t> changes;
+    /// The generation of the last time all the clusters were discarded.
+    size_t cleared;
+
+    /// @brief Constructor.
+    HierarchicalPathFinder();
+
+    /// @brief Destructor.
+    ~HierarchicalPathFinder();
+
+public:
+    /// @brief Disable Copy Construct.
+    HierarchicalPathFinder(HierarchicalPathFinder const &) = delete;
+
+    /// @brief Disable Move construct.
+    HierarchicalPathFinder(HierarchicalPathFinder &&) = delete;
+
+    /// @brief Disable Copy assign.
+    HierarchicalPathFinder & operator=(HierarchicalPathFinder const &) = delete;
+
+    /// @brief Disable Move assign.
+    HierarchicalPathFinder & operator=(HierarchicalPathFinder &&) = delete;
+
+    /// @brief Get the singleton istance of the pathfinder.
+    /// @return The static and unique pathfinder.
+    static HierarchicalPathFinder & instance();
+
+    /// @brief Searches a path between two rooms, possibly in different areas.
+    /// @param character The character who moves, it can be a nullptr.
+    /// @param start     The starting room.
+    /// @param end       The destination.
+    /// @param path      Where the path is stored, the starting room is not
+    ///                   part of it.
+    /// @return <b>True</b> if there is a path between the rooms,<br>
+    ///         <b>False</b> otherwise.
+    bool findPath(Character * character,
+                  Room * start,
+                  Room * end,
+                  std::vector<Room *> & path);
+
+    /// @brief Discards the cluster which contains the room, it must be
+    ///         called every time the topology around the room changes.
+    /// @param room The room which has changed.
+    void invalidate(Room * room);
+
+    /// @brief Discards the cluster which contains the given position, the
+    ///         room there could have already been destroyed.
+    /// @param area        The area of the position.
+    /// @param coordinates The position which has changed.
+    void invalidate(Area * area, const Coordinates & coordinates);
+
+    /// @brief Discards all the clusters.
+    void clear();
+
+    /// @brief Provides the number of clusters which have been built.
+    size_t getNumberOfClusters() const;
+
+    /// @brief Provides the number of portals of the built clusters.
+    size_t getNumberOfPortals() const;
+
+    /// @brief Provides the number of searches on the abstract graph.
+    size_t getAbstractSearches() const;
+
+    /// @brief Provides the number of searches performed room by room.
+    size_t getLocalSearches() const;
+
+    /// @brief Provides a counter which changes every time the topology of
+    ///         the map changes.
+    size_t getGeneration() const;
+
+    /// @brief Provides the generation of the last change of the topology
+    ///         of the given area.
+    size_t getGeneration(Area * area) const;
+
+    /// @brief Checks if the second room is reached from the first one by
+    ///         means of a travel point.
+    static bool isTravel(Room * from, Room * to);
+
+    /// @brief Provides the rooms which can be reached from the given one.
+    static std::vector<Room *> getNext(Room * room);
+
+private:
+    /// @brief Provides the key of the cluster which contains the room.
+    static ClusterKey getClusterKey(Room * room);
+
+    /// @brief Provides the key of the cluster which contains the position.
+    static ClusterKey getClusterKey(Area * area,
+                                    const Coordinates & coordinates);
+
+    /// @brief Provides the cluster which contains the room, it builds the
+    ///         cluster if necessary.
+    Cluster & getCluster(Room * room);
+
+    /// @brief Checks if the static features of the map allow to move from
+    ///         a room to an adjacent one.
+    static bool isTraversable(Room * from, Room * to);
+
+    /// @brief Provides the rooms from which the given one can be reached.
+    static std::vector<Room *> getPrevious(Room * room);
+
+    /// @brief Provides the distance of the rooms of the cluster from (or
+    ///         towards, if reverse is set) the origin.
+    static std::map<Room *, int> explore(Room * origin, bool reverse);
+
+    /// @brief Provides the edges of the given room inside the abstract graph.
+    std::vector<std::pair<Room *, int>> getEdges(Room * room);
+
+    /// @brief Searches the path room by room.
+    /// @param character The character who moves.
+    /// @param start     The starting room.
+    /// @param end       The destination.
+    /// @param cluster   If set, the search does not leave the given cluster.
+    /// @param path      Where the path is appended.
+    bool findLocalPath(Character * character,
+                       Room * start,
+                       Room * end,
+                       const ClusterKey * cluster,
+                       std::vector<Room *> & path);
+};
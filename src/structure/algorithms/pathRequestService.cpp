@@ -0,0 +1,483 @@
+/// @file   pathRequestService.cpp
+/// @brief  Implements the service which resolves the path requests of the
+///          scripts in background.
+/// @author Enrico Fraccaroli
+/// @date   10 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "pathRequestService.hpp"
+
+#include "hierarchicalPathFinder.hpp"
+#include "structureUtils.hpp"
+#include "mobile.hpp"
+#include "area.hpp"
+#include "logger.hpp"
+#include "room.hpp"
+#include "mud.hpp"
+
+#include <unordered_set>
+#include <algorithm>
+
+PathGraph::Edge::Edge(int _area,
+                      int _target,
+                      Direction _direction,
+                      bool _noMob) :
+    area(_area),
+    target(_target),
+    direction(_direction),
+    noMob(_noMob)
+{
+    // Nothing to do.
+}
+
+PathGraph::Part::Part(Area * area) :
+    vnums(),
+    indices(),
+    offsets(),
+    edges(),
+    generation(HierarchicalPathFinder::instance().getGeneration())
+{
+    vnums.reserve(area->roomIndex.size());
+    offsets.reserve(area->roomIndex.size() + 1);
+    for (auto const & it : area->roomIndex)
+    {
+        auto room = it.second;
+        indices[room->vnum] = static_cast<unsigned int>(vnums.size());
+        vnums.emplace_back(room->vnum);
+        offsets.emplace_back(edges.size());
+        for (auto next : HierarchicalPathFinder::getNext(room))
+        {
+            if (next->area == nullptr)
+            {
+                continue;
+            }
+            // Travel points cannot be expressed by a direction.
+            if (HierarchicalPathFinder::isTravel(room, next))
+            {
+                edges.emplace_back(next->area->vnum, next->vnum,
+                                   Direction::None, false);
+                continue;
+            }
+            auto direction = StructUtils::getDirection(room->coord,
+                                                       next->coord);
+            auto exit = room->findExit(direction);
+            edges.emplace_back(next->area->vnum, next->vnum, direction,
+                               (exit != nullptr) &&
+                               HasFlag(exit->flags, ExitFlag::NoMob));
+        }
+    }
+    offsets.emplace_back(edges.size());
+}
+
+PathGraph::Node::Node() :
+    part(),
+    index()
+{
+    // Nothing to do.
+}
+
+PathGraph::PathGraph(const std::shared_ptr<const PathGraph> & previous) :
+    parts(),
+    generation(HierarchicalPathFinder::instance().getGeneration())
+{
+    auto const & pathFinder = HierarchicalPathFinder::instance();
+    for (auto const & it : Mud::instance().mudAreas)
+    {
+        // Share the part of the area if it has not changed.
+        if (previous != nullptr)
+        {
+            auto part = previous->parts.find(it.first);
+            if ((part != previous->parts.end()) &&
+                (part->second->generation >=
+                 pathFinder.getGeneration(it.second)))
+            {
+                parts[it.first] = part->second;
+                continue;
+            }
+        }
+        parts[it.first] = std::make_shared<const Part>(it.second);
+    }
+}
+
+bool PathGraph::getNode(int area, int vnum, Node & node) const
+{
+    auto part = parts.find(area);
+    if (part == parts.end())
+    {
+        return false;
+    }
+    auto it = part->second->indices.find(vnum);
+    if (it == part->second->indices.end())
+    {
+        return false;
+    }
+    node.part = part->second.get();
+    node.index = it->second;
+    return true;
+}
+
+PathResult::PathResult() :
+    start(),
+    mobile(),
+    paths()
+{
+    // Nothing to do.
+}
+
+PathRequestService::Job::Job() :
+    handle(),
+    graph(),
+    start(),
+    destinations(),
+    mobile()
+{
+    // Nothing to do.
+}
+
+PathRequestService::PathRequestService() :
+    workers(),
+    queueMutex(),
+    queueCondition(),
+    jobs(),
+    completed(),
+    stopping(),
+    graph(),
+    lastHandle(),
+    pending(),
+    results()
+{
+    // Nothing to do.
+}
+
+PathRequestService::~PathRequestService()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (auto & worker : workers)
+    {
+        worker.join();
+    }
+}
+
+PathRequestService & PathRequestService::instance()
+{
+    // Since it's a static variable, if the class has already been created,
+    // It won't be created again. And it **is** thread-safe in C++11.
+    static PathRequestService instance;
+    // Return a reference to our instance.
+    return instance;
+}
+
+unsigned int PathRequestService::request(
+    Character * character,
+    const std::vector<Room *> & destinations)
+{
+    // Check the character and the destinations.
+    if ((character == nullptr) || (character->room == nullptr) ||
+        destinations.empty())
+    {
+        return 0;
+    }
+    Job job;
+    job.graph = this->getGraph();
+    job.mobile = character->isMobile();
+    if ((character->room->area == nullptr) ||
+        !job.graph->getNode(character->room->area->vnum,
+                            character->room->vnum, job.start))
+    {
+        return 0;
+    }
+    for (auto destination : destinations)
+    {
+        PathGraph::Node node;
+        if ((destination != nullptr) && (destination->area != nullptr) &&
+            job.graph->getNode(destination->area->vnum, destination->vnum,
+                               node))
+        {
+            job.destinations.emplace_back(destination->vnum);
+        }
+    }
+    if (job.destinations.empty())
+    {
+        return 0;
+    }
+    // Assign the handle, skipping the invalid one.
+    if (++lastHandle == 0)
+    {
+        ++lastHandle;
+    }
+    job.handle = lastHandle;
+    pending[job.handle] = character;
+    // Start the workers the first time they are needed.
+    if (workers.empty())
+    {
+        unsigned int numberOfWorkers = maxWorkers;
+        numberOfWorkers = std::min(numberOfWorkers,
+                                   std::thread::hardware_concurrency());
+        numberOfWorkers = std::max(numberOfWorkers, 1u);
+        for (unsigned int it = 0; it < numberOfWorkers; ++it)
+        {
+            workers.emplace_back(&PathRequestService::work, this);
+        }
+        Logger::log(LogLevel::Debug, "Started %s path workers.",
+                    ToString(numberOfWorkers));
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        jobs.emplace_back(std::move(job));
+    }
+    queueCondition.notify_one();
+    return lastHandle;
+}
+
+bool PathRequestService::isReady(unsigned int handle) const
+{
+    return results.find(handle) != results.end();
+}
+
+bool PathRequestService::getPath(unsigned int handle,
+                                 Room * destination,
+                                 std::vector<Direction> & path) const
+{
+    path.clear();
+    if (destination == nullptr)
+    {
+        return false;
+    }
+    auto result = results.find(handle);
+    if (result == results.end())
+    {
+        return false;
+    }
+    auto it = result->second.paths.find(destination->vnum);
+    if (it == result->second.paths.end())
+    {
+        return false;
+    }
+    // The snapshot ignores doors and the rooms could have changed.
+    if (!checkPath(result->second, it->second))
+    {
+        return false;
+    }
+    path = it->second;
+    return true;
+}
+
+void PathRequestService::release(unsigned int handle)
+{
+    results.erase(handle);
+}
+
+void PathRequestService::cancel(Character * character)
+{
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        if (it->second == character)
+        {
+            it = pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void PathRequestService::update()
+{
+    std::vector<std::pair<unsigned int, PathResult>> collected;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        collected.swap(completed);
+    }
+    for (auto & it : collected)
+    {
+        // Check if the request has been cancelled in the meanwhile.
+        auto request = pending.find(it.first);
+        if (request == pending.end())
+        {
+            continue;
+        }
+        auto character = request->second;
+        pending.erase(request);
+        // Discard the oldest result.
+        if (results.size() >= maxResults)
+        {
+            results.erase(results.begin());
+        }
+        results[it.first] = std::move(it.second);
+        // Notify the mobile.
+        if (character->isMobile())
+        {
+            static_cast<Mobile *>(character)->triggerEventPathReady(it.first);
+        }
+    }
+}
+
+size_t PathRequestService::getNumberOfPending() const
+{
+    return pending.size();
+}
+
+size_t PathRequestService::getNumberOfResults() const
+{
+    return results.size();
+}
+
+std::shared_ptr<const PathGraph> PathRequestService::getGraph()
+{
+    auto generation = HierarchicalPathFinder::instance().getGeneration();
+    if ((graph == nullptr) || (graph->generation != generation))
+    {
+        // The jobs already queued keep their own copy of the old graph,
+        // whose unchanged parts are shared with the new one.
+        graph = std::make_shared<const PathGraph>(graph);
+    }
+    return graph;
+}
+
+void PathRequestService::work()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]
+            {
+                return stopping || !jobs.empty();
+            });
+            if (stopping)
+            {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        auto result = search(job);
+        // Release the graph before handing the result to the game thread.
+        job.graph.reset();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            completed.emplace_back(job.handle, std::move(result));
+        }
+    }
+}
+
+PathResult PathRequestService::search(const Job & job)
+{
+    auto const & graph = *job.graph;
+    PathResult result;
+    result.start = job.start.part->vnums[job.start.index];
+    result.mobile = job.mobile;
+    // A breadth-first search from the start, which ends as soon as all
+    // the destinations have been reached. The rooms are identified by
+    // vnum, since the parts of the graph are shared between snapshots.
+    std::unordered_map<int, std::pair<int, Direction>> parent;
+    std::unordered_set<int> isDestination;
+    size_t remaining = 0;
+    for (auto destination : job.destinations)
+    {
+        if (isDestination.insert(destination).second)
+        {
+            ++remaining;
+        }
+    }
+    std::deque<PathGraph::Node> openSet;
+    parent[result.start] = std::make_pair(result.start, Direction::None);
+    openSet.emplace_back(job.start);
+    while (!openSet.empty() && (remaining > 0))
+    {
+        auto current = openSet.front();
+        openSet.pop_front();
+        auto const & part = *current.part;
+        auto vnum = part.vnums[current.index];
+        if (isDestination.find(vnum) != isDestination.end())
+        {
+            --remaining;
+        }
+        for (auto it = part.offsets[current.index];
+             it < part.offsets[current.index + 1]; ++it)
+        {
+            auto const & edge = part.edges[it];
+            if (job.mobile && edge.noMob)
+            {
+                continue;
+            }
+            if (parent.find(edge.target) != parent.end())
+            {
+                continue;
+            }
+            PathGraph::Node next;
+            if (!graph.getNode(edge.area, edge.target, next))
+            {
+                continue;
+            }
+            parent[edge.target] = std::make_pair(vnum, edge.direction);
+            openSet.emplace_back(next);
+        }
+    }
+    // Rebuild the paths towards the reached destinations.
+    for (auto destination : job.destinations)
+    {
+        if (parent.find(destination) == parent.end())
+        {
+            continue;
+        }
+        std::vector<Direction> path;
+        for (auto node = destination; node != result.start;
+             node = parent[node].first)
+        {
+            path.emplace_back(parent[node].second);
+        }
+        std::reverse(path.begin(), path.end());
+        // The path stops at the first travel point.
+        auto travel = std::find(path.begin(), path.end(), Direction::None);
+        path.erase(travel, path.end());
+        result.paths[destination] = std::move(path);
+    }
+    return result;
+}
+
+bool PathRequestService::checkPath(const PathResult & result,
+                                   const std::vector<Direction> & path)
+{
+    auto room = Mud::instance().findRoom(result.start);
+    // The checks on the state of the character are performed when it
+    // actually moves.
+    MovementOptions options;
+    std::string error;
+    for (auto const & direction : path)
+    {
+        if (!StructUtils::checkConnection(options, room, direction, error))
+        {
+            return false;
+        }
+        auto exit = room->findExit(direction);
+        if (result.mobile && HasFlag(exit->flags, ExitFlag::NoMob))
+        {
+            return false;
+        }
+        room = exit->destination;
+    }
+    return true;
+}
@@ -0,0 +1,275 @@
+/// @file   pathRequestService.hpp
+/// @brief  Defines the service which resolves the path requests of the scripts
+///          in background.
+/// @author Enrico Fraccaroli
+/// @date   10 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "direction.hpp"
+
+#include <condition_variable>
+#include <unordered_map>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <map>
+
+class Character;
+
+class Room;
+
+class Area;
+
+/// @brief An immutable copy of the connections between the rooms, which
+///         can be safely visited outside of the game thread.
+/// @details
+/// The graph is made of a part for each area. When the map changes, the
+/// new graph shares the parts of the areas which have not changed with the
+/// previous one, so that only the changed areas are copied again. The
+/// graph only contains the static features of the map (exits, stairs,
+/// water), doors and the state of the character are checked when the
+/// path is collected.
+class PathGraph
+{
+public:
+    /// @brief A connection between two rooms.
+    class Edge
+    {
+    public:
+        /// The vnum of the area of the destination.
+        int area;
+        /// The vnum of the destination.
+        int target;
+        /// The direction of the connection, None for travel points.
+        Direction direction;
+        /// If mobiles are not allowed to move through the connection.
+        bool noMob;
+
+        /// @brief Constructor.
+        Edge(int _area, int _target, Direction _direction, bool _noMob);
+    };
+
+    /// @brief The connections of the rooms of an area.
+    class Part
+    {
+    public:
+        /// The vnums of the rooms.
+        std::vector<int> vnums;
+        /// The index of the rooms, by vnum.
+        std::unordered_map<int, unsigned int> indices;
+        /// The position of the first edge of each room inside the edges,
+        /// the last element marks the end of the edges.
+        std::vector<size_t> offsets;
+        /// The connections which leave the rooms.
+        std::vector<Edge> edges;
+        /// The generation of the map when the part has been built.
+        size_t generation;
+
+        /// @brief Constructor, it copies the connections of the rooms of
+        ///         the area.
+        explicit Part(Area * area);
+    };
+
+    /// @brief A room inside the graph.
+    class Node
+    {
+    public:
+        /// The part which contains the room.
+        const Part * part;
+        /// The index of the room inside its part.
+        unsigned int index;
+
+        /// @brief Constructor.
+        Node();
+    };
+
+    /// The parts of the graph, by vnum of the area.
+    std::map<int, std::shared_ptr<const Part>> parts;
+    /// The generation of the map when the graph has been built.
+    size_t generation;
+
+    /// @brief Constructor, it copies the connections of the areas which
+    ///         have changed since the previous graph was built.
+    /// @param previous The previous graph, it can be a nullptr.
+    explicit PathGraph(const std::shared_ptr<const PathGraph> & previous);
+
+    /// @brief Provides the node of the given room.
+    /// @param area The vnum of the area of the room.
+    /// @param vnum The vnum of the room.
+    /// @param node Where the node is stored.
+    /// @return <b>True</b> if the room is part of the graph,<br>
+    ///         <b>False</b> otherwise.
+    bool getNode(int area, int vnum, Node & node) const;
+};
+
+/// @brief The outcome of a path request.
+class PathResult
+{
+public:
+    /// The vnum of the starting room.
+    int start;
+    /// If the request has been issued by a mobile.
+    bool mobile;
+    /// The paths, by vnum of the destination. A destination which cannot
+    /// be reached has no entry. Paths leading through a travel point stop
+    /// at the travel point.
+    std::map<int, std::vector<Direction>> paths;
+
+    /// @brief Constructor.
+    PathResult();
+};
+
+/// @brief Resolves the path requests of the scripts by means of a pool of
+///         workers, which search on a snapshot of the rooms.
+/// @details
+/// The requests are issued and collected on the game thread: when the
+/// workers are done the results are moved to the game thread by update(),
+/// which also notifies the mobiles through their EventPathReady. Since the
+/// snapshot ignores doors and the map can change while the search runs,
+/// every step of a path is checked again when the path is collected.
+class PathRequestService
+{
+private:
+    /// @brief A request waiting for a worker.
+    class Job
+    {
+    public:
+        /// The handle of the request.
+        unsigned int handle;
+        /// The snapshot on which the search is performed.
+        std::shared_ptr<const PathGraph> graph;
+        /// The starting room.
+        PathGraph::Node start;
+        /// The vnums of the destinations.
+        std::vector<int> destinations;
+        /// If the request has been issued by a mobile.
+        bool mobile;
+
+        /// @brief Constructor.
+        Job();
+    };
+
+    /// The maximum number of workers.
+    static const unsigned int maxWorkers = 4;
+    /// The maximum number of results kept at the same time.
+    static const size_t maxResults = 1024;
+    /// The workers.
+    std::vector<std::thread> workers;
+    /// Protects the jobs, the completed results and the stop flag.
+    std::mutex queueMutex;
+    /// Signals the workers when a job is available.
+    std::condition_variable queueCondition;
+    /// The requests waiting for a worker.
+    std::deque<Job> jobs;
+    /// The results completed by the workers, not yet collected.
+    std::vector<std::pair<unsigned int, PathResult>> completed;
+    /// If the workers must stop.
+    bool stopping;
+    /// The current snapshot of the rooms.
+    std::shared_ptr<const PathGraph> graph;
+    /// The last assigned handle.
+    unsigned int lastHandle;
+    /// The characters which are waiting for a request, by handle.
+    std::map<unsigned int, Character *> pending;
+    /// The collected results, by handle.
+    std::map<unsigned int, PathResult> results;
+
+    /// @brief Constructor.
+    PathRequestService();
+
+    /// @brief Destructor.
+    ~PathRequestService();
+
+public:
+    /// @brief Disable Copy Construct.
+    PathRequestService(PathRequestService const &) = delete;
+
+    /// @brief Disable Move construct.
+    PathRequestService(PathRequestService &&) = delete;
+
+    /// @brief Disable Copy assign.
+    PathRequestService & operator=(PathRequestService const &) = delete;
+
+    /// @brief Disable Move assign.
+    PathRequestService & operator=(PathRequestService &&) = delete;
+
+    /// @brief Get the singleton istance of the service.
+    /// @return The static and unique service.
+    static PathRequestService & instance();
+
+    /// @brief Requests the paths from the room of the character towards
+    ///         the given destinations.
+    /// @param character    The character who issues the request.
+    /// @param destinations The destinations.
+    /// @return The handle of the request, 0 if the request is not valid.
+    unsigned int request(Character * character,
+                         const std::vector<Room *> & destinations);
+
+    /// @brief Checks if the request has been completed.
+    bool isReady(unsigned int handle) const;
+
+    /// @brief Provides the path towards one of the destinations of a
+    ///         completed request, if all its steps are still valid.
+    /// @param handle      The handle of the request.
+    /// @param destination The destination.
+    /// @param path        Where the path is stored.
+    /// @return <b>True</b> if the destination can be reached,<br>
+    ///         <b>False</b> if it cannot or a step of the path has been
+    ///         blocked in the meanwhile (e.g. by a closed door).
+    bool getPath(unsigned int handle,
+                 Room * destination,
+                 std::vector<Direction> & path) const;
+
+    /// @brief Discards the result of a request.
+    void release(unsigned int handle);
+
+    /// @brief Forgets the requests of a character, it must be called when
+    ///         the character is destroyed.
+    void cancel(Character * character);
+
+    /// @brief Collects the results completed by the workers and notifies
+    ///         the characters, it must be called from the game thread.
+    void update();
+
+    /// @brief Provides the number of requests not yet collected.
+    size_t getNumberOfPending() const;
+
+    /// @brief Provides the number of results kept.
+    size_t getNumberOfResults() const;
+
+private:
+    /// @brief Provides the snapshot of the current rooms, only the areas
+    ///         which have changed are copied again.
+    std::shared_ptr<const PathGraph> getGraph();
+
+    /// @brief The loop of the workers.
+    void work();
+
+    /// @brief Searches the paths of a job.
+    static PathResult search(const Job & job);
+
+    /// @brief Checks the steps of a path on the current rooms.
+    static bool checkPath(const PathResult & result,
+                          const std::vector<Direction> & path);
+};
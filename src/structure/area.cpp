@@ -22,21 +22,39 @@
 
 #include "area.hpp"
 
+#include "hierarchicalPathFinder.hpp"
+#include "areaChunks.hpp"
+#include "flowField.hpp"
 #include "structureUtils.hpp"
+#include "formatter.hpp"
+#include "updater.hpp"
 #include "logger.hpp"
 #include "room.hpp"
 
+#include <functional>
+#include <cstdlib>
+#include <algorithm>
+
 Area::Area() :
     vnum(),
     name(),
     builder(),
     map(),
+    roomIndex(),
     width(),
     height(),
     elevation(),
     tileSet(),
     type(),
-    status()
+    status(),
+    lightMap(this),
+    renderCache(),
+    characterIndex(),
+    chunks(),
+    fovCache(),
+    invalidationSuspended(),
+    fovOutdated(),
+    outdatedPositions()
 {
 }
 
@@ -121,10 +139,21 @@ bool Area::addRoom(Room * room)
 {
     if (this->inBoundaries(room->coord))
     {
+        // Make sure the grid covers the whole area (boundaries are included).
+        map.reserve(width + 1, height + 1, elevation + 1);
         if (map.set(room->coord.x, room->coord.y, room->coord.z, room))
         {
+            // Index the room by its vnum.
+            roomIndex[room->vnum] = room;
             // Set the room area to be this one.
             room->area = this;
+            // The field of views and paths around the room are outdated.
+            this->invalidateRoom(room);
+            // Index the characters which are already inside the room.
+            for (auto character : room->characters)
+            {
+                characterIndex.addCharacter(character, room->coord);
+            }
             return true;
         }
         else
@@ -145,26 +174,43 @@ bool Area::addRoom(Room * room)
 
 bool Area::remRoom(Room * room)
 {
+    // Remove the room from the index only if it is the indexed one.
+    auto it = roomIndex.find(room->vnum);
+    if ((it != roomIndex.end()) && (it->second == room))
+    {
+        roomIndex.erase(it);
+    }
+    // Remove the room from the grid only if it is the one stored there.
+    if (map.get(room->coord.x, room->coord.y, room->coord.z) != room)
+    {
+        return false;
+    }
+    // The tile of a streamed area must not materialize the room again.
+    if (chunks != nullptr)
+    {
+        chunks->forget(room);
+    }
+    // The field of views and paths passing through the room are outdated.
+    this->invalidateRoom(room);
+    // Remove the characters of the room from the index.
+    for (auto character : room->characters)
+    {
+        characterIndex.removeCharacter(character, room->coord);
+    }
     return map.erase(room->coord.x, room->coord.y, room->coord.z);
 }
 
 Room * Area::getRoom(int room_vnum)
 {
-    for (auto it : map)
+    auto it = roomIndex.find(room_vnum);
+    if (it != roomIndex.end())
     {
-        for (auto it2 : it.second)
-        {
-            for (auto it3 : it2.second)
-            {
-                if (it3.second != nullptr)
-                {
-                    if (it3.second->vnum == room_vnum)
-                    {
-                        return it3.second;
-                    }
-                }
-            }
-        }
+        return it->second;
+    }
+    // Check if the room has still to be materialized.
+    if (chunks != nullptr)
+    {
+        return chunks->getRoom(room_vnum);
     }
     return nullptr;
 }
@@ -173,50 +219,71 @@ Room * Area::getRoom(const Coordinates & coordinates)
 {
     if (this->inBoundaries(coordinates))
     {
-        return map.get(coordinates.x, coordinates.y, coordinates.z);
+        auto room = map.get(coordinates.x, coordinates.y, coordinates.z);
+        // Check if the room has still to be materialized.
+        if ((room == nullptr) && (chunks != nullptr))
+        {
+            return chunks->getRoom(coordinates);
+        }
+        return room;
     }
     return nullptr;
 }
 
 std::vector<std::string> Area::drawFov(Room * centerRoom, const int & radius)
 {
-    std::vector<std::string> layers(3);
+    std::vector<std::string> layers;
+    for (auto const & layer : this->renderFov(centerRoom, radius))
+    {
+        layers.emplace_back(layer.toString());
+    }
+    return layers;
+}
+
+std::vector<MapLayer> Area::renderFov(Room * centerRoom, const int & radius)
+{
     if (!this->inBoundaries(centerRoom->coord))
     {
-        return layers;
+        return std::vector<MapLayer>(3);
     }
     // Retrieve the coordinates of the room.
     int origin_x = centerRoom->coord.x;
     int origin_y = centerRoom->coord.y;
-    int origin_z = centerRoom->coord.z;
-    // Evaluate the minimum and maximum value for x and y.
-    int min_x = (origin_x < radius) ? 0 : (origin_x - radius);
-    int max_x = ((origin_x + radius) > this->width)
-                ? this->width : (origin_x + radius);
-    int min_y = (origin_y < radius) ? 0 : (origin_y - radius);
-    int max_y = ((origin_y + radius - 1) > this->height)
-                ? this->height : (origin_y + radius - 1);
-    // Evaluate the field of view.
-    auto coordinatesInFov = this->fov(centerRoom->coord, radius);
-    // Prepare Environment layer.
-    for (int y = max_y; y >= min_y; --y)
-    {
-        for (int x = min_x; x < max_x; ++x)
+    // Retrieve the cached frame.
+    auto & frame = renderCache.getFrame(centerRoom->coord, radius, false);
+    if (!frame.hasLayers)
+    {
+        frame.layers.assign(3, MapLayer());
+        // Evaluate the minimum and maximum value for x and y.
+        int min_x = (origin_x < radius) ? 0 : (origin_x - radius);
+        int max_x = ((origin_x + radius) > this->width)
+                    ? this->width : (origin_x + radius);
+        int min_y = (origin_y < radius) ? 0 : (origin_y - radius);
+        int max_y = ((origin_y + radius - 1) > this->height)
+                    ? this->height : (origin_y + radius - 1);
+        // Remember where the layers are placed, to shift them on the client.
+        for (auto & layer : frame.layers)
+        {
+            layer.left = min_x;
+            layer.top = max_y;
+            layer.columns = std::max(max_x - min_x, 0);
+        }
+        // Evaluate the field of view.
+        auto visible = this->getVisibleRooms(centerRoom->coord, radius);
+        // Prepare Environment layer.
+        for (int y = max_y; y >= min_y; --y)
         {
-            std::string tileCode = " : ";
-            Coordinates coordinates(x, y, origin_z);
-            bool found = false;
-            for (auto it : coordinatesInFov)
+            for (int x = min_x; x < max_x; ++x)
             {
-                if (coordinates == it)
+                std::string tileCode = " : ";
+                std::string separator =
+                    (x != (origin_x + radius - 1)) ? "," : "";
+                auto room = visible.get(x, y);
+                if (room == nullptr)
                 {
-                    found = true;
-                    break;
+                    frame.layers[0].addTile(tileCode, separator);
+                    continue;
                 }
-            }
-            if (found)
-            {
-                auto room = this->getRoom(Coordinates(x, y, origin_z));
                 auto up = room->findExit(Direction::Up);
                 auto down = room->findExit(Direction::Down);
 
@@ -253,35 +320,20 @@ std::vector<std::string> Area::drawFov(Room * centerRoom, const int & radius)
                                    ToString(this->tileSet + 4);
                     }
                 }
+                frame.layers[0].addCell(tileCode, separator, room);
             }
-            layers[0] += tileCode;
-            if (x != (origin_x + radius - 1))
-            {
-                layers[0] += ",";
-            }
+            frame.layers[0].endRow(";");
         }
-        layers[0] += ";";
-    }
 
-    // Prepare Objects layer.
-    for (int y = max_y; y > min_y; --y)
-    {
-        for (int x = min_x; x < max_x; ++x)
+        // Prepare Objects and Living Creatures layers.
+        for (int y = max_y; y > min_y; --y)
         {
-            std::string tileCode = " : ";
-            Coordinates coordinates(x, y, origin_z);
-            bool found = false;
-            for (auto it : coordinatesInFov)
-            {
-                if (coordinates == it)
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (found)
+            for (int x = min_x; x < max_x; ++x)
             {
-                Room * room = this->getRoom(coordinates);
+                std::string tileCode = " : ";
+                std::string separator =
+                    (x != (origin_x + radius - 1)) ? "," : "";
+                auto room = visible.get(x, y);
                 if (room != nullptr)
                 {
                     Item * door = StructUtils::findDoor(room);
@@ -301,61 +353,129 @@ std::vector<std::string> Area::drawFov(Room * centerRoom, const int & radius)
                         }
                     }
                 }
+                frame.layers[1].addTile(tileCode, separator);
+                // The creatures are drawn every time on top of the frame.
+                if ((origin_x == x) && (origin_y == y))
+                {
+                    frame.layers[2].addTile(ToString(1) + ":" + ToString(480),
+                                            separator);
+                }
+                else if (room != nullptr)
+                {
+                    frame.layers[2].addCell(" : ", separator, room);
+                }
+                else
+                {
+                    frame.layers[2].addTile(" : ", separator);
+                }
             }
-            layers[1] += tileCode;
-            if (x != (origin_x + radius - 1))
+            frame.layers[1].endRow(";");
+            frame.layers[2].endRow(";");
+        }
+        frame.hasLayers = true;
+    }
+    auto layers = frame.layers;
+    // Draw the living creatures.
+    for (auto const & cell : layers[2].cells)
+    {
+        for (auto iterator : cell.second->characters)
+        {
+            if (!HasFlag(iterator->flags, CharacterFlag::Invisible))
             {
-                layers[1] += ",";
+                layers[2].tiles[cell.first] = iterator->race->getTile();
+                break;
             }
         }
-        layers[1] += ";";
     }
+    return layers;
+}
 
-    // Prepare Living Creatures layer.
-    for (int y = max_y; y > min_y; --y)
+std::string Area::drawFovUpdate(Room * centerRoom,
+                                const int & radius,
+                                ClientMap & clientMap)
+{
+    auto layers = this->renderFov(centerRoom, radius);
+    std::string output;
+    // Check if the client can just update the map it already has: the
+    // window must have the same shape, and it must overlap the previous one
+    // once it is shifted by the movement.
+    bool update = (clientMap.area == this) &&
+                  (clientMap.radius == radius) &&
+                  (clientMap.layers.size() == layers.size());
+    int shiftX = 0, shiftY = 0;
+    if (update && !layers.empty())
+    {
+        shiftX = layers[0].left - clientMap.layers[0].left;
+        shiftY = clientMap.layers[0].top - layers[0].top;
+    }
+    for (size_t it = 0; update && (it < layers.size()); ++it)
     {
-        for (int x = min_x; x < max_x; ++x)
+        auto const & previous = clientMap.layers[it];
+        auto const & current = layers[it];
+        update = (current.columns > 0) &&
+                 (previous.columns == current.columns) &&
+                 (previous.tiles.size() == current.tiles.size()) &&
+                 ((current.tiles.size() %
+                   static_cast<size_t>(current.columns)) == 0) &&
+                 (std::abs(shiftX) < current.columns) &&
+                 (static_cast<size_t>(std::abs(shiftY)) <
+                  (current.tiles.size() /
+                   static_cast<size_t>(current.columns)));
+    }
+    if (update)
+    {
+        // The client first shifts the tiles it shows by the movement, as
+        // S,x,y; then only the tiles which have changed are sent, as
+        // layer,index,tile.
+        std::string changes;
+        if ((shiftX != 0) || (shiftY != 0))
         {
-            std::string tileCode = " : ";
-            Coordinates coordinates(x, y, origin_z);
-            bool found = false;
-            for (auto it : coordinatesInFov)
-            {
-                if (coordinates == it)
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if ((origin_x == x) && (origin_y == y))
-            {
-                tileCode = ToString(1) + ":" + ToString(480);
-            }
-            else if (found)
+            changes += "S," + ToString(shiftX) + "," + ToString(shiftY) + ";";
+        }
+        for (size_t layer = 0; layer < layers.size(); ++layer)
+        {
+            auto const & previous = clientMap.layers[layer].tiles;
+            auto const & current = layers[layer].tiles;
+            auto columns = layers[layer].columns;
+            auto rows = static_cast<int>(current.size()) / columns;
+            for (size_t it = 0; it < current.size(); ++it)
             {
-                Room * room = this->getRoom(Coordinates(x, y, origin_z));
-                // Check if there are creatures in the tile.
-                if (!room->characters.empty())
+                // Find the tile which the client has moved here.
+                auto column = static_cast<int>(it) % columns + shiftX;
+                auto row = static_cast<int>(it) / columns + shiftY;
+                if ((column < 0) || (column >= columns) ||
+                    (row < 0) || (row >= rows) ||
+                    (previous[static_cast<size_t>(row * columns + column)] !=
+                     current[it]))
                 {
-                    for (auto iterator : room->characters)
-                    {
-                        if (!HasFlag(iterator->flags, CharacterFlag::Invisible))
-                        {
-                            tileCode = iterator->race->getTile();
-                            break;
-                        }
-                    }
+                    changes += ToString(layer) + "," + ToString(it) + ",";
+                    changes += current[it] + ";";
                 }
             }
-            layers[2] += tileCode;
-            if (x != (origin_x + radius - 1))
-            {
-                layers[2] += ",";
-            }
         }
-        layers[2] += ";";
+        if (!changes.empty())
+        {
+            output += Formatter::doUpdateMap();
+            output += changes;
+            output += Formatter::dontUpdateMap();
+        }
     }
-    return layers;
+    else
+    {
+        output += Formatter::doClearMap();
+        for (auto const & layer : layers)
+        {
+            output += Formatter::doDrawMap();
+            output += layer.toString();
+            output += Formatter::dontDrawMap();
+        }
+    }
+    // Remember what the client is showing.
+    clientMap.area = this;
+    clientMap.origin = centerRoom->coord;
+    clientMap.radius = radius;
+    clientMap.layers = std::move(layers);
+    return output;
 }
 
 std::string Area::drawASCIIFov(Room * centerRoom, const int & radius)
@@ -364,120 +484,136 @@ std::string Area::drawASCIIFov(Room * centerRoom, const int & radius)
     {
         return "";
     }
-    std::string result;
-    result.reserve(static_cast<size_t >(radius * radius));
-    // Evaluate the minimum and maximum value for x and y.
-    int min_x = (centerRoom->coord.x - radius);
-    int max_x = (centerRoom->coord.x + radius);
-    int min_y = (centerRoom->coord.y - radius);
-    int max_y = (centerRoom->coord.y + radius);
-    // Evaluate the field of view.
-    auto view = this->fov(centerRoom->coord, radius);
-    // Draw the fov.
-    Coordinates point = centerRoom->coord;
-    for (point.y = max_y; point.y >= min_y; --point.y)
-    {
-        for (point.x = min_x; point.x <= max_x; ++point.x)
+    // Retrieve the cached frame.
+    auto night = (MudUpdater::instance().getDayPhase() == DayPhase::Night);
+    auto & frame = renderCache.getFrame(centerRoom->coord, radius, night);
+    if (!frame.hasAscii)
+    {
+        // Evaluate the minimum and maximum value for x and y.
+        int min_x = (centerRoom->coord.x - radius);
+        int max_x = (centerRoom->coord.x + radius);
+        int min_y = (centerRoom->coord.y - radius);
+        int max_y = (centerRoom->coord.y + radius);
+        // Evaluate the field of view.
+        auto visible = this->getVisibleRooms(centerRoom->coord, radius);
+        // Draw the fov.
+        for (int y = max_y; y >= min_y; --y)
         {
-            if (std::find(view.begin(), view.end(), point) == view.end())
-            {
-                result += ' ';
-                continue;
-            }
-            Room * room = this->getRoom(point);
-            if (room == nullptr)
-            {
-                result += ' ';
-                continue;
-            }
-            if (!room->isLit())
-            {
-                result += ' ';
-                continue;
-            }
-            std::string tile;
-            auto up = room->findExit(Direction::Up);
-            auto down = room->findExit(Direction::Down);
-            // VI  - WALKABLE
-            if (room->liquidContent.first != nullptr)
-            {
-                tile = 'w';
-            }
-            else if (HasFlag(room->flags, RoomFlags::SpawnTree))
-            {
-                tile = 't';
-            }
-            else
-            {
-                tile = room->terrain->symbol;
-            }
-            // V   - OPEN DOOR
-            auto door = StructUtils::findDoor(room);
-            if (door != nullptr)
+            for (int x = min_x; x <= max_x; ++x)
             {
-                if (HasFlag(door->flags, ItemFlag::Closed))
+                Room * room = visible.get(x, y);
+                if (room == nullptr)
                 {
-                    tile = 'D';
+                    frame.ascii.addTile(" ", "");
+                    continue;
                 }
-                else
+                if (!room->isLit())
                 {
-                    tile = 'O';
+                    frame.ascii.addTile(" ", "");
+                    continue;
                 }
-            }
-            // IV  - STAIRS
-            if ((up != nullptr) && (down != nullptr))
-            {
-                if (HasFlag(up->flags, ExitFlag::Stairs)
-                    && HasFlag(down->flags, ExitFlag::Stairs))
+                std::string tile;
+                auto up = room->findExit(Direction::Up);
+                auto down = room->findExit(Direction::Down);
+                // VI  - WALKABLE
+                if (room->liquidContent.first != nullptr)
                 {
-                    tile = 'X';
+                    tile = 'w';
                 }
-            }
-            else if (up != nullptr)
-            {
-                if (HasFlag(up->flags, ExitFlag::Stairs))
+                else if (HasFlag(room->flags, RoomFlags::SpawnTree))
                 {
-                    tile = '>';
+                    tile = 't';
                 }
-            }
-            else if (down != nullptr)
-            {
-                if (HasFlag(down->flags, ExitFlag::Stairs))
+                else
                 {
-                    tile = '<';
+                    tile = room->terrain->symbol;
                 }
-                else
+                // V   - OPEN DOOR
+                auto door = StructUtils::findDoor(room);
+                if (door != nullptr)
                 {
-                    tile = ' ';
+                    if (HasFlag(door->flags, ItemFlag::Closed))
+                    {
+                        tile = 'D';
+                    }
+                    else
+                    {
+                        tile = 'O';
+                    }
                 }
-            }
-            // III - ITEMS
-            if (room->items.size() > 0)
-            {
-                tile = room->items.back()->model->getTile();
-            }
-            // II  - CHARACTERS
-            if (room->characters.size() > 0)
-            {
-                for (auto iterator : room->characters)
+                // IV  - STAIRS
+                if ((up != nullptr) && (down != nullptr))
+                {
+                    if (HasFlag(up->flags, ExitFlag::Stairs)
+                        && HasFlag(down->flags, ExitFlag::Stairs))
+                    {
+                        tile = 'X';
+                    }
+                }
+                else if (up != nullptr)
+                {
+                    if (HasFlag(up->flags, ExitFlag::Stairs))
+                    {
+                        tile = '>';
+                    }
+                }
+                else if (down != nullptr)
                 {
-                    if (!HasFlag(iterator->flags,
-                                 CharacterFlag::Invisible))
+                    if (HasFlag(down->flags, ExitFlag::Stairs))
+                    {
+                        tile = '<';
+                    }
+                    else
                     {
-                        tile = iterator->race->getTile();
+                        tile = ' ';
                     }
                 }
+                // III - ITEMS
+                if (room->items.size() > 0)
+                {
+                    tile = room->items.back()->model->getTile();
+                }
+                frame.ascii.addCell(tile, "", room);
             }
-            // I   - PLAYER
-            if (centerRoom->coord == point)
+            frame.ascii.endRow("\n");
+        }
+        frame.hasAscii = true;
+    }
+    // The characters are drawn every time on top of the frame.
+    auto tiles = frame.ascii.tiles;
+    for (auto const & cell : frame.ascii.cells)
+    {
+        // I   - PLAYER
+        if (cell.second == centerRoom)
+        {
+            tiles[cell.first] = '@';
+            continue;
+        }
+        // II  - CHARACTERS
+        for (auto iterator : cell.second->characters)
+        {
+            if (!HasFlag(iterator->flags, CharacterFlag::Invisible))
             {
-                tile = '@';
+                tiles[cell.first] = iterator->race->getTile();
             }
-            result += tile;
         }
-        result += '\n';
     }
-    return result;
+    return frame.ascii.toString(tiles);
+}
+
+Map2D<Room *> Area::getVisibleRooms(const Coordinates & origin,
+                                    const int & radius)
+{
+    Map2D<Room *> visible;
+    for (auto const & coordinates : this->fov(origin, radius))
+    {
+        auto room = this->getRoom(coordinates);
+        if (room != nullptr)
+        {
+            visible.set(coordinates, room);
+        }
+    }
+    return visible;
 }
 
 CharacterVector Area::getCharactersInSight(CharacterVector & exceptions,
@@ -485,11 +621,38 @@ CharacterVector Area::getCharactersInSight(CharacterVector & exceptions,
                                            const int & radius)
 {
     CharacterVector characterContainer;
-    auto validCoordinates = this->fov(origin, radius);
-    for (auto coordinates : validCoordinates)
+    // Retrieve the characters which are near the origin.
+    auto candidates = characterIndex.getCharactersNear(origin, radius);
+    candidates.erase(
+        std::remove_if(candidates.begin(), candidates.end(),
+                       [&exceptions](Character * character)
+                       {
+                           return std::find(exceptions.begin(),
+                                            exceptions.end(),
+                                            character) != exceptions.end();
+                       }), candidates.end());
+    if (candidates.empty())
+    {
+        return characterContainer;
+    }
+    // Mark the cells inside the field of view.
+    auto side = 2 * radius + 1;
+    std::vector<bool> visible(static_cast<size_t>(side * side), false);
+    for (auto const & coordinates : this->fov(origin, radius))
     {
-        characterContainer.addUnique(
-            this->getCharactersAt(exceptions, coordinates));
+        auto x = coordinates.x - origin.x + radius;
+        auto y = coordinates.y - origin.y + radius;
+        visible[static_cast<size_t>(y * side + x)] = true;
+    }
+    // Keep only the characters which are inside the field of view.
+    for (auto character : candidates)
+    {
+        auto x = character->room->coord.x - origin.x + radius;
+        auto y = character->room->coord.y - origin.y + radius;
+        if (visible[static_cast<size_t>(y * side + x)])
+        {
+            characterContainer.emplace_back(character);
+        }
     }
     return characterContainer;
 }
@@ -510,65 +673,186 @@ ItemVector Area::getItemsInSight(ItemVector & exceptions,
     return foundItems;
 }
 
-std::vector<Coordinates> Area::fov(Coordinates & origin, const int & radius)
+std::vector<Coordinates> Area::fov(const Coordinates & origin,
+                                   const int & radius)
+{
+    // Materialize the rooms which could be inside the field of view.
+    if (chunks != nullptr)
+    {
+        chunks->loadAround(origin, radius);
+    }
+    // Check if the field of view has already been computed.
+    auto key = std::make_tuple(origin.x, origin.y, origin.z, radius);
+    auto it = fovCache.find(key);
+    if (it != fovCache.end())
+    {
+        return it->second;
+    }
+    // Keep the size of the cache under control.
+    if (fovCache.size() >= fovCacheSize)
+    {
+        fovCache.clear();
+    }
+    auto result = this->computeFov(origin, radius);
+    fovCache.insert(std::make_pair(key, result));
+    return result;
+}
+
+void Area::invalidateFov()
+{
+    if (invalidationSuspended > 0)
+    {
+        fovOutdated = true;
+        return;
+    }
+    fovCache.clear();
+    lightMap.invalidate();
+    renderCache.invalidate();
+    FlowFieldService::instance().invalidate(this);
+}
+
+void Area::invalidateRoom(Room * room)
+{
+    this->invalidateFov();
+    if (invalidationSuspended > 0)
+    {
+        outdatedPositions.emplace_back(room->coord);
+        return;
+    }
+    HierarchicalPathFinder::instance().invalidate(this, room->coord);
+}
+
+void Area::suspendInvalidation()
+{
+    ++invalidationSuspended;
+}
+
+void Area::resumeInvalidation()
+{
+    if ((invalidationSuspended == 0) || (--invalidationSuspended > 0))
+    {
+        return;
+    }
+    if (fovOutdated)
+    {
+        fovOutdated = false;
+        this->invalidateFov();
+    }
+    for (auto const & coordinates : outdatedPositions)
+    {
+        HierarchicalPathFinder::instance().invalidate(this, coordinates);
+    }
+    outdatedPositions.clear();
+}
+
+std::vector<Coordinates> Area::computeFov(const Coordinates & origin,
+                                          const int & radius)
 {
     std::vector<Coordinates> cfov;
-    auto CheckCoordinates = [&](const Coordinates & coordinates)
+    if (radius < 0)
+    {
+        return cfov;
+    }
+    // The origin is always visible.
+    cfov.emplace_back(origin);
+    // Keep track of the cells which have already been added, since the
+    // octants share their borders.
+    auto side = static_cast<size_t>(2 * radius + 1);
+    std::vector<bool> visited(side * side, false);
+    auto Visit = [&](const int & dx, const int & dy)
     {
-        if (std::find(cfov.begin(), cfov.end(), coordinates) == cfov.end())
+        auto index = static_cast<size_t>(dy + radius) * side +
+                     static_cast<size_t>(dx + radius);
+        if (visited[index])
         {
-            if (origin == coordinates)
+            return;
+        }
+        visited[index] = true;
+        cfov.emplace_back(Coordinates(origin.x + dx, origin.y + dy, origin.z));
+    };
+    visited[static_cast<size_t>(radius) * side +
+            static_cast<size_t>(radius)] = true;
+    // Opaque cells are the ones which are not valid (no room, closed door).
+    auto IsOpaque = [&](const int & dx, const int & dy)
+    {
+        return !this->isValid(
+            Coordinates(origin.x + dx, origin.y + dy, origin.z));
+    };
+    auto radiusSquared = radius * radius;
+    // Scan a single octant, the multipliers transform the octant coordinates
+    // into the real ones.
+    std::function<void(int, double, double, int, int, int, int)> CastLight;
+    CastLight = [&](int row, double start, double end,
+                    int xx, int xy, int yx, int yy)
+    {
+        if (start < end)
+        {
+            return;
+        }
+        double newStart = 0.0;
+        for (int j = row; j <= radius; ++j)
+        {
+            bool blocked = false;
+            for (int dx = -j, dy = -j; dx <= 0; ++dx)
             {
-                cfov.emplace_back(coordinates);
+                // Evaluate the real offsets from the origin.
+                int x = dx * xx + dy * xy;
+                int y = dx * yx + dy * yy;
+                // Evaluate the slopes of the borders of the cell.
+                double leftSlope = (dx - 0.5) / (dy + 0.5);
+                double rightSlope = (dx + 0.5) / (dy - 0.5);
+                if (start < rightSlope)
+                {
+                    continue;
+                }
+                if (end > leftSlope)
+                {
+                    break;
+                }
+                bool opaque = IsOpaque(x, y);
+                // Only the valid cells inside the radius are visible.
+                if (!opaque && ((dx * dx + dy * dy) <= radiusSquared))
+                {
+                    Visit(x, y);
+                }
+                if (blocked)
+                {
+                    if (opaque)
+                    {
+                        newStart = rightSlope;
+                    }
+                    else
+                    {
+                        blocked = false;
+                        start = newStart;
+                    }
+                }
+                else if (opaque && (j < radius))
+                {
+                    // Scan the next row, up to the beginning of the shadow.
+                    blocked = true;
+                    CastLight(j + 1, start, leftSlope, xx, xy, yx, yy);
+                    newStart = rightSlope;
+                }
             }
-            else if (this->los(origin, coordinates, radius))
+            if (blocked)
             {
-                cfov.emplace_back(coordinates);
+                break;
             }
         }
     };
-    Coordinates point;
-    while (point.x <= radius)
+    // The multipliers of the eight octants.
+    static const int octants[4][8] = {
+        {1, 0, 0, -1, -1, 0, 0, 1},
+        {0, 1, -1, 0, 0, -1, 1, 0},
+        {0, 1, 1, 0, 0, -1, -1, 0},
+        {1, 0, 0, 1, -1, 0, 0, -1}
+    };
+    for (size_t octant = 0; octant < 8; ++octant)
     {
-        while ((point.y <= point.x) && (point.square() <= pow(radius, 2)))
-        {
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x + point.x,
-                                         origin.y + point.y,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x - point.x,
-                                         origin.y + point.y,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x + point.x,
-                                         origin.y - point.y,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x - point.x,
-                                         origin.y - point.y,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x + point.y,
-                                         origin.y + point.x,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x - point.y,
-                                         origin.y + point.x,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x + point.y,
-                                         origin.y - point.x,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            CheckCoordinates(Coordinates(origin.x - point.y,
-                                         origin.y - point.x,
-                                         origin.z + point.z));
-            // ---------------------------------------------------------
-            ++point.y;
-        }
-        ++point.x;
-        point.y = 0;
+        CastLight(1, 1.0, 0.0,
+                  octants[0][octant], octants[1][octant],
+                  octants[2][octant], octants[3][octant]);
     }
     return cfov;
 }
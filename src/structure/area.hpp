@@ -24,14 +24,23 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <memory>
+#include <tuple>
+#include <map>
 
 #include "coordinates.hpp"
 #include "map3D.hpp"
+#include "lightMap.hpp"
+#include "renderCache.hpp"
+#include "characterIndex.hpp"
 #include "map2D.hpp"
 #include "character.hpp"
 
 class Room;
 
+class AreaChunks;
+
 /// Used to determine the type of Zone.
 using AreaType = enum class AreaType_t
 {
@@ -61,6 +70,8 @@ public:
     std::string builder;
     /// The 3D grid of the map.
     Map3D<Room *> map;
+    /// Index of the rooms of the area, by vnum.
+    std::unordered_map<int, Room *> roomIndex;
     /// The width of the area.
     int width;
     /// The height of the area.
@@ -73,6 +84,15 @@ public:
     AreaType type;
     /// The status of the area.
     AreaStatus status;
+    /// The rooms illuminated by the light sources.
+    LightMap lightMap;
+    /// The cache of the maps rendered inside the area.
+    RenderCache renderCache;
+    /// The characters of the area, by position.
+    CharacterIndex characterIndex;
+    /// The tiles from which the rooms are materialized, only for the
+    /// streamed areas.
+    std::unique_ptr<AreaChunks> chunks;
 
     /// Constructor.
     Area();
@@ -125,12 +145,14 @@ public:
     ///         <b>False</b> otherwise.
     bool remRoom(Room * room);
 
-    /// @brief Find a room  given its vnum.
+    /// @brief Find a room  given its vnum, inside a streamed area the room
+    ///         is materialized if necessary.
     /// @param room_vnum The vnum of the room.
     /// @return The desired room.
     Room * getRoom(int room_vnum);
 
-    /// @brief Find a room in a precise spot.
+    /// @brief Find a room in a precise spot, inside a streamed area the
+    ///         room is materialized if necessary.
     /// @param coordinates The coordiantes where search the room.
     /// @return The room at the selected spot.
     Room * getRoom(const Coordinates & coordinates);
@@ -151,6 +173,17 @@ public:
     ///          Field of View of a character.
     std::string drawASCIIFov(Room * centerRoom, const int & radius);
 
+    /// @brief Draw the Field of View for a client, sending only the tiles
+    ///         which have changed since the last map sent to the client.
+    /// @param centerRoom The room from where the algorithm has to
+    ///                     compute the Field of View.
+    /// @param radius     The radius of visibility of the character.
+    /// @param clientMap  The last map sent to the client.
+    /// @return The commands which draw or update the map of the client.
+    std::string drawFovUpdate(Room * centerRoom,
+                              const int & radius,
+                              ClientMap & clientMap);
+
     /// @brief Provides a list of characters which are in sight.
     /// @param exceptions A list of exceptions.
     /// @param origin The coordinate of the central room.
@@ -171,10 +204,34 @@ public:
 
     /// @brief A Field of View algorithm which provides all the rooms
     ///         which are inside the radius of the field of view.
+    /// @details It uses recursive shadowcasting on the plane of the origin,
+    ///           results are cached until the area changes. Inside a
+    ///           streamed area, the rooms within the radius are
+    ///           materialized first.
     /// @param origin The coordinate of the central room.
     /// @param radius The radius of visibility of the character.
     /// @return A vector containing all the coordinates of valid rooms.
-    std::vector<Coordinates> fov(Coordinates & origin, const int & radius);
+    std::vector<Coordinates> fov(const Coordinates & origin,
+                                 const int & radius);
+
+    /// @brief Invalidates the cached field of views, maps, flow fields and
+    ///         light map, it must be called every time a room, an exit or
+    ///         a door of the area changes.
+    void invalidateFov();
+
+    /// @brief Invalidates the caches and the paths which pass through the
+    ///         given room, it must be called every time a room or its exits
+    ///         are added or removed.
+    /// @param room The room which has changed.
+    void invalidateRoom(Room * room);
+
+    /// @brief Postpones the invalidations while many rooms are added or
+    ///         removed together, the calls can be nested.
+    void suspendInvalidation();
+
+    /// @brief Performs at once the invalidations postponed since the
+    ///         matching call to suspendInvalidation.
+    void resumeInvalidation();
 
     /// @brief Determine if a coordinate is in sight from a starting one.
     /// @param source The coordinates of the origin.
@@ -185,4 +242,37 @@ public:
     bool los(const Coordinates & source,
              const Coordinates & target,
              const int & radius);
+
+private:
+    /// @brief Renders the layers of the Field of View for a client.
+    /// @param centerRoom The room from where the algorithm has to
+    ///                     compute the Field of View.
+    /// @param radius     The radius of visibility of the character.
+    /// @return The environment, objects and creatures layers.
+    std::vector<MapLayer> renderFov(Room * centerRoom, const int & radius);
+
+    /// @brief Provides the rooms inside the field of view, by position.
+    /// @param origin The coordinate of the central room.
+    /// @param radius The radius of visibility.
+    /// @return The visible rooms.
+    Map2D<Room *> getVisibleRooms(const Coordinates & origin,
+                                  const int & radius);
+
+    /// Maximum number of field of views kept inside the cache.
+    static const size_t fovCacheSize = 4096;
+    /// Cache of the field of views, by origin (x, y, z) and radius.
+    std::map<std::tuple<int, int, int, int>, std::vector<Coordinates>> fovCache;
+    /// The number of pending calls to suspendInvalidation.
+    unsigned int invalidationSuspended;
+    /// If the caches have to be invalidated once resumed.
+    bool fovOutdated;
+    /// The positions whose paths have to be invalidated once resumed.
+    std::vector<Coordinates> outdatedPositions;
+
+    /// @brief Computes the field of view by means of recursive shadowcasting.
+    /// @param origin The coordinate of the central room.
+    /// @param radius The radius of visibility.
+    /// @return A vector containing all the coordinates of valid rooms.
+    std::vector<Coordinates> computeFov(const Coordinates & origin,
+                                        const int & radius);
 };
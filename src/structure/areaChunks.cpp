@@ -0,0 +1,532 @@
+/// @file   areaChunks.cpp
+/// @brief  Materializes the rooms of the streamed areas, chunk by chunk.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "areaChunks.hpp"
+#include "sqliteWriteFunctions.hpp"
+#include "stopwatch.hpp"
+#include "logger.hpp"
+#include "mud.hpp"
+
+#include <algorithm>
+
+/// The number of bytes used to save a tile.
+static const size_t TileBytes = 14;
+
+/// @brief Appends the given number of bytes of a value, little endian first.
+static void WriteBytes(std::string & data, uint32_t value, size_t bytes)
+{
+    for (size_t it = 0; it < bytes; ++it)
+    {
+        data.push_back(static_cast<char>((value >> (8 * it)) & 0xFFU));
+    }
+}
+
+/// @brief Reads the given number of bytes of a value, little endian first.
+static uint32_t ReadBytes(const std::string & data,
+                          size_t & position,
+                          size_t bytes)
+{
+    uint32_t value = 0;
+    for (size_t it = 0; it < bytes; ++it)
+    {
+        auto byte = static_cast<unsigned char>(data[position++]);
+        value |= static_cast<uint32_t>(byte) << (8 * it);
+    }
+    return value;
+}
+
+MapTile::MapTile() :
+    terrain(),
+    z(),
+    liquid(),
+    flags(),
+    quantity()
+{
+    // Nothing to do.
+}
+
+AreaChunks::AreaChunks(Area * _area,
+                       int _firstVnum,
+                       int _width,
+                       int _height,
+                       int _radius) :
+    area(_area),
+    firstVnum(_firstVnum),
+    width(std::max(_width, 0)),
+    height(std::max(_height, 0)),
+    radius(std::max(_radius, 0)),
+    tiles(static_cast<size_t>(width) * static_cast<size_t>(height)),
+    chunks(),
+    transient(),
+    dirty(),
+    evicting(),
+    lastEviction(std::chrono::steady_clock::now())
+{
+    // Nothing to do.
+}
+
+AreaChunks::~AreaChunks()
+{
+    // The rooms are destroyed together with the other rooms of the mud.
+}
+
+int AreaChunks::getFirstVnum() const
+{
+    return firstVnum;
+}
+
+int AreaChunks::getLastVnum() const
+{
+    return firstVnum + static_cast<int>(tiles.size()) - 1;
+}
+
+int AreaChunks::getWidth() const
+{
+    return width;
+}
+
+int AreaChunks::getHeight() const
+{
+    return height;
+}
+
+int AreaChunks::getRadius() const
+{
+    return radius;
+}
+
+size_t AreaChunks::getNumberOfChunks() const
+{
+    auto columns = static_cast<size_t>((width + chunkSize - 1) / chunkSize);
+    auto rows = static_cast<size_t>((height + chunkSize - 1) / chunkSize);
+    return columns * rows;
+}
+
+size_t AreaChunks::getLoadedChunks() const
+{
+    return chunks.size();
+}
+
+size_t AreaChunks::getTransientRooms() const
+{
+    return transient.size();
+}
+
+size_t AreaChunks::getMemoryUsage() const
+{
+    return sizeof(AreaChunks) + tiles.capacity() * sizeof(MapTile);
+}
+
+bool AreaChunks::setTile(int x, int y, const MapTile & tile)
+{
+    if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+    {
+        return false;
+    }
+    tiles[this->getTileIndex(x, y)] = tile;
+    dirty = true;
+    return true;
+}
+
+std::string AreaChunks::getTileData() const
+{
+    std::string data;
+    data.reserve(tiles.size() * TileBytes);
+    for (auto const & tile : tiles)
+    {
+        WriteBytes(data, tile.terrain, 2);
+        WriteBytes(data, static_cast<uint16_t>(tile.z), 2);
+        WriteBytes(data, tile.liquid, 2);
+        WriteBytes(data, tile.flags, 4);
+        WriteBytes(data, tile.quantity, 4);
+    }
+    return data;
+}
+
+bool AreaChunks::setTileData(const std::string & data)
+{
+    if (data.size() != tiles.size() * TileBytes)
+    {
+        Logger::log(LogLevel::Error, "The area %s has %s bytes of tiles "
+            "instead of %s.", area->vnum, data.size(),
+                    tiles.size() * TileBytes);
+        return false;
+    }
+    size_t position = 0;
+    for (auto & tile : tiles)
+    {
+        tile.terrain = static_cast<uint16_t>(ReadBytes(data, position, 2));
+        tile.z = static_cast<int16_t>(ReadBytes(data, position, 2));
+        tile.liquid = static_cast<uint16_t>(ReadBytes(data, position, 2));
+        tile.flags = ReadBytes(data, position, 4);
+        tile.quantity = ReadBytes(data, position, 4);
+    }
+    dirty = false;
+    return true;
+}
+
+bool AreaChunks::contains(int vnum) const
+{
+    return (vnum >= firstVnum) && (vnum <= this->getLastVnum());
+}
+
+bool AreaChunks::isTransient(Room * room) const
+{
+    return transient.find(room) != transient.end();
+}
+
+Room * AreaChunks::getRoom(const Coordinates & coordinates)
+{
+    auto x = coordinates.x, y = coordinates.y;
+    if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+    {
+        return nullptr;
+    }
+    // Check if there is a room at the given elevation.
+    auto const & tile = tiles[this->getTileIndex(x, y)];
+    if ((tile.terrain == 0) || (tile.z != coordinates.z))
+    {
+        return nullptr;
+    }
+    this->loadChunk(x, y);
+    return area->map.get(x, y, coordinates.z);
+}
+
+Room * AreaChunks::getRoom(int vnum)
+{
+    if (!this->contains(vnum) || (width <= 0))
+    {
+        return nullptr;
+    }
+    auto index = vnum - firstVnum;
+    auto x = index % width, y = index / width;
+    if (tiles[static_cast<size_t>(index)].terrain == 0)
+    {
+        return nullptr;
+    }
+    this->loadChunk(x, y);
+    auto it = Mud::instance().mudRooms.find(vnum);
+    return (it == Mud::instance().mudRooms.end()) ? nullptr : it->second;
+}
+
+void AreaChunks::loadAround(const Coordinates & coordinates, int distance)
+{
+    auto now = std::chrono::steady_clock::now();
+    // Evaluate the cells at the corners of the square.
+    auto minX = std::max(coordinates.x - distance, 0);
+    auto maxX = std::min(coordinates.x + distance, width - 1);
+    auto minY = std::max(coordinates.y - distance, 0);
+    auto maxY = std::min(coordinates.y + distance, height - 1);
+    for (auto y = minY - (minY % chunkSize); y <= maxY; y += chunkSize)
+    {
+        for (auto x = minX - (minX % chunkSize); x <= maxX; x += chunkSize)
+        {
+            this->loadChunk(x, y).lastUsed = now;
+        }
+    }
+}
+
+void AreaChunks::update()
+{
+    // Keep the chunks around the characters.
+    for (auto character : area->characterIndex.getCharacters())
+    {
+        this->loadAround(character->room->coord, radius);
+    }
+    // Check if it is time to look for unused chunks.
+    auto now = std::chrono::steady_clock::now();
+    if ((now - lastEviction) < std::chrono::seconds(1))
+    {
+        return;
+    }
+    lastEviction = now;
+    long idle = idleSeconds;
+    std::vector<size_t> unused;
+    for (auto const & chunk : chunks)
+    {
+        if ((now - chunk.second.lastUsed) > std::chrono::seconds(idle))
+        {
+            unused.emplace_back(chunk.first);
+        }
+    }
+    for (auto index : unused)
+    {
+        this->evict(index);
+    }
+}
+
+bool AreaChunks::save()
+{
+    bool result = true;
+    for (auto const & chunk : chunks)
+    {
+        for (auto room : chunk.second.rooms)
+        {
+            if (this->isTransient(room) && this->isModified(room))
+            {
+                result &= this->promote(room);
+            }
+        }
+    }
+    if (dirty)
+    {
+        dirty = !SaveAreaTiles(area);
+        result &= !dirty;
+    }
+    return result;
+}
+
+void AreaChunks::forget(Room * room)
+{
+    if (evicting || !this->contains(room->vnum))
+    {
+        return;
+    }
+    transient.erase(room);
+    auto x = room->coord.x, y = room->coord.y;
+    auto it = chunks.find(this->getChunkIndex(x, y));
+    if (it != chunks.end())
+    {
+        auto & rooms = it->second.rooms;
+        rooms.erase(std::remove(rooms.begin(), rooms.end(), room),
+                    rooms.end());
+    }
+    // The tile is removed, otherwise the room would come back.
+    this->setTile(x, y, MapTile());
+}
+
+AreaChunks::Chunk & AreaChunks::loadChunk(int x, int y)
+{
+    auto index = this->getChunkIndex(x, y);
+    auto it = chunks.find(index);
+    if (it != chunks.end())
+    {
+        return it->second;
+    }
+    Stopwatch<std::chrono::microseconds> stopwatch("LoadChunk");
+    // The caches of the area are invalidated once for the whole chunk.
+    area->suspendInvalidation();
+    auto & chunk = chunks[index];
+    chunk.lastUsed = std::chrono::steady_clock::now();
+    // Evaluate the cells of the chunk.
+    auto minX = x - (x % chunkSize), maxX = std::min(minX + chunkSize, width);
+    auto minY = y - (y % chunkSize), maxY = std::min(minY + chunkSize, height);
+    for (auto cellY = minY; cellY < maxY; ++cellY)
+    {
+        for (auto cellX = minX; cellX < maxX; ++cellX)
+        {
+            auto vnum = firstVnum +
+                        static_cast<int>(this->getTileIndex(cellX, cellY));
+            // The rooms saved on the database are already there.
+            auto saved = Mud::instance().mudRooms.find(vnum);
+            if (saved != Mud::instance().mudRooms.end())
+            {
+                if (saved->second->area != area)
+                {
+                    area->addRoom(saved->second);
+                }
+                chunk.rooms.emplace_back(saved->second);
+                continue;
+            }
+            auto room = this->createRoom(cellX, cellY);
+            if (room != nullptr)
+            {
+                chunk.rooms.emplace_back(room);
+            }
+        }
+    }
+    // Connect the rooms, also with the ones of the nearby chunks.
+    for (auto room : chunk.rooms)
+    {
+        this->linkRoom(room);
+    }
+    area->resumeInvalidation();
+    Logger::log(LogLevel::Debug, "Materialized %s rooms of '%s' in %s us.",
+                chunk.rooms.size(), area->name, stopwatch.stop());
+    return chunk;
+}
+
+Room * AreaChunks::createRoom(int x, int y)
+{
+    auto index = this->getTileIndex(x, y);
+    auto const & tile = tiles[index];
+    if (tile.terrain == 0)
+    {
+        return nullptr;
+    }
+    auto terrain = Mud::instance().findTerrain(tile.terrain);
+    if (terrain == nullptr)
+    {
+        Logger::log(LogLevel::Error, "Can't find the terrain %s.",
+                    tile.terrain);
+        return nullptr;
+    }
+    auto room = new Room();
+    room->vnum = firstVnum + static_cast<int>(index);
+    room->area = area;
+    room->coord = Coordinates(x, y, tile.z);
+    room->terrain = terrain;
+    room->name = terrain->name;
+    room->description = "";
+    room->flags = tile.flags;
+    if (tile.liquid != 0)
+    {
+        room->liquidContent = std::make_pair(
+            Mud::instance().findLiquid(tile.liquid), tile.quantity);
+    }
+    if (!Mud::instance().addRoom(room))
+    {
+        Logger::log(LogLevel::Error, "Cannot add the room to the mud.");
+        room->area = nullptr;
+        delete (room);
+        return nullptr;
+    }
+    if (!area->addRoom(room))
+    {
+        Logger::log(LogLevel::Error, "Cannot add the room to the area.");
+        Mud::instance().remRoom(room);
+        room->area = nullptr;
+        delete (room);
+        return nullptr;
+    }
+    transient.insert(room);
+    return room;
+}
+
+void AreaChunks::linkRoom(Room * room)
+{
+    // The tiles are connected only on their plane.
+    static const std::vector<Direction> directions = {
+        Direction::North, Direction::South, Direction::West, Direction::East
+    };
+    for (auto const & direction : directions)
+    {
+        auto coord = room->coord + direction.getCoordinates();
+        if ((coord.x < 0) || (coord.x >= width) ||
+            (coord.y < 0) || (coord.y >= height))
+        {
+            continue;
+        }
+        // Get the room of the neighbour, if it has been materialized.
+        auto vnum = firstVnum +
+                    static_cast<int>(this->getTileIndex(coord.x, coord.y));
+        auto it = Mud::instance().mudRooms.find(vnum);
+        if ((it == Mud::instance().mudRooms.end()) ||
+            (it->second->area != area))
+        {
+            continue;
+        }
+        auto neighbour = it->second;
+        // Create the two exits.
+        room->addExit(std::make_shared<Exit>(room, neighbour, direction, 0));
+        neighbour->addExit(std::make_shared<Exit>(
+            neighbour, room, direction.getOpposite(), 0));
+    }
+}
+
+bool AreaChunks::isModified(Room * room) const
+{
+    auto const & tile = tiles[static_cast<size_t>(room->vnum - firstVnum)];
+    if (!room->items.empty()) return true;
+    if (room->flags != tile.flags) return true;
+    if (room->terrain == nullptr) return true;
+    if (room->terrain->vnum != tile.terrain) return true;
+    if (room->name != room->terrain->name) return true;
+    if (!room->description.empty()) return true;
+    // Check the liquid.
+    auto liquid = room->liquidContent.first;
+    if (((liquid == nullptr) ? 0 : liquid->vnum) != tile.liquid) return true;
+    if ((liquid != nullptr) && (room->liquidContent.second != tile.quantity))
+    {
+        return true;
+    }
+    // Check if there are exits which are not between tiles.
+    for (auto const & exit : room->exits)
+    {
+        if (exit->flags != 0) return true;
+        if ((exit->direction == Direction::Up) ||
+            (exit->direction == Direction::Down))
+        {
+            return true;
+        }
+        if (!this->contains(exit->destination->vnum)) return true;
+    }
+    return false;
+}
+
+bool AreaChunks::promote(Room * room)
+{
+    if (!SaveRoom(room) || !SaveAreaList(area, room))
+    {
+        Logger::log(LogLevel::Error, "Can't save the room %s of '%s'.",
+                    room->vnum, area->name);
+        return false;
+    }
+    transient.erase(room);
+    return true;
+}
+
+bool AreaChunks::evict(size_t index)
+{
+    auto it = chunks.find(index);
+    if (it == chunks.end())
+    {
+        return false;
+    }
+    auto & chunk = it->second;
+    // Check if there are characters inside the chunk.
+    for (auto room : chunk.rooms)
+    {
+        if (!room->characters.empty())
+        {
+            chunk.lastUsed = std::chrono::steady_clock::now();
+            return false;
+        }
+    }
+    // Save the modified rooms, they are kept.
+    for (auto room : chunk.rooms)
+    {
+        if (this->isTransient(room) && this->isModified(room) &&
+            !this->promote(room))
+        {
+            return false;
+        }
+    }
+    size_t evicted = 0;
+    evicting = true;
+    area->suspendInvalidation();
+    for (auto room : chunk.rooms)
+    {
+        if (transient.erase(room) > 0)
+        {
+            Mud::instance().remRoom(room);
+            delete (room);
+            ++evicted;
+        }
+    }
+    area->resumeInvalidation();
+    evicting = false;
+    chunks.erase(it);
+    Logger::log(LogLevel::Debug, "Evicted %s rooms of '%s'.",
+                evicted, area->name);
+    return true;
+}
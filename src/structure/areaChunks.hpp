@@ -0,0 +1,255 @@
+/// @file   areaChunks.hpp
+/// @brief  Materializes the rooms of the streamed areas, chunk by chunk.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "coordinates.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <string>
+
+class Area;
+
+class Room;
+
+/// @brief The compact description of a cell of a streamed area, from which
+///         the room of the cell is materialized.
+class MapTile
+{
+public:
+    /// The vnum of the terrain, 0 if the cell has no room.
+    uint16_t terrain;
+    /// The elevation of the cell.
+    int16_t z;
+    /// The vnum of the liquid which fills the room, 0 if there is none.
+    uint16_t liquid;
+    /// The flags of the room.
+    uint32_t flags;
+    /// The quantity of liquid inside the room.
+    uint32_t quantity;
+
+    /// @brief Constructor.
+    MapTile();
+};
+
+/// @brief Materializes the rooms of a streamed area, chunk by chunk.
+/// @details
+/// The cells of a very large generated area are kept as compact tiles, the
+/// rooms and their exits are created only when a character gets within
+/// the radius of the chunk which contains them, and they are destroyed
+/// once the chunk has not been used for a while. The rooms which have been
+/// modified (items, flags, description, exits) are saved on the database
+/// and kept, like the rooms of the normal areas.
+/// The room of the tile at (x, y) has vnum firstVnum + (y * width + x).
+class AreaChunks
+{
+private:
+    /// The side of a chunk, in cells.
+    static const int chunkSize = 16;
+    /// The seconds after which an unused chunk is evicted.
+    static const long idleSeconds = 30;
+
+    /// @brief A materialized chunk.
+    class Chunk
+    {
+    public:
+        /// The rooms of the chunk.
+        std::vector<Room *> rooms;
+        /// The last time the chunk has been used.
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    /// The area.
+    Area * area;
+    /// The vnum of the room of the first tile.
+    int firstVnum;
+    /// The width of the tiles.
+    int width;
+    /// The height of the tiles.
+    int height;
+    /// The distance from the characters within which the rooms are
+    /// materialized.
+    int radius;
+    /// The tiles, row by row.
+    std::vector<MapTile> tiles;
+    /// The materialized chunks, by index.
+    std::unordered_map<size_t, Chunk> chunks;
+    /// The materialized rooms which are not saved on the database.
+    std::unordered_set<Room *> transient;
+    /// If the tiles have changed since they have been saved.
+    bool dirty;
+    /// If a chunk is being evicted.
+    bool evicting;
+    /// The last time the unused chunks have been evicted.
+    std::chrono::steady_clock::time_point lastEviction;
+
+public:
+    /// @brief Constructor.
+    /// @param _area      The area.
+    /// @param _firstVnum The vnum of the room of the first tile.
+    /// @param _width     The width of the tiles.
+    /// @param _height    The height of the tiles.
+    /// @param _radius    The distance from the characters within which the
+    ///                    rooms are materialized.
+    AreaChunks(Area * _area,
+               int _firstVnum,
+               int _width,
+               int _height,
+               int _radius);
+
+    /// @brief Destructor.
+    ~AreaChunks();
+
+    /// @brief Disable Copy Construct.
+    AreaChunks(AreaChunks const &) = delete;
+
+    /// @brief Disable Move construct.
+    AreaChunks(AreaChunks &&) = delete;
+
+    /// @brief Disable Copy assign.
+    AreaChunks & operator=(AreaChunks const &) = delete;
+
+    /// @brief Disable Move assign.
+    AreaChunks & operator=(AreaChunks &&) = delete;
+
+    /// @brief Provides the vnum of the room of the first tile.
+    int getFirstVnum() const;
+
+    /// @brief Provides the vnum of the room of the last tile.
+    int getLastVnum() const;
+
+    /// @brief Provides the width of the tiles.
+    int getWidth() const;
+
+    /// @brief Provides the height of the tiles.
+    int getHeight() const;
+
+    /// @brief Provides the distance from the characters within which the
+    ///         rooms are materialized.
+    int getRadius() const;
+
+    /// @brief Provides the number of chunks which cover the tiles.
+    size_t getNumberOfChunks() const;
+
+    /// @brief Provides the number of materialized chunks.
+    size_t getLoadedChunks() const;
+
+    /// @brief Provides the number of materialized rooms which are not saved
+    ///         on the database.
+    size_t getTransientRooms() const;
+
+    /// @brief Provides an estimate of the memory used by the tiles.
+    size_t getMemoryUsage() const;
+
+    /// @brief Sets the tile at the given position.
+    /// @return <b>True</b> if the position is valid,<br>
+    ///         <b>False</b> otherwise.
+    bool setTile(int x, int y, const MapTile & tile);
+
+    /// @brief Provides the tiles encoded as bytes, to be saved.
+    std::string getTileData() const;
+
+    /// @brief Sets the tiles from the bytes provided by getTileData.
+    /// @return <b>True</b> if the bytes describe all the tiles,<br>
+    ///         <b>False</b> otherwise.
+    bool setTileData(const std::string & data);
+
+    /// @brief Checks if the given vnum belongs to a tile.
+    bool contains(int vnum) const;
+
+    /// @brief Checks if the given room has been materialized and it is not
+    ///         saved on the database.
+    bool isTransient(Room * room) const;
+
+    /// @brief Provides the room at the given coordinates, materializing its
+    ///         chunk if necessary.
+    /// @param coordinates The coordinates of the room.
+    /// @return The room, nullptr if there is no tile at the coordinates.
+    Room * getRoom(const Coordinates & coordinates);
+
+    /// @brief Provides the room with the given vnum, materializing its
+    ///         chunk if necessary.
+    /// @param vnum The vnum of the room.
+    /// @return The room, nullptr if the vnum does not belong to a tile.
+    Room * getRoom(int vnum);
+
+    /// @brief Materializes the chunks within the given distance from the
+    ///         coordinates, and keeps them from being evicted.
+    void loadAround(const Coordinates & coordinates, int distance);
+
+    /// @brief Materializes the chunks around the characters of the area and
+    ///         evicts the ones which have not been used for a while.
+    void update();
+
+    /// @brief Saves the modified rooms and the tiles, if they have changed.
+    /// @return <b>True</b> if everything has been saved,<br>
+    ///         <b>False</b> otherwise.
+    bool save();
+
+    /// @brief Forgets a room which is being removed from the area, its tile
+    ///         will not be materialized again.
+    void forget(Room * room);
+
+private:
+    /// @brief Provides the position of the tile of the given cell.
+    inline size_t getTileIndex(int x, int y) const
+    {
+        return static_cast<size_t>(y) * static_cast<size_t>(width) +
+               static_cast<size_t>(x);
+    }
+
+    /// @brief Provides the position of the chunk which contains the cell.
+    inline size_t getChunkIndex(int x, int y) const
+    {
+        auto columns = static_cast<size_t>((width + chunkSize - 1) /
+                                           chunkSize);
+        return static_cast<size_t>(y / chunkSize) * columns +
+               static_cast<size_t>(x / chunkSize);
+    }
+
+    /// @brief Provides the chunk which contains the given cell,
+    ///         materializing it if necessary.
+    Chunk & loadChunk(int x, int y);
+
+    /// @brief Creates the room of the given cell.
+    Room * createRoom(int x, int y);
+
+    /// @brief Creates the exits between a room and its neighbours.
+    void linkRoom(Room * room);
+
+    /// @brief Checks if a room is different from its tile.
+    bool isModified(Room * room) const;
+
+    /// @brief Saves a modified room on the database, from now on it is kept
+    ///         like the rooms of the normal areas.
+    bool promote(Room * room);
+
+    /// @brief Destroys the rooms of a chunk, unless there are characters
+    ///         inside it.
+    /// @return <b>True</b> if the chunk has been evicted,<br>
+    ///         <b>False</b> otherwise.
+    bool evict(size_t index);
+};
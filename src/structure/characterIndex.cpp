@@ -0,0 +1,141 @@
+/// @file   characterIndex.cpp
+/// @brief  Spatial index of the characters inside an area.
+/// @author Enrico Fraccaroli
+/// @date   07 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "characterIndex.hpp"
+
+#include "character.hpp"
+#include "room.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+CharacterIndex::CharacterIndex() :
+    buckets(),
+    size()
+{
+    // Nothing to do.
+}
+
+CharacterIndex::~CharacterIndex()
+{
+    // Nothing to do.
+}
+
+void CharacterIndex::addCharacter(Character * character,
+                                  const Coordinates & coordinates)
+{
+    auto & bucket = buckets[getBucket(coordinates.x,
+                                      coordinates.y,
+                                      coordinates.z)];
+    if (std::find(bucket.begin(), bucket.end(), character) == bucket.end())
+    {
+        bucket.emplace_back(character);
+        ++size;
+    }
+}
+
+bool CharacterIndex::removeCharacter(Character * character,
+                                     const Coordinates & coordinates)
+{
+    auto it = buckets.find(getBucket(coordinates.x,
+                                     coordinates.y,
+                                     coordinates.z));
+    if (it == buckets.end())
+    {
+        return false;
+    }
+    auto & bucket = it->second;
+    auto position = std::find(bucket.begin(), bucket.end(), character);
+    if (position == bucket.end())
+    {
+        return false;
+    }
+    bucket.erase(position);
+    --size;
+    // Do not keep empty buckets around.
+    if (bucket.empty())
+    {
+        buckets.erase(it);
+    }
+    return true;
+}
+
+std::vector<Character *> CharacterIndex::getCharactersNear(
+    const Coordinates & origin,
+    const int & radius) const
+{
+    std::vector<Character *> result;
+    if (buckets.empty() || (radius < 0))
+    {
+        return result;
+    }
+    auto first = getBucket(origin.x - radius, origin.y - radius, origin.z);
+    auto last = getBucket(origin.x + radius, origin.y + radius, origin.z);
+    for (auto x = std::get<0>(first); x <= std::get<0>(last); ++x)
+    {
+        for (auto y = std::get<1>(first); y <= std::get<1>(last); ++y)
+        {
+            auto it = buckets.find(std::make_tuple(x, y, origin.z));
+            if (it == buckets.end())
+            {
+                continue;
+            }
+            for (auto character : it->second)
+            {
+                // Check if the character is inside the square.
+                auto const & coord = character->room->coord;
+                if ((std::abs(coord.x - origin.x) <= radius) &&
+                    (std::abs(coord.y - origin.y) <= radius))
+                {
+                    result.emplace_back(character);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<Character *> CharacterIndex::getCharacters() const
+{
+    std::vector<Character *> result;
+    result.reserve(size);
+    for (auto const & bucket : buckets)
+    {
+        result.insert(result.end(), bucket.second.begin(),
+                      bucket.second.end());
+    }
+    return result;
+}
+
+size_t CharacterIndex::getSize() const
+{
+    return size;
+}
+
+std::tuple<int, int, int> CharacterIndex::getBucket(const int & x,
+                                                    const int & y,
+                                                    const int & z)
+{
+    return std::make_tuple((x < 0) ? -1 : (x / bucketSize),
+                           (y < 0) ? -1 : (y / bucketSize),
+                           z);
+}
@@ -0,0 +1,91 @@
+/// @file   characterIndex.hpp
+/// @brief  Spatial index of the characters inside an area.
+/// @author Enrico Fraccaroli
+/// @date   07 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <tuple>
+#include <map>
+
+#include "coordinates.hpp"
+
+class Character;
+
+/// @brief Keeps the characters of an area inside buckets, by position, so
+///         that range queries only visit the buckets around the origin.
+class CharacterIndex
+{
+private:
+    /// The size of the side of a bucket.
+    static const int bucketSize = 8;
+    /// The characters, by bucket.
+    std::map<std::tuple<int, int, int>, std::vector<Character *>> buckets;
+    /// The number of indexed characters.
+    size_t size;
+
+public:
+    /// @brief Constructor.
+    CharacterIndex();
+
+    /// @brief Destructor.
+    ~CharacterIndex();
+
+    /// @brief Disable Copy Construct.
+    CharacterIndex(CharacterIndex const &) = delete;
+
+    /// @brief Disable Copy assign.
+    CharacterIndex & operator=(CharacterIndex const &) = delete;
+
+    /// @brief Adds a character to the index.
+    /// @param character   The character.
+    /// @param coordinates The position of the character.
+    void addCharacter(Character * character, const Coordinates & coordinates);
+
+    /// @brief Removes a character from the index.
+    /// @param character   The character.
+    /// @param coordinates The position of the character.
+    /// @return <b>True</b> if the character has been removed,<br>
+    ///         <b>False</b> otherwise.
+    bool removeCharacter(Character * character,
+                         const Coordinates & coordinates);
+
+    /// @brief Provides the characters inside the buckets which cover the
+    ///         square of the given radius, on the plane of the origin.
+    /// @param origin The center of the square.
+    /// @param radius The radius of the square.
+    /// @return The characters which are within the square.
+    std::vector<Character *> getCharactersNear(const Coordinates & origin,
+                                               const int & radius) const;
+
+    /// @brief Provides all the indexed characters.
+    std::vector<Character *> getCharacters() const;
+
+    /// @brief Provides the number of indexed characters.
+    size_t getSize() const;
+
+private:
+    /// @brief Provides the key of the bucket which contains the coordinates.
+    static std::tuple<int, int, int> getBucket(const int & x,
+                                               const int & y,
+                                               const int & z);
+};
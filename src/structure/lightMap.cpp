@@ -0,0 +1,168 @@
+/// @file   lightMap.cpp
+/// @brief  Keeps track of the rooms illuminated by light sources.
+/// @author Enrico Fraccaroli
+/// @date   05 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "lightMap.hpp"
+
+#include "structureUtils.hpp"
+#include "lightModel.hpp"
+#include "lightItem.hpp"
+#include "area.hpp"
+#include "room.hpp"
+
+LightMap::LightMap(Area * _area) :
+    area(_area),
+    sources(),
+    illumination(),
+    dirty()
+{
+    // Nothing to do.
+}
+
+LightMap::~LightMap()
+{
+    // Nothing to do.
+}
+
+void LightMap::addSource(LightItem * light)
+{
+    auto it = sources.find(light);
+    if (it == sources.end())
+    {
+        it = sources.insert(std::make_pair(light, std::vector<Room *>())).first;
+    }
+    else if (!dirty)
+    {
+        this->removeContribution(it->second);
+    }
+    if (dirty)
+    {
+        // The contribution will be computed during the next rebuild.
+        it->second.clear();
+        return;
+    }
+    it->second = this->computeContribution(light);
+    this->addContribution(it->second);
+}
+
+void LightMap::removeSource(LightItem * light)
+{
+    auto it = sources.find(light);
+    if (it == sources.end())
+    {
+        return;
+    }
+    if (!dirty)
+    {
+        this->removeContribution(it->second);
+    }
+    sources.erase(it);
+}
+
+void LightMap::invalidate()
+{
+    dirty = true;
+}
+
+bool LightMap::isLit(Room * room)
+{
+    if (dirty)
+    {
+        this->rebuild();
+    }
+    return illumination.find(room) != illumination.end();
+}
+
+size_t LightMap::getNumberOfSources() const
+{
+    return sources.size();
+}
+
+std::vector<Room *> LightMap::computeContribution(LightItem * light)
+{
+    std::vector<Room *> rooms;
+    // Get the room from which the light is shining.
+    auto source = light->getLightRoom();
+    if ((source == nullptr) || (source->area != area))
+    {
+        return rooms;
+    }
+    auto radius = light->model->toLight()->radius;
+    if (radius > maxRadius)
+    {
+        radius = maxRadius;
+    }
+    for (auto const & coordinates : area->fov(source->coord, radius))
+    {
+        if (StructUtils::getDistance(source->coord, coordinates) > radius)
+        {
+            continue;
+        }
+        auto room = area->getRoom(coordinates);
+        if (room != nullptr)
+        {
+            rooms.emplace_back(room);
+        }
+    }
+    return rooms;
+}
+
+void LightMap::addContribution(const std::vector<Room *> & rooms)
+{
+    for (auto room : rooms)
+    {
+        // The room has just been lit.
+        if (++illumination[room] == 1)
+        {
+            area->renderCache.touch(room->coord);
+        }
+    }
+}
+
+void LightMap::removeContribution(const std::vector<Room *> & rooms)
+{
+    for (auto room : rooms)
+    {
+        auto it = illumination.find(room);
+        if (it == illumination.end())
+        {
+            continue;
+        }
+        if (--it->second == 0)
+        {
+            illumination.erase(it);
+            area->renderCache.touch(room->coord);
+        }
+    }
+}
+
+void LightMap::rebuild()
+{
+    // The stored contributions may refer to rooms which do not exist
+    // anymore, thus they are just discarded.
+    illumination.clear();
+    dirty = false;
+    for (auto & it : sources)
+    {
+        it.second = this->computeContribution(it.first);
+        this->addContribution(it.second);
+    }
+}
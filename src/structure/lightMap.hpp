@@ -0,0 +1,103 @@
+/// @file   lightMap.hpp
+/// @brief  Keeps track of the rooms illuminated by light sources.
+/// @author Enrico Fraccaroli
+/// @date   05 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <unordered_map>
+#include <cstddef>
+#include <vector>
+#include <map>
+
+class Area;
+
+class Room;
+
+class LightItem;
+
+/// @brief The illumination grid of an area.
+/// @details
+/// Each active light source adds a contribution to the rooms inside its
+/// radius, the contributions are updated when the light source changes
+/// (i.e. it is kindled, extinguished or moved). When the area itself
+/// changes (rooms, exits, doors), the whole map is rebuilt lazily.
+class LightMap
+{
+private:
+    /// The maximum distance at which a light source can illuminate a room.
+    static const int maxRadius = 10;
+    /// The area.
+    Area * area;
+    /// The light sources and the rooms they illuminate.
+    std::map<LightItem *, std::vector<Room *>> sources;
+    /// The number of light sources illuminating each room.
+    std::unordered_map<Room *, unsigned int> illumination;
+    /// If the contributions must be recomputed.
+    bool dirty;
+
+public:
+    /// @brief Constructor.
+    /// @param _area The area.
+    explicit LightMap(Area * _area);
+
+    /// @brief Destructor.
+    ~LightMap();
+
+    /// @brief Disable Copy Construct.
+    LightMap(LightMap const &) = delete;
+
+    /// @brief Disable Copy assign.
+    LightMap & operator=(LightMap const &) = delete;
+
+    /// @brief Adds (or updates) the contribution of the given light source.
+    /// @param light The light source.
+    void addSource(LightItem * light);
+
+    /// @brief Removes the contribution of the given light source.
+    /// @param light The light source.
+    void removeSource(LightItem * light);
+
+    /// @brief Requires the contributions to be recomputed, because the
+    ///         area has changed.
+    void invalidate();
+
+    /// @brief Checks if the given room is illuminated by a light source.
+    /// @param room The room to check.
+    /// @return <b>True</b> if the room is illuminated,<br>
+    ///         <b>False</b> otherwise.
+    bool isLit(Room * room);
+
+    /// @brief Provides the number of light sources.
+    size_t getNumberOfSources() const;
+
+private:
+    /// @brief Computes the rooms illuminated by the given light.
+    std::vector<Room *> computeContribution(LightItem * light);
+
+    /// @brief Adds the given contribution to the grid.
+    void addContribution(const std::vector<Room *> & rooms);
+
+    /// @brief Removes the given contribution from the grid.
+    void removeContribution(const std::vector<Room *> & rooms);
+
+    /// @brief Recomputes all the contributions.
+    void rebuild();
+};
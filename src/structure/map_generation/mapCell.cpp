@@ -30,17 +30,32 @@ MapCell::MapCell() :
     flags(),
     liquidContent()
 {
-    // Nothing to do.
+    neighbours.fill(nullptr);
 }
 
 bool MapCell::addNeighbour(const Direction & direction,
                            MapCell * mapCell)
 {
-    if (mapCell == nullptr)
+    if ((mapCell == nullptr) || (direction == Direction::None))
     {
         return false;
     }
-    return neighbours.insert(std::make_pair(direction, mapCell)).second;
+    auto & neighbour = neighbours[getNeighbourIndex(direction)];
+    if (neighbour != nullptr)
+    {
+        return false;
+    }
+    neighbour = mapCell;
+    return true;
+}
+
+MapCell * MapCell::getNeighbour(const Direction & direction) const
+{
+    if (direction == Direction::None)
+    {
+        return nullptr;
+    }
+    return neighbours[getNeighbourIndex(direction)];
 }
 
 MapCell * MapCell::findLowestNearbyCell()
@@ -48,9 +63,10 @@ MapCell * MapCell::findLowestNearbyCell()
     MapCell * selectedCell = this;
     for (auto neighbour : neighbours)
     {
-        if (neighbour.second->coordinates.z < selectedCell->coordinates.z)
+        if ((neighbour != nullptr) &&
+            (neighbour->coordinates.z < selectedCell->coordinates.z))
         {
-            selectedCell = neighbour.second;
+            selectedCell = neighbour;
         }
     }
     return selectedCell;
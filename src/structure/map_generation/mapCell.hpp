@@ -25,6 +25,7 @@
 #include "room.hpp"
 
 #include <vector>
+#include <array>
 
 /// @brief Holds information about the cell of an automatically generated map.
 class MapCell
@@ -36,8 +37,8 @@ public:
     Coordinates coordinates;
     /// Associated tile.
     std::shared_ptr<Terrain> terrain;
-    /// List of neighbours.
-    std::map<Direction, MapCell *> neighbours;
+    /// The neighbours, by direction (see getNeighbourIndex).
+    std::array<MapCell *, 6> neighbours;
     /// The flags of the room.
     unsigned int flags;
     /// The liquid which will fill the room.
@@ -49,6 +50,23 @@ public:
     /// @brief Tries to add the given cell map in the given direction.
     bool addNeighbour(const Direction & direction, MapCell * mapCell);
 
+    /// @brief Provides the neighbour in the given direction.
+    MapCell * getNeighbour(const Direction & direction) const;
+
+    /// @brief Provides the position of the given direction inside the
+    ///         neighbours (North, South, West, East, Up, Down).
+    static inline size_t getNeighbourIndex(const Direction & direction)
+    {
+        return direction.toUInt() - 1;
+    }
+
+    /// @brief Provides the direction of the given position inside the
+    ///         neighbours.
+    static inline Direction getNeighbourDirection(size_t index)
+    {
+        return Direction(static_cast<unsigned int>(index + 1));
+    }
+
     /// @brief Find the lowest nearby cell.
     /// @return The found cell.
     MapCell * findLowestNearbyCell();
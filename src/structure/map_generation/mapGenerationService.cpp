@@ -0,0 +1,471 @@
+/// @file   mapGenerationService.cpp
+/// @brief  Implements the service which generates and builds the maps in
+///          background.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#include "mapGenerationService.hpp"
+
+#include "mapGenerator.hpp"
+#include "mapBulkWriter.hpp"
+#include "sqliteWriteFunctions.hpp"
+#include "areaChunks.hpp"
+#include "stopwatch.hpp"
+#include "logger.hpp"
+#include "mud.hpp"
+
+#include <chrono>
+
+MapJob::MapJob(unsigned int _id, MapJobType _type, std::string _owner) :
+    id(_id),
+    type(_type),
+    owner(_owner),
+    status(MapJobStatus::Queued),
+    progress(0),
+    cancelled(false),
+    configuration(),
+    heightMap(),
+    map(),
+    mapName(),
+    area(),
+    radius(),
+    step(),
+    writer(),
+    tiles(),
+    buildTime()
+{
+    // Nothing to do.
+}
+
+MapJob::~MapJob()
+{
+    // Nothing to do.
+}
+
+size_t MapJob::getSteps() const
+{
+    if (map == nullptr) return 0;
+    // A streamed area has a single step for each tile.
+    if (radius > 0) return map->getNumberOfCells();
+    return 2 * map->getNumberOfCells();
+}
+
+std::string MapJob::getTypeName() const
+{
+    if (type == MapJobType::Generate) return "Generate";
+    return "Build";
+}
+
+std::string MapJob::getStatusName() const
+{
+    auto current = status.load();
+    if (current == MapJobStatus::Queued) return "Queued";
+    if (current == MapJobStatus::Running) return "Running";
+    if (current == MapJobStatus::Completed) return "Completed";
+    if (current == MapJobStatus::Failed) return "Failed";
+    return "Cancelled";
+}
+
+bool MapJob::isFinished() const
+{
+    auto current = status.load();
+    return (current == MapJobStatus::Completed) ||
+           (current == MapJobStatus::Failed) ||
+           (current == MapJobStatus::Cancelled);
+}
+
+MapGenerationService::MapGenerationService() :
+    worker(),
+    queueMutex(),
+    queueCondition(),
+    queue(),
+    generated(),
+    stopping(),
+    jobs(),
+    lastId()
+{
+    // Nothing to do.
+}
+
+MapGenerationService::~MapGenerationService()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        // Stop the generations, so that the worker is not kept waiting.
+        for (auto const & job : queue)
+        {
+            job->cancelled = true;
+        }
+        for (auto const & job : jobs)
+        {
+            job->cancelled = true;
+        }
+    }
+    queueCondition.notify_all();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+MapGenerationService & MapGenerationService::instance()
+{
+    // Since it's a static variable, if the class has already been created,
+    // It won't be created again. And it **is** thread-safe in C++11.
+    static MapGenerationService instance;
+    // Return a reference to our instance.
+    return instance;
+}
+
+unsigned int MapGenerationService::generate(
+    const std::string & owner,
+    const MapGeneratorConfiguration & configuration,
+    const std::shared_ptr<HeightMap> & heightMap)
+{
+    auto job = std::make_shared<MapJob>(++lastId, MapJobType::Generate,
+                                        owner);
+    job->configuration = configuration;
+    job->heightMap = heightMap;
+    jobs.emplace_back(job);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        // Start the worker with the first generation.
+        if (!worker.joinable())
+        {
+            worker = std::thread(&MapGenerationService::work, this);
+        }
+        queue.emplace_back(job);
+    }
+    queueCondition.notify_one();
+    return job->id;
+}
+
+unsigned int MapGenerationService::build(
+    const std::string & owner,
+    const std::shared_ptr<MapWrapper> & map,
+    const std::string & mapName,
+    int radius)
+{
+    // Check if the map is already being built.
+    if ((map == nullptr) || this->isBuilding(map))
+    {
+        return 0;
+    }
+    auto job = std::make_shared<MapJob>(++lastId, MapJobType::Build, owner);
+    job->map = map;
+    job->mapName = mapName;
+    job->radius = radius;
+    job->writer = std::make_shared<MapBulkWriter>();
+    jobs.emplace_back(job);
+    return job->id;
+}
+
+bool MapGenerationService::cancel(unsigned int id)
+{
+    for (auto const & job : jobs)
+    {
+        if ((job->id != id) || job->isFinished())
+        {
+            continue;
+        }
+        job->cancelled = true;
+        // The generations are finished when the worker gives them back.
+        if (job->type == MapJobType::Build)
+        {
+            job->tiles.reset();
+            this->finish(job, MapJobStatus::Cancelled,
+                         "cancelled after " + ToString(job->step) +
+                         " of " + ToString(job->getSteps()) + " steps.");
+        }
+        return true;
+    }
+    return false;
+}
+
+bool MapGenerationService::isBuilding(
+    const std::shared_ptr<MapWrapper> & map) const
+{
+    for (auto const & job : jobs)
+    {
+        if ((job->type == MapJobType::Build) && (job->map == map) &&
+            !job->isFinished())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<std::shared_ptr<MapJob>> &
+MapGenerationService::getJobs() const
+{
+    return jobs;
+}
+
+void MapGenerationService::update()
+{
+    std::vector<std::shared_ptr<MapJob>> collected;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        collected.swap(generated);
+    }
+    for (auto const & job : collected)
+    {
+        if (job->cancelled)
+        {
+            this->finish(job, MapJobStatus::Cancelled, "cancelled.");
+        }
+        else if (job->map == nullptr)
+        {
+            this->finish(job, MapJobStatus::Failed,
+                         "error while generating the map.");
+        }
+        else
+        {
+            // The map is added to the mud only on the game thread.
+            Mud::instance().addGeneratedMap(job->map);
+            this->finish(job, MapJobStatus::Completed,
+                         "generated the map " + ToString(job->map->vnum) +
+                         ".");
+        }
+    }
+    this->advanceBuilds();
+}
+
+void MapGenerationService::work()
+{
+    while (true)
+    {
+        std::shared_ptr<MapJob> job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]()
+            {
+                return stopping || !queue.empty();
+            });
+            if (stopping)
+            {
+                return;
+            }
+            job = queue.front();
+            queue.pop_front();
+        }
+        if (!job->cancelled)
+        {
+            job->status = MapJobStatus::Running;
+            MapGenerator mapGenerator(job->configuration, job->heightMap);
+            // Report the progress and stop as soon as the job is cancelled.
+            mapGenerator.setObserver([&job](size_t done, size_t total)
+                                     {
+                                         job->progress = static_cast<
+                                             unsigned int>((100 * done) /
+                                                           total);
+                                         return !job->cancelled;
+                                     });
+            auto map = std::make_shared<MapWrapper>();
+            if (mapGenerator.generateMap(map))
+            {
+                job->map = map;
+            }
+        }
+        std::lock_guard<std::mutex> lock(queueMutex);
+        generated.emplace_back(job);
+    }
+}
+
+void MapGenerationService::advanceBuilds()
+{
+    long budget = buildBudget;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(budget);
+    for (auto const & job : jobs)
+    {
+        if ((job->type != MapJobType::Build) || job->isFinished())
+        {
+            continue;
+        }
+        if (job->status == MapJobStatus::Queued)
+        {
+            job->status = MapJobStatus::Running;
+            job->area = job->map->buildArea(job->mapName, job->owner);
+            if (job->area == nullptr)
+            {
+                this->finish(job, MapJobStatus::Failed,
+                             "cannot create the area.");
+                continue;
+            }
+        }
+        // The rooms of a streamed area are materialized when needed, only
+        // its tiles are built.
+        if (job->radius > 0)
+        {
+            if (job->tiles == nullptr)
+            {
+                job->tiles = job->map->createTiles(job->area, job->radius);
+            }
+            Stopwatch<std::chrono::microseconds> stopwatch("BuildTiles");
+            auto cells = job->map->getNumberOfCells();
+            // A failed step is recorded, so that it is not mistaken for the
+            // end of the budget and retried.
+            bool failed = false;
+            while ((job->step < cells) &&
+                   (std::chrono::steady_clock::now() < deadline))
+            {
+                if (!job->map->buildTile(*job->tiles, job->step))
+                {
+                    failed = true;
+                    break;
+                }
+                ++job->step;
+            }
+            job->buildTime += stopwatch.stop();
+            job->progress = (cells > 0) ? static_cast<unsigned int>(
+                (100 * job->step) / cells) : 100;
+            if (job->step == cells)
+            {
+                // The area is given its tiles only once they are complete.
+                job->area->chunks = std::move(job->tiles);
+                if (SaveAreaTiles(job->area))
+                {
+                    this->finish(job, MapJobStatus::Completed,
+                                 "built the streamed area " +
+                                 ToString(job->area->vnum) + ", " +
+                                 ToString(cells) + " tiles.");
+                }
+                else
+                {
+                    job->area->chunks.reset();
+                    this->finish(job, MapJobStatus::Failed,
+                                 "cannot save the tiles.");
+                }
+            }
+            else if (failed)
+            {
+                job->tiles.reset();
+                this->finish(job, MapJobStatus::Failed,
+                             "error while building the tiles.");
+            }
+            else
+            {
+                // The budget is spent, the other builds will wait.
+                break;
+            }
+            continue;
+        }
+        // The rows of this update are written in a single transaction.
+        if (!job->writer->begin())
+        {
+            this->finish(job, MapJobStatus::Failed,
+                         "cannot prepare the database.");
+            continue;
+        }
+        Stopwatch<std::chrono::microseconds> stopwatch("BuildMap");
+        // First all the rooms are created, then all the exits.
+        auto cells = job->map->getNumberOfCells();
+        // A failed step is recorded, so that it is not mistaken for the end
+        // of the budget and retried on a half-built area.
+        bool failed = false;
+        while ((job->step < 2 * cells) &&
+               (std::chrono::steady_clock::now() < deadline))
+        {
+            auto success = (job->step < cells) ?
+                           job->map->buildRoom(job->area, job->step,
+                                               *job->writer) :
+                           job->map->buildExits(job->step - cells,
+                                                *job->writer);
+            if (!success)
+            {
+                failed = true;
+                break;
+            }
+            ++job->step;
+        }
+        job->writer->commit();
+        job->buildTime += stopwatch.stop();
+        job->progress = (cells > 0) ? static_cast<unsigned int>(
+            (100 * job->step) / (2 * cells)) : 100;
+        if (job->step == 2 * cells)
+        {
+            this->finish(job, MapJobStatus::Completed,
+                         "built the area " + ToString(job->area->vnum) +
+                         ", " + ToString(job->writer->getRows()) +
+                         " rows at " +
+                         MapBulkWriter::getRate(job->writer->getRows(),
+                                                job->buildTime) +
+                         " rows/s.");
+        }
+        else if (failed)
+        {
+            this->finish(job, MapJobStatus::Failed,
+                         "error while building the map.");
+        }
+        else
+        {
+            // The budget is spent, the other builds will wait.
+            break;
+        }
+    }
+    this->forgetFinished();
+}
+
+void MapGenerationService::finish(const std::shared_ptr<MapJob> & job,
+                                  MapJobStatus status,
+                                  const std::string & message)
+{
+    job->status = status;
+    if (status == MapJobStatus::Completed)
+    {
+        job->progress = 100;
+    }
+    Logger::log(LogLevel::Global, "Map job %s, %s", job->id, message);
+    auto player = Mud::instance().findPlayer(job->owner);
+    if (player != nullptr)
+    {
+        player->sendMsg("Map job " + ToString(job->id) + ", " + message +
+                        "\n");
+    }
+}
+
+void MapGenerationService::forgetFinished()
+{
+    size_t finished = 0;
+    for (auto const & job : jobs)
+    {
+        if (job->isFinished())
+        {
+            ++finished;
+        }
+    }
+    for (auto it = jobs.begin();
+         (it != jobs.end()) && (finished > maxFinished);)
+    {
+        if ((*it)->isFinished())
+        {
+            it = jobs.erase(it);
+            --finished;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,232 @@
+/// @file   mapGenerationService.hpp
+/// @brief  Defines the service which generates and builds the maps in
+///          background.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include "mapGeneratorConfiguration.hpp"
+#include "mapWrapper.hpp"
+#include "heightMap.hpp"
+
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <deque>
+
+class MapBulkWriter;
+
+class AreaChunks;
+
+/// The kinds of map job.
+enum class MapJobType
+{
+    Generate,   ///< Generates a new map.
+    Build       ///< Builds the rooms of a generated map.
+};
+
+/// The states of a map job.
+enum class MapJobStatus
+{
+    Queued,     ///< Waiting to be started.
+    Running,    ///< Being processed.
+    Completed,  ///< Successfully completed.
+    Failed,     ///< Stopped by an error.
+    Cancelled   ///< Stopped by a request.
+};
+
+/// @brief A map generated or built in background.
+class MapJob
+{
+public:
+    /// The identifier of the job.
+    unsigned int id;
+    /// The kind of job.
+    MapJobType type;
+    /// The name of the character who has issued the job.
+    std::string owner;
+    /// The state of the job.
+    std::atomic<MapJobStatus> status;
+    /// The completion of the job, in percent.
+    std::atomic<unsigned int> progress;
+    /// If the job has been asked to stop.
+    std::atomic<bool> cancelled;
+    /// The configuration of the generator.
+    MapGeneratorConfiguration configuration;
+    /// The height map used by the generator.
+    std::shared_ptr<HeightMap> heightMap;
+    /// The map which is generated or built.
+    std::shared_ptr<MapWrapper> map;
+    /// The name of the area created by a build.
+    std::string mapName;
+    /// The area created by a build.
+    Area * area;
+    /// The radius within which the rooms of a streamed area are
+    /// materialized, 0 if all the rooms are built.
+    int radius;
+    /// The next step of a build: first the rooms, then the exits, or the
+    /// tiles of a streamed area.
+    size_t step;
+    /// The writer which saves the rooms of a build.
+    std::shared_ptr<MapBulkWriter> writer;
+    /// The tiles of a streamed area, given to the area once all are built.
+    std::unique_ptr<AreaChunks> tiles;
+    /// The time spent building, in microseconds.
+    double buildTime;
+
+    /// @brief Constructor.
+    MapJob(unsigned int _id, MapJobType _type, std::string _owner);
+
+    /// @brief Destructor.
+    ~MapJob();
+
+    /// @brief Provides the number of steps of the job.
+    size_t getSteps() const;
+
+    /// @brief Provides the kind of job as a string.
+    std::string getTypeName() const;
+
+    /// @brief Provides the state of the job as a string.
+    std::string getStatusName() const;
+
+    /// @brief Checks if the job has been completed, failed or cancelled.
+    bool isFinished() const;
+};
+
+/// @brief Generates the maps on a worker thread and builds them on the game
+///         thread, a few rooms at every update.
+/// @details
+/// The generation only works on its own MapWrapper, the generated map is
+/// added to the mud by update(). Since building a map creates rooms and
+/// writes them on the database, it is performed by update() within a time
+/// budget, so that the game keeps running while the map is built. The rows
+/// written during an update are saved inside a single transaction. The
+/// tiles of a streamed area are built within the same budget and saved when
+/// all of them are built.
+class MapGenerationService
+{
+private:
+    /// The time spent building maps at each update, in milliseconds.
+    static const long buildBudget = 5;
+    /// The maximum number of finished jobs which are remembered.
+    static const size_t maxFinished = 16;
+    /// The worker, started with the first generation.
+    std::thread worker;
+    /// Protects the queue, the generated jobs and the stop flag.
+    std::mutex queueMutex;
+    /// Signals the worker when a generation is queued.
+    std::condition_variable queueCondition;
+    /// The generations waiting for the worker.
+    std::deque<std::shared_ptr<MapJob>> queue;
+    /// The generations completed by the worker, not yet collected.
+    std::vector<std::shared_ptr<MapJob>> generated;
+    /// If the worker must stop.
+    bool stopping;
+    /// All the jobs, ordered by identifier.
+    std::vector<std::shared_ptr<MapJob>> jobs;
+    /// The last assigned identifier.
+    unsigned int lastId;
+
+    /// @brief Constructor.
+    MapGenerationService();
+
+    /// @brief Destructor.
+    ~MapGenerationService();
+
+public:
+    /// @brief Disable Copy Construct.
+    MapGenerationService(MapGenerationService const &) = delete;
+
+    /// @brief Disable Move construct.
+    MapGenerationService(MapGenerationService &&) = delete;
+
+    /// @brief Disable Copy assign.
+    MapGenerationService & operator=(MapGenerationService const &) = delete;
+
+    /// @brief Disable Move assign.
+    MapGenerationService & operator=(MapGenerationService &&) = delete;
+
+    /// @brief Get the singleton istance of the service.
+    /// @return The static and unique service.
+    static MapGenerationService & instance();
+
+    /// @brief Queues the generation of a new map.
+    /// @param owner         The name of the character who issues the job.
+    /// @param configuration The configuration of the generator.
+    /// @param heightMap     The height map.
+    /// @return The identifier of the job.
+    unsigned int generate(const std::string & owner,
+                          const MapGeneratorConfiguration & configuration,
+                          const std::shared_ptr<HeightMap> & heightMap);
+
+    /// @brief Queues the construction of a generated map.
+    /// @param owner   The name of the character who issues the job.
+    /// @param map     The generated map.
+    /// @param mapName The name of the new area.
+    /// @param radius  If positive, the map is built as a streamed area whose
+    ///                 rooms are materialized within this distance from the
+    ///                 characters.
+    /// @return The identifier of the job, 0 if the map is already being
+    ///          built.
+    unsigned int build(const std::string & owner,
+                       const std::shared_ptr<MapWrapper> & map,
+                       const std::string & mapName,
+                       int radius = 0);
+
+    /// @brief Stops a job. A map is not generated if its generation is
+    ///         cancelled, while the rooms already created by a build are
+    ///         kept.
+    /// @param id The identifier of the job.
+    /// @return <b>True</b> if the job has been stopped,<br>
+    ///         <b>False</b> if there is no such job or it is finished.
+    bool cancel(unsigned int id);
+
+    /// @brief Checks if a generated map is used by a build.
+    bool isBuilding(const std::shared_ptr<MapWrapper> & map) const;
+
+    /// @brief Provides the jobs which are still running and the last
+    ///         finished ones.
+    const std::vector<std::shared_ptr<MapJob>> & getJobs() const;
+
+    /// @brief Collects the generated maps and advances the builds, it must
+    ///         be called from the game thread.
+    void update();
+
+private:
+    /// @brief The loop of the worker.
+    void work();
+
+    /// @brief Advances the builds until the budget is spent.
+    void advanceBuilds();
+
+    /// @brief Marks a job as finished and notifies its owner.
+    void finish(const std::shared_ptr<MapJob> & job,
+                MapJobStatus status,
+                const std::string & message);
+
+    /// @brief Forgets the oldest finished jobs.
+    void forgetFinished();
+};
@@ -23,67 +23,131 @@
 #include "logger.hpp"
 #include "area.hpp"
 #include "structureUtils.hpp"
+#include "spatialHash.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <tuple>
+
+/// The factor which turns the noise into integer heights.
+static const float NoiseResolution = 10000.0f;
+
+/// @brief Hashes the coordinates of a point of the lattice of the noise.
+static inline uint32_t HashLattice(int32_t x, int32_t y, uint32_t seed)
+{
+    auto hash = seed ^
+                (static_cast<uint32_t>(x) * 0x27d4eb2dU) ^
+                (static_cast<uint32_t>(y) * 0x165667b1U);
+    hash = (hash ^ (hash >> 15)) * 0x2c1b3c6dU;
+    hash = (hash ^ (hash >> 12)) * 0x297a2d39U;
+    return hash ^ (hash >> 15);
+}
+
+/// @brief Provides the contribution of a point of the lattice, which is the
+///         dot product between its gradient and the offset of the sample.
+static inline float LatticeGradient(int32_t x, int32_t y, uint32_t seed,
+                                    float dx, float dy)
+{
+    // The gradient is drawn from the hash, without any lookup table.
+    auto hash = HashLattice(x, y, seed);
+    auto gx = static_cast<float>(hash & 0xffffU) / 32767.5f - 1.0f;
+    auto gy = static_cast<float>(hash >> 16) / 32767.5f - 1.0f;
+    return gx * dx + gy * dy;
+}
+
+/// @brief Smooths the interpolation between two points of the lattice.
+static inline float Fade(float t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+/// @brief Adds an octave of gradient noise to a row of heights. The loop
+///         has no branches and no lookups, thus it can be vectorized.
+static void AddNoiseOctave(float * row, int width, int y, uint32_t seed,
+                           float frequency, float amplitude)
+{
+    // The coordinates are positive, thus the truncation is the floor.
+    auto sy = static_cast<float>(y) * frequency;
+    auto y0 = static_cast<int32_t>(sy);
+    auto dy = sy - static_cast<float>(y0);
+    auto wy = Fade(dy);
+    for (int x = 0; x < width; ++x)
+    {
+        auto sx = static_cast<float>(x) * frequency;
+        auto x0 = static_cast<int32_t>(sx);
+        auto dx = sx - static_cast<float>(x0);
+        auto wx = Fade(dx);
+        auto n00 = LatticeGradient(x0, y0, seed, dx, dy);
+        auto n10 = LatticeGradient(x0 + 1, y0, seed, dx - 1.0f, dy);
+        auto n01 = LatticeGradient(x0, y0 + 1, seed, dx, dy - 1.0f);
+        auto n11 = LatticeGradient(x0 + 1, y0 + 1, seed, dx - 1.0f,
+                                   dy - 1.0f);
+        auto nx0 = n00 + wx * (n10 - n00);
+        auto nx1 = n01 + wx * (n11 - n01);
+        row[x] += amplitude * (nx0 + wy * (nx1 - nx0));
+    }
+}
 
 MapGenerator::MapGenerator(const MapGeneratorConfiguration & _configuration,
                            const std::shared_ptr<HeightMap> & _heightMap) :
     configuration(_configuration),
-    heightMap(_heightMap)
+    heightMap(_heightMap),
+    heightField(),
+    random(_configuration.seed),
+    observer()
 {
     // Nothing to do.
 }
 
 bool MapGenerator::generateMap(const std::shared_ptr<MapWrapper> & map)
 {
-    // Initialize the map.
-    if (!this->initializeMap(map))
-    {
-        Logger::log(LogLevel::Error, "While initializing the map.");
-        return false;
-    }
-    // Generate the mountains.
-    if (!this->generateMountains(map))
-    {
-        Logger::log(LogLevel::Error, "While generating the mountains.");
-        return false;
-    }
-    // Normalize the map in order to have values between 0 and 100.
-    if (!this->normalizeMap(map))
-    {
-        Logger::log(LogLevel::Error, "While normalizing the map.");
-        return false;
-    }
-    // Apply the heights to the map.
-    if (!this->applyTerrain(map))
-    {
-        Logger::log(LogLevel::Error, "While applying the terrains to the map.");
-        return false;
-    }
-    // Generate the rivers.
-    if (!this->generateRivers(map))
-    {
-        Logger::log(LogLevel::Error, "While generating the rivers.");
-        return false;
-    }
-    // Generate the forests.
-    if (!this->generateForests(map))
-    {
-        Logger::log(LogLevel::Error, "While generating the forests.");
-        return false;
-    }
-    // Reset the z coordinates.
-    if (!this->resetZCoordinates(map))
+    using Step = bool (MapGenerator::*)(const std::shared_ptr<MapWrapper> &);
+    static const std::vector<std::pair<Step, const char *>> steps = {
+        // Initialize the map.
+        {&MapGenerator::initializeMap, "While initializing the map."},
+        // Generate the relief.
+        {&MapGenerator::generateRelief, "While generating the relief."},
+        // Normalize the map in order to have values between 0 and 100.
+        {&MapGenerator::normalizeMap, "While normalizing the map."},
+        // Apply the heights to the map.
+        {&MapGenerator::applyTerrain,
+         "While applying the terrains to the map."},
+        // Generate the rivers.
+        {&MapGenerator::generateRivers, "While generating the rivers."},
+        // Generate the forests.
+        {&MapGenerator::generateForests, "While generating the forests."},
+        // Reset the z coordinates.
+        {&MapGenerator::resetZCoordinates,
+         "While setting the z coordinates."}
+    };
+    for (size_t it = 0; it < steps.size(); ++it)
     {
-        Logger::log(LogLevel::Error, "While setting the z coordinates.");
-        return false;
+        if (!(this->*steps[it].first)(map))
+        {
+            Logger::log(LogLevel::Error, steps[it].second);
+            return false;
+        }
+        // Check if the generation has been stopped by the observer.
+        if (observer && !observer(it + 1, steps.size()))
+        {
+            return false;
+        }
     }
     return true;
 }
 
+void MapGenerator::setObserver(
+    const std::function<bool(size_t, size_t)> & _observer)
+{
+    observer = _observer;
+}
+
 bool MapGenerator::initializeMap(const std::shared_ptr<MapWrapper> & map)
 {
-    // Set the dimension of the map.
-    map->setWidth(configuration.width);
-    map->setHeight(configuration.height);
+    // Set the dimension of the map and allocate its cells.
+    map->setSize(configuration.width, configuration.height);
     // Set the coordinates.
     for (int x = 0; x < map->getWidth(); ++x)
     {
@@ -147,84 +211,165 @@ bool MapGenerator::initializeMap(const std::shared_ptr<MapWrapper> & map)
     return true;
 }
 
+bool MapGenerator::generateRelief(const std::shared_ptr<MapWrapper> & map)
+{
+    if (configuration.reliefMode == ReliefMode::Noise)
+    {
+        return this->generateNoise(map);
+    }
+    return this->generateMountains(map);
+}
+
 bool MapGenerator::generateMountains(const std::shared_ptr<MapWrapper> & map)
 {
+    auto width = map->getWidth();
+    auto height = map->getHeight();
+    // Draw all the mountains first (center x, center y and radius), so that
+    // the random values are drawn in the same order whatever the number of
+    // threads computing the heights.
+    std::vector<std::tuple<int, int, int>> mountains;
     for (int i = 0; i < configuration.numMountains; ++i)
     {
         // Generate a random dimension for the mountain.
-        auto radius = TRand<int>(configuration.minMountainRadius,
-                                 configuration.maxMountainRadius);
+        auto radius = random.getInt<int>(configuration.minMountainRadius,
+                                          configuration.maxMountainRadius);
         // Generate a random place for the mountain.
-        auto xCenter = TRand<int>(-radius, map->getWidth() + radius);
-        auto yCenter = TRand<int>(-radius, map->getHeight() + radius);
-        // Determine the boundaries.
-        auto xMin = std::max(xCenter - radius - 1, 0);
-        auto xMax = std::min(xCenter + radius + 1, map->getWidth() - 1);
-        auto yMin = std::max(yCenter - radius - 1, 0);
-        auto yMax = std::min(yCenter + radius + 1, map->getHeight() - 1);
-        // Evaluate the square of the radius.
-        auto squareRadius = radius * radius;
-        // Evaluate the height of each cell inside the boundaries.
-        for (auto x = xMin; x <= xMax; ++x)
+        auto xCenter = random.getInt<int>(-radius, width + radius);
+        auto yCenter = random.getInt<int>(-radius, height + radius);
+        mountains.emplace_back(xCenter, yCenter, radius);
+    }
+    heightField.assign(static_cast<size_t>(width * height), 0);
+    // Each band of rows sums the contribution of all the mountains, in the
+    // same order, with integer arithmetic.
+    forEachBand(height, [&](int yBegin, int yEnd, size_t)
+    {
+        for (auto const & mountain : mountains)
         {
+            auto xCenter = std::get<0>(mountain);
+            auto yCenter = std::get<1>(mountain);
+            auto radius = std::get<2>(mountain);
+            // Determine the boundaries.
+            auto xMin = std::max(xCenter - radius - 1, 0);
+            auto xMax = std::min(xCenter + radius + 1, width - 1);
+            auto yMin = std::max(yCenter - radius - 1, yBegin);
+            auto yMax = std::min(yCenter + radius + 1, yEnd - 1);
+            // Evaluate the square of the radius.
+            auto squareRadius = radius * radius;
             for (auto y = yMin; y <= yMax; ++y)
             {
-                // Determine the distance between the cell and the center.
-                auto distance = pow(xCenter - x, 2) + pow(yCenter - y, 2);
-                // Determine the height of the cell based on the distance.
-                auto cellHeight = squareRadius - distance;
-                // Set the height value on the map.
-                if (cellHeight > 0)
+                auto dy = yCenter - y;
+                auto row = &heightField[static_cast<size_t>(y * width)];
+                for (auto x = xMin; x <= xMax; ++x)
                 {
-                    map->getCell(x, y)->coordinates.z +=
-                        static_cast<int>(std::ceil(cellHeight));
+                    // Determine the height of the cell based on the distance
+                    // between the cell and the center.
+                    auto dx = xCenter - x;
+                    auto cellHeight = squareRadius - (dx * dx + dy * dy);
+                    row[x] += (cellHeight > 0) ? cellHeight : 0;
                 }
             }
         }
-    }
+    });
     return true;
 }
 
-bool MapGenerator::normalizeMap(const std::shared_ptr<MapWrapper> & map)
+bool MapGenerator::generateNoise(const std::shared_ptr<MapWrapper> & map)
 {
-    auto minHeight = 0, maxHeight = 0;
-    // Find the minimum and maximum heights.
-    for (auto x = 0; x < map->getWidth(); ++x)
+    if ((configuration.noiseOctaves <= 0) ||
+        (configuration.noiseWavelength <= 0))
     {
-        for (auto y = 0; y < map->getHeight(); ++y)
+        Logger::log(LogLevel::Error, "Wrong configuration of the noise.");
+        return false;
+    }
+    auto width = map->getWidth();
+    auto height = map->getHeight();
+    // Draw a seed for each octave, so that the same configuration always
+    // produces the same relief.
+    std::vector<uint32_t> seeds;
+    for (int octave = 0; octave < configuration.noiseOctaves; ++octave)
+    {
+        seeds.emplace_back(random.getInt<uint32_t>(
+            0, std::numeric_limits<uint32_t>::max()));
+    }
+    heightField.assign(static_cast<size_t>(width * height), 0);
+    // Each band sums up the octaves of its rows, a row only depends on its
+    // own coordinates.
+    forEachBand(height, [&](int yBegin, int yEnd, size_t)
+    {
+        std::vector<float> row(static_cast<size_t>(width));
+        for (auto y = yBegin; y < yEnd; ++y)
         {
-            auto cell = map->getCell(x, y);
-            if (cell->coordinates.z < minHeight)
+            std::fill(row.begin(), row.end(), 0.0f);
+            auto frequency = 1.0f /
+                             static_cast<float>(configuration.noiseWavelength);
+            auto amplitude = 1.0f;
+            for (auto seed : seeds)
             {
-                minHeight = cell->coordinates.z;
+                AddNoiseOctave(row.data(), width, y, seed, frequency,
+                               amplitude);
+                frequency *= 2.0f;
+                amplitude *= static_cast<float>(
+                    configuration.noisePersistence);
             }
-            if (cell->coordinates.z > maxHeight)
+            auto cells = &heightField[static_cast<size_t>(y * width)];
+            for (auto x = 0; x < width; ++x)
             {
-                maxHeight = cell->coordinates.z;
+                cells[x] = static_cast<int>(row[static_cast<size_t>(x)] *
+                                            NoiseResolution);
             }
         }
+    });
+    return true;
+}
+
+bool MapGenerator::normalizeMap(const std::shared_ptr<MapWrapper> & map)
+{
+    auto width = map->getWidth();
+    // Find the minimum and maximum heights, each band reduces its rows.
+    std::vector<std::pair<int, int>> bounds(
+        getNumberOfBands(map->getHeight()), std::make_pair(0, 0));
+    auto bands = forEachBand(map->getHeight(),
+                             [&](int yBegin, int yEnd, size_t band)
+    {
+        auto minHeight = 0, maxHeight = 0;
+        auto begin = heightField.begin() + yBegin * width;
+        auto end = heightField.begin() + yEnd * width;
+        for (auto it = begin; it != end; ++it)
+        {
+            minHeight = std::min(minHeight, *it);
+            maxHeight = std::max(maxHeight, *it);
+        }
+        bounds[band] = std::make_pair(minHeight, maxHeight);
+    });
+    auto minHeight = 0, maxHeight = 0;
+    for (size_t band = 0; band < bands; ++band)
+    {
+        minHeight = std::min(minHeight, bounds[band].first);
+        maxHeight = std::max(maxHeight, bounds[band].second);
     }
     // Drop the map if it is quite plain.
-    if (DoubleEquality(maxHeight, minHeight))
+    if (maxHeight == minHeight)
     {
         Logger::log(LogLevel::Error, "Min and max height are the same.");
         // Clear the map.
         map->destroy();
         return false;
     }
-    // Normalize the heights to values between 0 and 10.
-    for (int x = 0; x < map->getWidth(); ++x)
+    // Normalize the heights to values between 0 and 100.
+    auto range = static_cast<long>(maxHeight - minHeight);
+    forEachBand(map->getHeight(), [&](int yBegin, int yEnd, size_t)
     {
-        for (int y = 0; y < map->getHeight(); ++y)
+        for (auto y = yBegin; y < yEnd; ++y)
         {
-            auto cell = map->getCell(x, y);
-            cell->coordinates.z = Normalize(cell->coordinates.z,
-                                            minHeight,
-                                            maxHeight,
-                                            0,
-                                            100);
+            for (auto x = 0; x < width; ++x)
+            {
+                auto value = heightField[static_cast<size_t>(y * width + x)];
+                map->getCell(x, y)->coordinates.z = static_cast<int>(
+                    (100 * static_cast<long>(value - minHeight)) / range);
+            }
         }
-    }
+    });
+    heightField.clear();
     return true;
 }
 
@@ -258,7 +403,11 @@ bool MapGenerator::applyTerrain(const std::shared_ptr<MapWrapper> & map)
 bool MapGenerator::generateRivers(const std::shared_ptr<MapWrapper> & map)
 {
     // List of possible starting points for a river.
-    std::list<MapCell *> startingPoints;
+    std::vector<MapCell *> startingPoints;
+    // The starting points, indexed by position.
+    SpatialHash startingPointsHash(map->getWidth(),
+                                   map->getHeight(),
+                                   configuration.minRiverDistance);
     // Lamba used to check if a cell is far away from pre-existing starting
     // points and if it is a mountain.
     auto IsSuitable = [&](MapCell * cell)
@@ -267,16 +416,7 @@ bool MapGenerator::generateRivers(const std::shared_ptr<MapWrapper> & map)
         {
             return false;
         }
-        for (auto point : startingPoints)
-        {
-            auto distance = StructUtils::getDistance(cell->coordinates,
-                                                          point->coordinates);
-            if (distance <= configuration.minRiverDistance)
-            {
-                return false;
-            }
-        }
-        return true;
+        return startingPointsHash.isFarFromAll(cell);
     };
     // Retrieve all the starting points for rivers.
     for (auto x = 0; x < map->getWidth(); ++x)
@@ -288,6 +428,7 @@ bool MapGenerator::generateRivers(const std::shared_ptr<MapWrapper> & map)
             if (IsSuitable(cell))
             {
                 startingPoints.emplace_back(cell);
+                startingPointsHash.add(cell);
             }
         }
     }
@@ -299,10 +440,9 @@ bool MapGenerator::generateRivers(const std::shared_ptr<MapWrapper> & map)
         // Prepare a vector for the river.
         std::vector<MapCell *> river;
         // Set the starting cell.
-        MapCell * cell = startingPoints.front();
-        startingPoints.pop_front();
+        MapCell * cell = startingPoints[it];
         // Pick from the available liquids of the starting cell.
-        auto liquid = cell->terrain->getRandomLiquidSource();
+        auto liquid = cell->terrain->getRandomLiquidSource(random);
         if (liquid == nullptr)
         {
             Logger::log(LogLevel::Error, "No liquid source.");
@@ -347,7 +487,11 @@ bool MapGenerator::generateRivers(const std::shared_ptr<MapWrapper> & map)
 bool MapGenerator::generateForests(const std::shared_ptr<MapWrapper> & map)
 {
     // List of locations for forests.
-    std::list<MapCell *> forestDropPoints;
+    std::vector<MapCell *> forestDropPoints;
+    // The drop points, indexed by position.
+    SpatialHash dropPointsHash(map->getWidth(),
+                               map->getHeight(),
+                               configuration.minForestDistance);
     // Lamba used to check if a cell is far away from pre-existing drop points
     // and if it is nearby a source of water.
     auto IsSuitable = [&](MapCell * cell)
@@ -359,16 +503,7 @@ bool MapGenerator::generateForests(const std::shared_ptr<MapWrapper> & map)
             return false;
         }
         // Check the distance from another forest drop point.
-        for (auto point : forestDropPoints)
-        {
-            auto distance = StructUtils::getDistance(cell->coordinates,
-                                                          point->coordinates);
-            if (distance <= configuration.minForestDistance)
-            {
-                return false;
-            }
-        }
-        return true;
+        return dropPointsHash.isFarFromAll(cell);
     };
     // Retrieve all the starting points for rivers.
     for (auto x = 0; x < map->getWidth(); ++x)
@@ -380,6 +515,7 @@ bool MapGenerator::generateForests(const std::shared_ptr<MapWrapper> & map)
             if (IsSuitable(cell))
             {
                 forestDropPoints.emplace_back(cell);
+                dropPointsHash.add(cell);
             }
         }
     }
@@ -400,7 +536,7 @@ bool MapGenerator::generateForests(const std::shared_ptr<MapWrapper> & map)
         }
         auto normalized = Normalize(iterationLeft, 0, iterationTotal, 0,
                                     100);
-        if (TRand<int>(0, 100) >= normalized) return true;
+        if (random.getInt<int>(0, 100) >= normalized) return true;
         SetFlag(cell->flags, RoomFlags::SpawnTree);
         iterationLeft--;
         if (!FloodFill(std::max(x - 1, 0), y, iterationTotal, iterationLeft))
@@ -421,17 +557,16 @@ bool MapGenerator::generateForests(const std::shared_ptr<MapWrapper> & map)
                          iterationTotal,
                          iterationLeft);
     };
-    auto maxForestExpansion = TRand(3,
-                                    configuration.minForestDistance - 1);
+    auto maxForestExpansion = random.getInt(
+        3, configuration.minForestDistance - 1);
     // Number of dropped rivers.
     auto iterations = std::min(static_cast<size_t>(configuration.numForests),
                                forestDropPoints.size());
     for (unsigned int it = 0; it < iterations; ++it)
     {
         // Pick a random forest drop point.
-        auto dpIt = forestDropPoints.begin();
-        std::advance(dpIt,
-                     TRand<size_t>(0, forestDropPoints.size() - 1));
+        auto dpIt = forestDropPoints.begin() + static_cast<long>(
+            random.getInt<size_t>(0, forestDropPoints.size() - 1));
         MapCell * cell = (*dpIt);
         forestDropPoints.erase(dpIt);
         // Create the forest.
@@ -459,3 +594,43 @@ bool MapGenerator::resetZCoordinates(const std::shared_ptr<MapWrapper> & map)
     }
     return true;
 }
+
+size_t MapGenerator::getNumberOfBands(int rows)
+{
+    // Bands smaller than this are not worth a thread.
+    static const int minBandRows = 32;
+    // Limit the bands to the number of available cores.
+    auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::min(static_cast<size_t>(cores),
+                    static_cast<size_t>(std::max(rows / minBandRows, 1)));
+}
+
+size_t MapGenerator::forEachBand(int rows,
+                                 const std::function<void(int, int, size_t)> &
+                                 function)
+{
+    auto bands = getNumberOfBands(rows);
+    if (bands <= 1)
+    {
+        function(0, rows, 0);
+        return 1;
+    }
+    auto rowsPerBand = (rows + static_cast<int>(bands) - 1) /
+                       static_cast<int>(bands);
+    std::vector<std::thread> threads;
+    for (size_t band = 0; band < bands; ++band)
+    {
+        auto yBegin = static_cast<int>(band) * rowsPerBand;
+        auto yEnd = std::min(yBegin + rowsPerBand, rows);
+        if (yBegin >= yEnd)
+        {
+            break;
+        }
+        threads.emplace_back(function, yBegin, yEnd, band);
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    return threads.size();
+}
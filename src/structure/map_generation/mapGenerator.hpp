@@ -24,8 +24,11 @@
 #include "mapWrapper.hpp"
 #include "heightMap.hpp"
 #include "mapGeneratorConfiguration.hpp"
+#include "randomEngine.hpp"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 /// @brief Automatic generator of maps.
 class MapGenerator
@@ -35,6 +38,12 @@ private:
     MapGeneratorConfiguration configuration;
     /// Height map.
     std::shared_ptr<HeightMap> heightMap;
+    /// The heights of the cells, row by row, before being normalized.
+    std::vector<int> heightField;
+    /// The generator of the random values, seeded by the configuration.
+    RandomEngine random;
+    /// Notified after each step of the generation.
+    std::function<bool(size_t, size_t)> observer;
 
 public:
 
@@ -45,13 +54,26 @@ public:
     /// @brief Generates a new map.
     bool generateMap(const std::shared_ptr<MapWrapper> & map);
 
+    /// @brief Sets the function notified after each step of the generation,
+    ///         which receives the completed steps and the total steps.
+    ///         When it returns false the generation stops and fails.
+    void setObserver(const std::function<bool(size_t, size_t)> & _observer);
+
 private:
     /// @brief Initializes the map.
     bool initializeMap(const std::shared_ptr<MapWrapper> & map);
 
+    /// @brief Raises the relief of the map with the algorithm selected by
+    ///         the configuration.
+    bool generateRelief(const std::shared_ptr<MapWrapper> & map);
+
     /// @brief Creates the mountains on the map.
     bool generateMountains(const std::shared_ptr<MapWrapper> & map);
 
+    /// @brief Fills the heights of the map with multi-octave gradient noise,
+    ///         which only depends on the coordinates of the cells.
+    bool generateNoise(const std::shared_ptr<MapWrapper> & map);
+
     /// @brief Normalizes the map with values between a specific range
     /// according to the HeightMap.
     bool normalizeMap(const std::shared_ptr<MapWrapper> & map);
@@ -67,4 +89,18 @@ private:
 
     /// @brief Resets the z coordinates of the cells inside the map to 50.
     bool resetZCoordinates(const std::shared_ptr<MapWrapper> & map);
+
+    /// @brief Provides the number of bands in which the rows are split.
+    static size_t getNumberOfBands(int rows);
+
+    /// @brief Splits the rows of the map in bands and processes them in
+    ///         parallel, each row is always processed by a single thread.
+    /// @param rows     The number of rows.
+    /// @param function The function which processes the rows of a band,
+    ///                  it receives the first row, the end row and the
+    ///                  index of the band.
+    /// @return The number of bands.
+    static size_t forEachBand(int rows,
+                              const std::function<void(int, int, size_t)> &
+                              function);
 };
\ No newline at end of file
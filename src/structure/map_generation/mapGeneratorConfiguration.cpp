@@ -28,10 +28,15 @@ MapGeneratorConfiguration::MapGeneratorConfiguration() :
     numMountains(50),
     minMountainRadius(5),
     maxMountainRadius(15),
+    reliefMode(ReliefMode::Mountains),
+    noiseOctaves(5),
+    noiseWavelength(32),
+    noisePersistence(0.5),
     numRivers(4),
     minRiverDistance(8),
     numForests(12),
-    minForestDistance(12)
+    minForestDistance(12),
+    seed(static_cast<unsigned int>(RandomEngine::generateSeed()))
 {
     // Nothing to do.
 }
@@ -44,9 +49,19 @@ std::string MapGeneratorConfiguration::toString() const
     output += "NumMountains      :" + ToString(numMountains) + ";\n";
     output += "MinMountainRadius :" + ToString(minMountainRadius) + ";\n";
     output += "MaxMountainRadius :" + ToString(maxMountainRadius) + ";\n";
+    output += "ReliefMode        :";
+    output += (reliefMode == ReliefMode::Noise) ? "Noise" : "Mountains";
+    output += ";\n";
+    if (reliefMode == ReliefMode::Noise)
+    {
+        output += "NoiseOctaves      :" + ToString(noiseOctaves) + ";\n";
+        output += "NoiseWavelength   :" + ToString(noiseWavelength) + ";\n";
+        output += "NoisePersistence  :" + ToString(noisePersistence) + ";\n";
+    }
     output += "NumRivers         :" + ToString(numRivers) + ";\n";
     output += "MinRiverDistance  :" + ToString(minRiverDistance) + ";\n";
     output += "NumForests        :" + ToString(numForests) + ";\n";
     output += "MinForestDistance :" + ToString(minForestDistance) + ";\n";
+    output += "Seed              :" + ToString(seed) + ";\n";
     return output;
 }
\ No newline at end of file
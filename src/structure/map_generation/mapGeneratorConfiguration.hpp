@@ -23,6 +23,15 @@
 
 #include <string>
 
+/// @brief The algorithms which can raise the relief of a map.
+enum class ReliefMode
+{
+    /// Circles of random radius are stamped on the map.
+    Mountains,
+    /// The heights are sampled from a multi-octave gradient noise.
+    Noise
+};
+
 /// @brief Configuration class for the map generator.
 class MapGeneratorConfiguration
 {
@@ -37,6 +46,14 @@ public:
     int minMountainRadius;
     /// The maximum radius of each mountain.
     int maxMountainRadius;
+    /// The algorithm which raises the relief.
+    ReliefMode reliefMode;
+    /// The number of octaves of noise which are summed up.
+    int noiseOctaves;
+    /// The side, in cells, of the hills of the first octave of noise.
+    int noiseWavelength;
+    /// The ratio between the amplitudes of two consecutive octaves.
+    double noisePersistence;
     /// The number of rivers that has to be created.
     int numRivers;
     /// The minimum distance between rivers.
@@ -45,6 +62,9 @@ public:
     int numForests;
     /// The minimum distance between forests.
     int minForestDistance;
+    /// The seed of the generator, the same seed always produces the same
+    /// map from the same configuration.
+    unsigned int seed;
 
     /// @brief Constructor.
     MapGeneratorConfiguration();
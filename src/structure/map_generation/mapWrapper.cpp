@@ -21,6 +21,8 @@
 
 #include "mapWrapper.hpp"
 #include "sqliteWriteFunctions.hpp"
+#include "mapBulkWriter.hpp"
+#include "areaChunks.hpp"
 #include "logger.hpp"
 #include "mud.hpp"
 
@@ -28,7 +30,8 @@ MapWrapper::MapWrapper() :
     vnum(),
     width(),
     height(),
-    map()
+    map(),
+    airMap()
 {
     // Nothing to do.
 }
@@ -38,25 +41,35 @@ MapWrapper::~MapWrapper()
     Logger::log(LogLevel::Trace, "Deleting map wrapper:%s", vnum);
 }
 
+size_t MapWrapper::getMemoryUsage() const
+{
+    // Estimate of the bookkeeping of a single node of a std::unordered_map.
+    static const size_t nodeSize = 3 * sizeof(void *);
+    size_t usage = sizeof(MapWrapper);
+    usage += map.capacity() * sizeof(MapCell);
+    usage += airMap.bucket_count() * sizeof(void *);
+    for (auto const & stack : airMap)
+    {
+        usage += nodeSize + sizeof(stack);
+        usage += stack.second.capacity() * sizeof(MapCell);
+    }
+    return usage;
+}
+
 void MapWrapper::destroy()
 {
-    for (int x = 0; x < width; ++x)
+    for (auto & cell : map)
     {
-        for (int y = 0; y < height; ++y)
-        {
-            auto cell = this->getCell(x, y);
-            cell->coordinates = Coordinates(0, 0, 0);
-            cell->terrain = nullptr;
-            cell->neighbours.clear();
-        }
+        cell.coordinates = Coordinates(0, 0, 0);
+        cell.terrain = nullptr;
+        cell.neighbours.fill(nullptr);
     }
+    airMap.clear();
 }
 
-bool MapWrapper::buildMap(const std::string & mapName,
-                          const std::string & builder)
+Area * MapWrapper::buildArea(const std::string & mapName,
+                             const std::string & builder)
 {
-    // -------------------------------------------------------------------------
-    // First create a new area.
     auto area = new Area();
     area->vnum = Mud::instance().getUniqueAreaVnum();
     area->name = mapName;
@@ -70,115 +83,165 @@ bool MapWrapper::buildMap(const std::string & mapName,
     if (!Mud::instance().addArea(area))
     {
         Logger::log(LogLevel::Error, "While adding the area to the MUD.\n");
-        return false;
+        delete (area);
+        return nullptr;
     }
     if (!SaveArea(area))
     {
         Logger::log(LogLevel::Error, "While saving the area on the DB.\n");
+        return nullptr;
+    }
+    return area;
+}
+
+bool MapWrapper::buildRoom(Area * area,
+                           size_t index,
+                           MapBulkWriter & writer)
+{
+    auto cell = this->getBuildCell(index);
+    if (cell == nullptr)
+    {
+        Logger::log(LogLevel::Error, "There is no cell %s.\n", index);
+        return false;
+    }
+    cell->room = new Room();
+    cell->room->vnum = Mud::instance().getMaxVnumRoom() + 1;
+    cell->room->area = area;
+    cell->room->coord = cell->coordinates;
+    cell->room->terrain = cell->terrain;
+    cell->room->name = cell->terrain->name;
+    cell->room->liquidContent = cell->liquidContent;
+    cell->room->description = "";
+    cell->room->flags = cell->flags;
+    // Add the created room to the room_map.
+    if (!Mud::instance().addRoom(cell->room))
+    {
+        Logger::log(LogLevel::Error,
+                    "Cannot add the room to the mud.\n");
+        return false;
+    }
+    if (!cell->room->area->addRoom(cell->room))
+    {
+        Logger::log(LogLevel::Error,
+                    "Cannot add the room to the area.\n");
+        return false;
+    }
+    if (!writer.saveRoom(cell->room))
+    {
+        Logger::log(LogLevel::Error,
+                    "While saving the room on DB.\n");
+        return false;
+    }
+    if (!writer.saveAreaList(area, cell->room))
+    {
+        Logger::log(LogLevel::Error,
+                    "While saving the Area List.\n");
+        return false;
+    }
+    return true;
+}
+
+bool MapWrapper::buildExits(size_t index, MapBulkWriter & writer)
+{
+    auto cell = this->getBuildCell(index);
+    if (cell == nullptr)
+    {
+        Logger::log(LogLevel::Error, "There is no cell %s.\n", index);
+        return false;
+    }
+    if (cell->room == nullptr)
+    {
+        Logger::log(LogLevel::Error,
+                    "A cell has a nullptr room at %s.\n",
+                    cell->coordinates.toString());
         return false;
     }
-    // -------------------------------------------------------------------------
-    // Generate the normal rooms.
-    for (int x = 0; x < width; ++x)
+    for (size_t it = 0; it < cell->neighbours.size(); ++it)
     {
-        for (int y = 0; y < height; ++y)
+        auto neighbour = cell->neighbours[it];
+        if (neighbour == nullptr)
         {
-            auto cell = this->getCell(x, y);
-            cell->room = new Room();
-            cell->room->vnum = Mud::instance().getMaxVnumRoom() + 1;
-            cell->room->area = area;
-            cell->room->coord = cell->coordinates;
-            cell->room->terrain = cell->terrain;
-            cell->room->name = cell->terrain->name;
-            cell->room->liquidContent = cell->liquidContent;
-            cell->room->description = "";
-            cell->room->flags = cell->flags;
-            // Add the created room to the room_map.
-            if (!Mud::instance().addRoom(cell->room))
-            {
-                Logger::log(LogLevel::Error,
-                            "Cannot add the room to the mud.\n");
-                return false;
-            }
-            if (!cell->room->area->addRoom(cell->room))
-            {
-                Logger::log(LogLevel::Error,
-                            "Cannot add the room to the area.\n");
-                return false;
-            }
-            if (!SaveRoom(cell->room))
-            {
-                Logger::log(LogLevel::Error,
-                            "While saving the room on DB.\n");
-                return false;
-            }
-            if (!SaveAreaList(area, cell->room))
+            continue;
+        }
+        auto direction = MapCell::getNeighbourDirection(it);
+        // Get the room of the neighbour.
+        if (neighbour->room == nullptr)
+        {
+            Logger::log(LogLevel::Error,
+                        "A neighbour has a nullptr room %s->%s.\n",
+                        cell->coordinates.toString(),
+                        neighbour->coordinates.toString());
+            return false;
+        }
+        // Create the two exits.
+        auto forward = std::make_shared<Exit>(
+            cell->room,
+            neighbour->room,
+            direction,
+            0);
+        auto backward = std::make_shared<Exit>(
+            neighbour->room,
+            cell->room,
+            direction.getOpposite(),
+            0);
+        // Insert in both the rooms exits the connection.
+        if (cell->room->addExit(forward))
+        {
+            if (!writer.saveRoomExit(forward))
             {
                 Logger::log(LogLevel::Error,
-                            "While saving the Area List.\n");
+                            "While saving the exit on DB.\n");
                 return false;
             }
-            Logger::log(LogLevel::Debug, "Created room at %s",
-                        cell->room->coord.toString());
         }
-    }
-    // -------------------------------------------------------------------------
-    // Generate the exits.
-    for (int x = 0; x < width; ++x)
-    {
-        for (int y = 0; y < height; ++y)
+        if (neighbour->room->addExit(backward))
         {
-            auto cell = this->getCell(x, y);
-            if (cell->room == nullptr)
+            if (!writer.saveRoomExit(backward))
             {
                 Logger::log(LogLevel::Error,
-                            "A cell has a nullptr room at %s.\n",
-                            cell->coordinates.toString());
+                            "While saving the exit on DB.\n");
                 return false;
             }
-            for (auto neighbour : cell->neighbours)
-            {
-                // Get the room of the neighbour.
-                if (neighbour.second->room == nullptr)
-                {
-                    Logger::log(LogLevel::Error,
-                                "A neighbour has a nullptr room %s->%s.\n",
-                                cell->coordinates.toString(),
-                                neighbour.second->coordinates.toString());
-                    return false;
-                }
-                // Create the two exits.
-                auto forward = std::make_shared<Exit>(
-                    cell->room,
-                    neighbour.second->room,
-                    neighbour.first,
-                    0);
-                auto backward = std::make_shared<Exit>(
-                    neighbour.second->room,
-                    cell->room,
-                    neighbour.first.getOpposite(),
-                    0);
-                // Insert in both the rooms exits the connection.
-                if (cell->room->addExit(forward))
-                {
-                    if (!SaveRoomExit(forward))
-                    {
-                        Logger::log(LogLevel::Error,
-                                    "While saving the exit on DB.\n");
-                        return false;
-                    }
-                }
-                if (neighbour.second->room->addExit(backward))
-                {
-                    if (!SaveRoomExit(backward))
-                    {
-                        Logger::log(LogLevel::Error,
-                                    "While saving the exit on DB.\n");
-                        return false;
-                    }
-                }
-            }
         }
     }
     return true;
-}
\ No newline at end of file
+}
+
+std::unique_ptr<AreaChunks> MapWrapper::createTiles(Area * area,
+                                                    int radius)
+{
+    auto firstVnum = Mud::instance().getMaxVnumRoom() + 1;
+    auto tiles = std::unique_ptr<AreaChunks>(
+        new AreaChunks(area, firstVnum, width, height, radius));
+    // The vnums of the rooms which are not materialized are reserved.
+    Mud::instance().reserveRoomVnums(tiles->getLastVnum());
+    return tiles;
+}
+
+bool MapWrapper::buildTile(AreaChunks & tiles, size_t index)
+{
+    auto const & cell = map[index];
+    auto liquid = cell.liquidContent.first;
+    // Check if the values fit inside a tile.
+    if ((cell.terrain == nullptr) ||
+        (cell.terrain->vnum > UINT16_MAX) ||
+        (cell.coordinates.z < INT16_MIN) ||
+        (cell.coordinates.z > INT16_MAX) ||
+        ((liquid != nullptr) && (liquid->vnum > UINT16_MAX)))
+    {
+        Logger::log(LogLevel::Error, "The cell %s can't be a tile.",
+                    cell.coordinates.toString());
+        return false;
+    }
+    MapTile tile;
+    tile.terrain = static_cast<uint16_t>(cell.terrain->vnum);
+    tile.z = static_cast<int16_t>(cell.coordinates.z);
+    tile.flags = cell.flags;
+    if (liquid != nullptr)
+    {
+        tile.liquid = static_cast<uint16_t>(liquid->vnum);
+        tile.quantity = cell.liquidContent.second;
+    }
+    tiles.setTile(cell.coordinates.x, cell.coordinates.y, tile);
+    return true;
+}
@@ -22,7 +22,17 @@
 #pragma once
 
 #include "mapCell.hpp"
+
+#include <unordered_map>
+#include <algorithm>
 #include <vector>
+#include <memory>
+
+class Area;
+
+class AreaChunks;
+
+class MapBulkWriter;
 
 /// @brief Class which contains (wrap) an under-construction map.
 class MapWrapper
@@ -34,10 +44,11 @@ public:
     int width;
     /// Height of the map.
     int height;
-    /// The map.
-    std::map<int, std::map<int, MapCell>> map;
-    /// The air map.
-    std::map<int, std::map<int, std::vector<MapCell>>> airMap;
+    /// The cells of the map, row by row.
+    std::vector<MapCell> map;
+    /// The air cells above the map, by column and ordered by height. Only
+    /// the columns which actually have air cells are stored.
+    std::unordered_map<size_t, std::vector<MapCell>> airMap;
 
     /// @brief Constructor.
     MapWrapper();
@@ -45,16 +56,14 @@ public:
     /// @brief Destructor.
     ~MapWrapper();
 
-    /// @brief Allows to set the width of the map.
-    inline void setWidth(const int & _width)
+    /// @brief Allows to set the dimension of the map, it allocates the
+    ///         cells, thus the pointers to the previous cells are lost.
+    inline void setSize(const int & _width, const int & _height)
     {
-        width = _width;
-    }
-
-    /// @brief Allows to set the height of the map.
-    inline void setHeight(const int & _height)
-    {
-        height = _height;
+        width = std::max(_width, 0);
+        height = std::max(_height, 0);
+        map.assign(static_cast<size_t>(width * height), MapCell());
+        airMap.clear();
     }
 
     /// @brief Provide the width of the map.
@@ -74,41 +83,33 @@ public:
     {
         if ((x < 0) || (x >= width)) return nullptr;
         if ((y < 0) || (y >= height)) return nullptr;
-        return &map[x][y];
+        return &map[getIndex(x, y)];
     }
 
-    /// @brief Returns the cell at the given position.
+    /// @brief Returns the air cells above the given position, ordered by
+    ///         height.
     inline std::vector<MapCell> * getAirStack(int x, int y)
     {
         if ((x < 0) || (x >= width)) return nullptr;
         if ((y < 0) || (y >= height)) return nullptr;
-        auto it = airMap.find(x);
-        if (it != airMap.end())
-        {
-            auto it2 = it->second.find(y);
-            if (it2 != it->second.end())
-            {
-                return &it2->second;
-            }
-        }
-        return &(airMap[x][y] = std::vector<MapCell>());
+        return &airMap[getIndex(x, y)];
+    }
+
+    /// @brief Adds an air cell above the given position, keeping the
+    ///         stack ordered by height.
+    inline MapCell * addAirCell(int x, int y, const MapCell & mapCell)
+    {
+        auto stack = this->getAirStack(x, y);
+        if (stack == nullptr) return nullptr;
+        auto it = std::lower_bound(stack->begin(), stack->end(), mapCell,
+                                   compareHeight);
+        return &(*stack->insert(it, mapCell));
     }
 
     /// @brief Returns the cell at the given position.
     inline MapCell * findCell(int x, int y)
     {
-        if ((x < 0) || (x >= width)) return nullptr;
-        if ((y < 0) || (y >= height)) return nullptr;
-        auto it = map.find(x);
-        if (it != map.end())
-        {
-            auto it2 = it->second.find(y);
-            if (it2 != it->second.end())
-            {
-                return &it2->second;
-            }
-        }
-        return nullptr;
+        return this->getCell(x, y);
     }
 
     /// @brief Returns the cell at the given position.
@@ -116,21 +117,18 @@ public:
     {
         if ((x < 0) || (x >= width)) return nullptr;
         if ((y < 0) || (y >= height)) return nullptr;
-        auto it = airMap.find(x);
-        if (it != airMap.end())
+        auto it = airMap.find(getIndex(x, y));
+        if (it == airMap.end())
+        {
+            return nullptr;
+        }
+        MapCell key;
+        key.coordinates.z = z;
+        auto cell = std::lower_bound(it->second.begin(), it->second.end(),
+                                     key, compareHeight);
+        if ((cell != it->second.end()) && (cell->coordinates.z == z))
         {
-            auto it2 = it->second.find(y);
-            if (it2 != it->second.end())
-            {
-                for (auto it3 = it2->second.begin(); it3 != it2->second.end();
-                     ++it3)
-                {
-                    if (it3->coordinates.z == z)
-                    {
-                        return &(*it3);
-                    }
-                }
-            }
+            return &(*cell);
         }
         return nullptr;
     }
@@ -143,13 +141,86 @@ public:
                     int y,
                     const MapCell & mapCell)
     {
-        map[x][y] = mapCell;
+        auto cell = this->getCell(x, y);
+        if (cell != nullptr)
+        {
+            *cell = mapCell;
+        }
     }
 
     /// @brief Destroy the map.
     void destroy();
 
-    /// @brief Build the map.
-    bool buildMap(const std::string & mapName,
-                  const std::string & builder);
+    /// @brief Provides an estimate of the memory used by the map.
+    size_t getMemoryUsage() const;
+
+    /// @brief Provides the number of cells which have to be built.
+    inline size_t getNumberOfCells() const
+    {
+        return map.size();
+    }
+
+    /// @brief Creates the area of the map and adds it to the mud, it is the
+    ///         first step of the construction of the map.
+    /// @param mapName The name of the area.
+    /// @param builder The name of the builder.
+    /// @return The new area, nullptr if it cannot be created.
+    Area * buildArea(const std::string & mapName,
+                     const std::string & builder);
+
+    /// @brief Creates the room of a cell, the cells are built column by
+    ///         column. All the rooms must be created before the exits.
+    /// @param area   The area of the map.
+    /// @param index  The index of the cell, up to getNumberOfCells.
+    /// @param writer The writer which saves the room on the database.
+    /// @return <b>True</b> if the room has been created,<br>
+    ///         <b>False</b> otherwise.
+    bool buildRoom(Area * area, size_t index, MapBulkWriter & writer);
+
+    /// @brief Creates the exits between the room of a cell and the rooms of
+    ///         its neighbours.
+    /// @param index  The index of the cell, up to getNumberOfCells.
+    /// @param writer The writer which saves the exits on the database.
+    /// @return <b>True</b> if the exits have been created,<br>
+    ///         <b>False</b> otherwise.
+    bool buildExits(size_t index, MapBulkWriter & writer);
+
+    /// @brief Creates the tiles of a streamed area, instead of building all
+    ///         the rooms, and reserves the vnums of their rooms. The tiles
+    ///         are then filled by buildTile.
+    /// @param area   The area of the map.
+    /// @param radius The distance from the characters within which the
+    ///                rooms are materialized.
+    /// @return The empty tiles.
+    std::unique_ptr<AreaChunks> createTiles(Area * area, int radius);
+
+    /// @brief Stores a cell as a tile of a streamed area.
+    /// @param tiles The tiles of the area.
+    /// @param index The index of the cell, up to getNumberOfCells.
+    /// @return <b>True</b> if the cell fits inside a tile,<br>
+    ///         <b>False</b> otherwise.
+    bool buildTile(AreaChunks & tiles, size_t index);
+
+private:
+    /// @brief Provides the cell built at the given step, column by column.
+    inline MapCell * getBuildCell(size_t index)
+    {
+        if ((height <= 0) || (index >= map.size())) return nullptr;
+        auto rows = static_cast<size_t>(height);
+        return this->getCell(static_cast<int>(index / rows),
+                             static_cast<int>(index % rows));
+    }
+
+    /// @brief Provides the position of a column inside the cells.
+    inline size_t getIndex(int x, int y) const
+    {
+        return static_cast<size_t>(y * width + x);
+    }
+
+    /// @brief Orders the cells of an air stack by height.
+    static inline bool compareHeight(const MapCell & left,
+                                     const MapCell & right)
+    {
+        return left.coordinates.z < right.coordinates.z;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+/// @file   spatialHash.cpp
+/// @brief  Implements a uniform grid used to find the nearby cells of a map.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "spatialHash.hpp"
+
+#include "structureUtils.hpp"
+#include "mapCell.hpp"
+
+#include <algorithm>
+
+SpatialHash::SpatialHash(int width, int height, int _minDistance) :
+    minDistance(_minDistance),
+    // The distances are truncated, thus a cell at distance minDistance can
+    // be up to (minDistance + 1) away.
+    bucketSize(std::max(_minDistance + 1, 1)),
+    columns(std::max(width, 1) / bucketSize + 1),
+    rows(std::max(height, 1) / bucketSize + 1),
+    buckets(static_cast<size_t>(columns * rows))
+{
+    // Nothing to do.
+}
+
+void SpatialHash::add(MapCell * cell)
+{
+    auto column = this->getBucket(cell->coordinates.x);
+    auto row = this->getBucket(cell->coordinates.y);
+    buckets[static_cast<size_t>(row * columns + column)].emplace_back(cell);
+}
+
+bool SpatialHash::isFarFromAll(MapCell * cell) const
+{
+    auto column = this->getBucket(cell->coordinates.x);
+    auto row = this->getBucket(cell->coordinates.y);
+    // Only the surrounding buckets can contain a cell which is near.
+    for (auto y = std::max(row - 1, 0); y <= std::min(row + 1, rows - 1); ++y)
+    {
+        for (auto x = std::max(column - 1, 0);
+             x <= std::min(column + 1, columns - 1); ++x)
+        {
+            for (auto other : buckets[static_cast<size_t>(y * columns + x)])
+            {
+                auto distance = StructUtils::getDistance(cell->coordinates,
+                                                         other->coordinates);
+                if (distance <= minDistance)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int SpatialHash::getBucket(int coordinate) const
+{
+    return std::max(coordinate, 0) / bucketSize;
+}
@@ -0,0 +1,64 @@
+/// @file   spatialHash.hpp
+/// @brief  Defines a uniform grid used to find the nearby cells of a map.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <vector>
+
+class MapCell;
+
+/// @brief A uniform grid of buckets, as large as the minimum distance
+///         between the cells it contains, so that checking if a position
+///         is far enough from all the cells only looks at the nearby
+///         buckets.
+class SpatialHash
+{
+private:
+    /// The minimum distance between the cells.
+    int minDistance;
+    /// The side of a bucket.
+    int bucketSize;
+    /// The number of columns of buckets.
+    int columns;
+    /// The number of rows of buckets.
+    int rows;
+    /// The buckets, row by row.
+    std::vector<std::vector<MapCell *>> buckets;
+
+public:
+    /// @brief Constructor.
+    /// @param width        The width of the map.
+    /// @param height       The height of the map.
+    /// @param _minDistance The minimum distance between the cells.
+    SpatialHash(int width, int height, int _minDistance);
+
+    /// @brief Adds a cell.
+    void add(MapCell * cell);
+
+    /// @brief Checks if the cell is farther than the minimum distance from
+    ///         all the cells added so far.
+    bool isFarFromAll(MapCell * cell) const;
+
+private:
+    /// @brief Provides the bucket column (or row) of a coordinate.
+    int getBucket(int coordinate) const;
+};
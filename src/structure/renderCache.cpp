@@ -0,0 +1,199 @@
+/// @file   renderCache.cpp
+/// @brief  Caches the maps rendered around the rooms of an area.
+/// @author Enrico Fraccaroli
+/// @date   06 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "renderCache.hpp"
+
+MapLayer::MapLayer() :
+    tiles(),
+    separators(),
+    cells(),
+    left(),
+    top(),
+    columns()
+{
+    // Nothing to do.
+}
+
+void MapLayer::addTile(const std::string & tile, const std::string & separator)
+{
+    tiles.emplace_back(tile);
+    separators.emplace_back(separator);
+}
+
+void MapLayer::addCell(const std::string & tile,
+                       const std::string & separator,
+                       Room * room)
+{
+    cells.emplace_back(std::make_pair(tiles.size(), room));
+    this->addTile(tile, separator);
+}
+
+void MapLayer::endRow(const std::string & terminator)
+{
+    if (separators.empty())
+    {
+        this->addTile("", terminator);
+    }
+    else
+    {
+        separators.back() += terminator;
+    }
+}
+
+std::string MapLayer::toString() const
+{
+    return this->toString(tiles);
+}
+
+std::string MapLayer::toString(const std::vector<std::string> & overlay) const
+{
+    std::string result;
+    result.reserve(overlay.size() * 2);
+    for (size_t it = 0; it < overlay.size(); ++it)
+    {
+        result += overlay[it];
+        result += separators[it];
+    }
+    return result;
+}
+
+MapFrame::MapFrame() :
+    epoch(),
+    generation(),
+    night(),
+    hasAscii(),
+    ascii(),
+    hasLayers(),
+    layers()
+{
+    // Nothing to do.
+}
+
+ClientMap::ClientMap() :
+    area(),
+    origin(),
+    radius(),
+    layers()
+{
+    // Nothing to do.
+}
+
+void ClientMap::clear()
+{
+    area = nullptr;
+    layers.clear();
+}
+
+RenderCache::RenderCache() :
+    epoch(),
+    generation(),
+    regions(),
+    frames()
+{
+    // Nothing to do.
+}
+
+RenderCache::~RenderCache()
+{
+    // Nothing to do.
+}
+
+void RenderCache::touch(const Coordinates & coordinates)
+{
+    regions[getRegion(coordinates.x, coordinates.y, coordinates.z)] = ++epoch;
+}
+
+void RenderCache::invalidate()
+{
+    // The frames are checked against the generation when they are
+    // retrieved, thus a frame which is being rendered stays valid.
+    ++generation;
+    regions.clear();
+}
+
+MapFrame & RenderCache::getFrame(const Coordinates & origin,
+                                 const int & radius,
+                                 const bool & night)
+{
+    // The frames of the day and of the night are kept apart, so that the
+    // ASCII and the client maps do not replace each other.
+    auto key = std::make_tuple(origin.x, origin.y, origin.z, radius, night);
+    auto it = frames.find(key);
+    if (it != frames.end())
+    {
+        // Check if the cached frame is still valid.
+        if ((it->second.generation == generation) &&
+            !this->isStale(it->second, origin, radius))
+        {
+            return it->second;
+        }
+        frames.erase(it);
+    }
+    // Keep the size of the cache under control.
+    if (frames.size() >= maxFrames)
+    {
+        frames.clear();
+    }
+    auto & frame = frames[key];
+    frame.epoch = epoch;
+    frame.generation = generation;
+    frame.night = night;
+    return frame;
+}
+
+size_t RenderCache::getNumberOfFrames() const
+{
+    return frames.size();
+}
+
+std::tuple<int, int, int> RenderCache::getRegion(const int & x,
+                                                 const int & y,
+                                                 const int & z)
+{
+    return std::make_tuple((x < 0) ? -1 : (x / regionSize),
+                           (y < 0) ? -1 : (y / regionSize),
+                           z);
+}
+
+bool RenderCache::isStale(const MapFrame & frame,
+                          const Coordinates & origin,
+                          const int & radius) const
+{
+    if (regions.empty())
+    {
+        return false;
+    }
+    auto first = getRegion(origin.x - radius, origin.y - radius, origin.z);
+    auto last = getRegion(origin.x + radius, origin.y + radius, origin.z);
+    for (auto x = std::get<0>(first); x <= std::get<0>(last); ++x)
+    {
+        for (auto y = std::get<1>(first); y <= std::get<1>(last); ++y)
+        {
+            auto it = regions.find(std::make_tuple(x, y, origin.z));
+            if ((it != regions.end()) && (it->second > frame.epoch))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,192 @@
+/// @file   renderCache.hpp
+/// @brief  Caches the maps rendered around the rooms of an area.
+/// @author Enrico Fraccaroli
+/// @date   06 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <map>
+
+#include "coordinates.hpp"
+
+class Area;
+
+class Room;
+
+/// @brief A layer of a rendered map, stored as a sequence of tiles.
+class MapLayer
+{
+public:
+    /// The tiles of the layer.
+    std::vector<std::string> tiles;
+    /// The separators which follow each tile.
+    std::vector<std::string> separators;
+    /// The visible rooms of the layer, together with the index of their tile.
+    std::vector<std::pair<size_t, Room *>> cells;
+    /// The x coordinate of the first column.
+    int left;
+    /// The y coordinate of the first row.
+    int top;
+    /// The number of tiles of each row.
+    int columns;
+
+    /// @brief Constructor.
+    MapLayer();
+
+    /// @brief Adds a tile to the layer.
+    /// @param tile      The tile.
+    /// @param separator The separator which follows the tile.
+    void addTile(const std::string & tile, const std::string & separator);
+
+    /// @brief Adds a tile which belongs to a visible room.
+    /// @param tile      The tile.
+    /// @param separator The separator which follows the tile.
+    /// @param room      The room represented by the tile.
+    void addCell(const std::string & tile,
+                 const std::string & separator,
+                 Room * room);
+
+    /// @brief Terminates the current row of tiles.
+    /// @param terminator The string which ends the row.
+    void endRow(const std::string & terminator);
+
+    /// @brief Provides the layer as a string.
+    std::string toString() const;
+
+    /// @brief Provides the layer as a string, using the given tiles.
+    /// @param overlay The tiles which replace the ones of the layer.
+    std::string toString(const std::vector<std::string> & overlay) const;
+};
+
+/// @brief A map rendered around a room, it contains everything except the
+///         characters, which are drawn on top of it every time.
+class MapFrame
+{
+public:
+    /// The epoch at which the frame has been rendered.
+    unsigned long epoch;
+    /// The generation of the cache at which the frame has been rendered.
+    unsigned int generation;
+    /// If the frame has been rendered during the night.
+    bool night;
+    /// If the ASCII map has been rendered.
+    bool hasAscii;
+    /// The ASCII map.
+    MapLayer ascii;
+    /// If the layers for the client have been rendered.
+    bool hasLayers;
+    /// The layers for the client (environment, objects, creatures).
+    std::vector<MapLayer> layers;
+
+    /// @brief Constructor.
+    MapFrame();
+};
+
+/// @brief The last map which has been sent to a client, it is used to send
+///         only the tiles which have changed.
+class ClientMap
+{
+public:
+    /// The area of the map.
+    Area * area;
+    /// The center of the map.
+    Coordinates origin;
+    /// The radius of the map.
+    int radius;
+    /// The layers which have been sent.
+    std::vector<MapLayer> layers;
+
+    /// @brief Constructor.
+    ClientMap();
+
+    /// @brief Forgets the last map, the next one will be sent entirely.
+    void clear();
+};
+
+/// @brief The cache of the maps rendered inside an area.
+/// @details
+/// The area is divided in regions, each one with the epoch of its last
+/// change (items, doors, lights). A frame is still valid as long as none of
+/// the regions it covers has changed after it has been rendered. Structural
+/// changes (rooms and exits) invalidate the whole cache.
+class RenderCache
+{
+private:
+    /// The size of the side of a region.
+    static const int regionSize = 8;
+    /// The maximum number of frames kept inside the cache.
+    static const size_t maxFrames = 4096;
+    /// The current epoch.
+    unsigned long epoch;
+    /// The current generation.
+    unsigned int generation;
+    /// The epoch of the last change of each region.
+    std::map<std::tuple<int, int, int>, unsigned long> regions;
+    /// The frames, by origin (x, y, z), radius and night.
+    std::map<std::tuple<int, int, int, int, bool>, MapFrame> frames;
+
+public:
+    /// @brief Constructor.
+    RenderCache();
+
+    /// @brief Destructor.
+    ~RenderCache();
+
+    /// @brief Disable Copy Construct.
+    RenderCache(RenderCache const &) = delete;
+
+    /// @brief Disable Copy assign.
+    RenderCache & operator=(RenderCache const &) = delete;
+
+    /// @brief Notifies that something has changed at the given coordinates.
+    /// @param coordinates The coordinates of the change.
+    void touch(const Coordinates & coordinates);
+
+    /// @brief Invalidates all the frames.
+    void invalidate();
+
+    /// @brief Provides the frame for the given origin and radius, if the
+    ///         cached frame is not valid anymore an empty one is returned.
+    /// @param origin The center of the frame.
+    /// @param radius The radius of the frame.
+    /// @param night  If it is night.
+    /// @return The frame.
+    MapFrame & getFrame(const Coordinates & origin,
+                        const int & radius,
+                        const bool & night);
+
+    /// @brief Provides the number of cached frames.
+    size_t getNumberOfFrames() const;
+
+private:
+    /// @brief Provides the key of the region which contains the coordinates.
+    static std::tuple<int, int, int> getRegion(const int & x,
+                                               const int & y,
+                                               const int & z);
+
+    /// @brief Checks if a region covered by the frame has changed.
+    bool isStale(const MapFrame & frame,
+                 const Coordinates & origin,
+                 const int & radius) const;
+};
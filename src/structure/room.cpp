@@ -27,8 +27,10 @@
 #include "lightItem.hpp"
 #include "generator.hpp"
 #include "logger.hpp"
+#include "memoryTracker.hpp"
 #include "mud.hpp"
 #include "structureUtils.hpp"
+#include "areaChunks.hpp"
 
 Room::Room() :
     vnum(),
@@ -41,7 +43,8 @@ Room::Room() :
     items(),
     characters(),
     flags(),
-    liquidContent()
+    liquidContent(),
+    dirty()
 {
     // Nothing to do.
 }
@@ -67,6 +70,19 @@ Room::~Room()
 //                name);
 }
 
+void * Room::operator new(size_t size)
+{
+    auto ptr = ::operator new(size);
+    MemoryTracker::instance().allocate(MemoryCategory::Room, size);
+    return ptr;
+}
+
+void Room::operator delete(void * ptr, size_t size)
+{
+    MemoryTracker::instance().deallocate(MemoryCategory::Room, size);
+    ::operator delete(ptr);
+}
+
 bool Room::check(bool complete)
 {
     if (vnum <= 0) return false;
@@ -88,6 +104,21 @@ void Room::addItem(Item *& item, bool updateDB)
     items.push_back_item(item);
     // Set the room attribute of the item.
     item->room = this;
+    // The item is shown on the map.
+    if (area != nullptr)
+    {
+        area->renderCache.touch(coord);
+    }
+    // Mechanisms (e.g. doors) can change the field of views.
+    if ((area != nullptr) && (item->getType() == ModelType::Mechanism))
+    {
+        area->invalidateFov();
+    }
+    // Update the light map.
+    if (item->getType() == ModelType::Light)
+    {
+        static_cast<LightItem *>(item)->updateLightMap();
+    }
     // Update the database.
     if (updateDB && (item->getType() != ModelType::Corpse))
     {
@@ -104,7 +135,7 @@ void Room::addItem(Item *& item, bool updateDB)
 void Room::addBuilding(Item * item, bool updateDB)
 {
     // Set the item as built.
-    SetFlag(item->flags, ItemFlag::Built);
+    item->setFlag(ItemFlag::Built);
     // Check if the item is already inside the room.
     for (auto iterator : items)
     {
@@ -121,6 +152,18 @@ void Room::addCharacter(Character * character)
 {
     characters.push_back(character);
     character->room = this;
+    // Update the position of the character inside the area.
+    if (area != nullptr)
+    {
+        area->characterIndex.addCharacter(character, coord);
+        // Materialize the rooms around the character.
+        if (area->chunks != nullptr)
+        {
+            area->chunks->loadAround(coord, area->chunks->getRadius());
+        }
+    }
+    // Move the light sources equipped by the character.
+    character->updateEquippedLights();
 }
 
 bool Room::removeItem(Item * item, bool updateDB)
@@ -128,6 +171,21 @@ bool Room::removeItem(Item * item, bool updateDB)
     if (items.removeItem(item))
     {
         item->room = nullptr;
+        // The item is shown on the map.
+        if (area != nullptr)
+        {
+            area->renderCache.touch(coord);
+        }
+        // Mechanisms (e.g. doors) can change the field of views.
+        if ((area != nullptr) && (item->getType() == ModelType::Mechanism))
+        {
+            area->invalidateFov();
+        }
+        // Update the light map.
+        if (item->getType() == ModelType::Light)
+        {
+            static_cast<LightItem *>(item)->updateLightMap();
+        }
         // Update the database.
         if (updateDB && (item->getType() != ModelType::Corpse))
         {
@@ -151,7 +209,7 @@ bool Room::removeBuilding(Item * item, bool updateDB)
     if (this->removeItem(item, updateDB))
     {
         // Clear the built flag from the item.
-        ClearFlag(item->flags, ItemFlag::Built);
+        item->clearFlag(ItemFlag::Built);
         return true;
     }
     return false;
@@ -161,10 +219,17 @@ void Room::removeCharacter(Character * character)
 {
     for (auto it = characters.begin(); it != characters.end(); ++it)
     {
-        if ((*it)->name == character->name)
+        if ((*it) == character)
         {
             characters.erase(it);
+            // Update the position of the character inside the area.
+            if (area != nullptr)
+            {
+                area->characterIndex.removeCharacter(character, coord);
+            }
             character->room = nullptr;
+            // Remove the light sources equipped by the character.
+            character->updateEquippedLights();
             return;
         }
     }
@@ -217,18 +282,37 @@ std::vector<Mobile *> Room::getAllMobile(Character * exception)
     return movec;
 }
 
+void Room::setFlag(RoomFlag flag)
+{
+    SetFlag(flags, flag);
+    dirty = true;
+}
+
+void Room::clearFlag(RoomFlag flag)
+{
+    ClearFlag(flags, flag);
+    dirty = true;
+}
+
 bool Room::updateOnDB()
 {
-    std::vector<std::string> arguments;
-    arguments.push_back(ToString(vnum));
-    arguments.push_back(ToString(coord.x));
-    arguments.push_back(ToString(coord.y));
-    arguments.push_back(ToString(coord.z));
-    arguments.push_back(ToString(terrain->vnum));
-    arguments.push_back(name);
-    arguments.push_back(description);
-    arguments.push_back(ToString(flags));
-    return SQLiteDbms::instance().insertInto("Room", arguments, false, true);
+    auto statement = SQLiteDbms::instance().prepareInsertInto("Room", 8,
+                                                              false, true);
+    if ((statement == nullptr) ||
+        !statement->bindAll(vnum,
+                            coord.x,
+                            coord.y,
+                            coord.z,
+                            terrain->vnum,
+                            name,
+                            description,
+                            flags) ||
+        !statement->execute())
+    {
+        return false;
+    }
+    dirty = false;
+    return true;
 }
 
 bool Room::removeOnDB()
@@ -342,46 +426,6 @@ std::shared_ptr<Exit> Room::findExit(Direction direction)
 
 bool Room::isLit()
 {
-//    Stopwatch<std::chrono::microseconds> stopwatch("isList");
-    auto CheckRoomForLights = [this](Room * room)
-    {
-        auto LightIsActiveAndInRange = [this, room](Item * item)
-        {
-            if (item != nullptr)
-            {
-                if (item->getType() == ModelType::Light)
-                {
-                    if (static_cast<LightItem *>(item)->isActive())
-                    {
-                        if (StructUtils::getDistance(coord, room->coord)
-                            <= item->model->toLight()->radius)
-                        {
-                            return true;
-                        }
-                    }
-                }
-            }
-            return false;
-        };
-        for (auto it : room->items)
-        {
-            if (LightIsActiveAndInRange(it))
-            {
-                return true;
-            }
-        }
-        for (auto it: room->characters)
-        {
-            for (auto it2: it->equipment)
-            {
-                if (LightIsActiveAndInRange(it2))
-                {
-                    return true;
-                }
-            }
-        }
-        return false;
-    };
     // If the room has a natural light.
     if (HasFlag(terrain->flags, TerrainFlag::NaturalLight))
     {
@@ -392,30 +436,13 @@ bool Room::isLit()
     if (!HasFlag(terrain->flags, TerrainFlag::Indoor) &&
         (dayPhase != DayPhase::Night))
     {
-//        Logger::log(LogLevel::Debug,
-//                    "Room is lit (outside)(!night)(%s us)",
-//                    stopwatch.stop());
         return true;
     }
-    // First check inside the current room.
-    auto validCoordinates = area->fov(coord, 10);
-    for (auto coordinates : validCoordinates)
+    // Check if the room is illuminated by a light source.
+    if (area != nullptr)
     {
-        auto room = area->getRoom(coordinates);
-        if (room != nullptr)
-        {
-            if (CheckRoomForLights(room))
-            {
-//                Logger::log(LogLevel::Debug,
-//                            "Room is lit (LitByLight)     (%s us)",
-//                            stopwatch.stop());
-                return true;
-            }
-        }
+        return area->lightMap.isLit(this);
     }
-//    Logger::log(LogLevel::Debug,
-//                "Room is not lit              (%s us)",
-//                stopwatch.stop());
     return false;
 }
 
@@ -426,6 +453,11 @@ bool Room::addExit(const std::shared_ptr<Exit> & exit)
         return false;
     }
     exits.emplace_back(exit);
+    // The exits can change the field of views and the paths.
+    if (area != nullptr)
+    {
+        area->invalidateRoom(this);
+    }
     return true;
 }
 
@@ -436,6 +468,11 @@ bool Room::removeExit(const Direction & direction)
         if ((*it)->direction == direction)
         {
             exits.erase(it);
+            // The exits can change the field of views and the paths.
+            if (area != nullptr)
+            {
+                area->invalidateRoom(this);
+            }
             return true;
         }
     }
@@ -469,13 +506,13 @@ std::string Room::getLook(Character * actor)
         {
             if (Formatter::getFormat() == Formatter::CLIENT)
             {
-                output += Formatter::doClearMap();
-                for (auto layer : area->drawFov(this, actor->getViewDistance()))
-                {
-                    output += Formatter::doDrawMap();
-                    output += layer;
-                    output += Formatter::dontDrawMap();
-                }
+                // Players receive only the changes to the map they have.
+                ClientMap clientMap;
+                output += area->drawFovUpdate(
+                    this,
+                    actor->getViewDistance(),
+                    actor->isPlayer() ? actor->toPlayer()->clientMap
+                                      : clientMap);
             }
             else
             {
@@ -32,6 +32,7 @@
 #include "characterVector.hpp"
 #include "itemVector.hpp"
 #include "terrain.hpp"
+#include "stringPool.hpp"
 
 class Item;
 
@@ -61,9 +62,9 @@ public:
     /// The type of terrain of the room.
     std::shared_ptr<Terrain> terrain;
     /// The name of the room.
-    std::string name;
+    InternedString name;
     /// A long description of the room.
-    std::string description;
+    InternedString description;
     /// List of exits.
     std::vector<std::shared_ptr<Exit> > exits;
     /// List of items in the room.
@@ -74,6 +75,8 @@ public:
     unsigned int flags;
     /// The liquid which fills the room.
     std::pair<Liquid *, unsigned int> liquidContent;
+    /// If the room has been modified since it has been saved on database.
+    bool dirty;
 
     /// @brief Constructor.
     Room();
@@ -81,6 +84,13 @@ public:
     /// @brief Destructor.
     virtual ~Room();
 
+
+    /// @brief Allocates the memory for a room, keeping track of its usage.
+    static void * operator new(size_t size);
+
+    /// @brief Releases the memory of a room, keeping track of its usage.
+    static void operator delete(void * ptr, size_t size);
+
     /// @brief Function used to check the correctness of the room.
     /// @param complete If set to true, the function check if the room has
     ///                  been placed inside an area.
@@ -130,6 +140,14 @@ public:
     /// @return The list of all the mobiles in the room.
     std::vector<Mobile *> getAllMobile(Character * exception);
 
+    /// @brief Sets the given flag, the room is saved with the next changes.
+    /// @param flag The flag to set.
+    void setFlag(RoomFlag flag);
+
+    /// @brief Clears the given flag, the room is saved with the next changes.
+    /// @param flag The flag to clear.
+    void clearFlag(RoomFlag flag);
+
     /// @brief Save the room on database.
     /// @return <b>True</b> if the execution goes well,<br>
     ///         <b>False</b> otherwise.
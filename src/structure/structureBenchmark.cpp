@@ -0,0 +1,531 @@
+/// @file   structureBenchmark.cpp
+/// @brief  Implements the benchmarks of the pathfinding and field of view.
+/// @author Enrico Fraccaroli
+/// @date   11 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "structureBenchmark.hpp"
+
+#include "mapGenerator.hpp"
+#include "mechanismModel.hpp"
+#include "structureUtils.hpp"
+#include "randomEngine.hpp"
+#include "stopwatch.hpp"
+#include "material.hpp"
+#include "aStar.hpp"
+#include "logger.hpp"
+#include "mud.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+/// @brief Prints a time with a fixed number of decimals.
+static std::string TimeToString(double value)
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3) << value;
+    return ss.str();
+}
+
+/// @brief Provides the configuration of a map of the given size, whose
+///         features are scaled with its surface.
+static MapGeneratorConfiguration GetMapConfiguration(int size,
+                                                     unsigned int seed)
+{
+    MapGeneratorConfiguration configuration;
+    auto surface = size * size;
+    auto defaultSurface = configuration.width * configuration.height;
+    configuration.width = size;
+    configuration.height = size;
+    // The same seed always produces the same terrain.
+    configuration.seed = seed;
+    configuration.numMountains =
+        std::max(1, configuration.numMountains * surface / defaultSurface);
+    configuration.numRivers =
+        std::max(1, configuration.numRivers * surface / defaultSurface);
+    configuration.numForests =
+        std::max(1, configuration.numForests * surface / defaultSurface);
+    return configuration;
+}
+
+BenchmarkResult::BenchmarkResult() :
+    scenario(),
+    rooms(),
+    operation(),
+    queries(),
+    total(),
+    minimum(),
+    maximum()
+{
+    // Nothing to do.
+}
+
+double BenchmarkResult::getMean() const
+{
+    return (queries > 0) ? (total / static_cast<double>(queries)) : 0;
+}
+
+StructureBenchmark::Scenario::Scenario(std::string _name,
+                                       int _size,
+                                       bool _stairsAndDoors,
+                                       unsigned int _seed) :
+    name(_name),
+    size(_size),
+    stairsAndDoors(_stairsAndDoors),
+    seed(_seed)
+{
+    // Nothing to do.
+}
+
+StructureBenchmark::StructureBenchmark(size_t _queries) :
+    queries(_queries),
+    results()
+{
+    // Nothing to do.
+}
+
+bool StructureBenchmark::run()
+{
+    results.clear();
+    std::vector<Scenario> scenarios;
+    scenarios.emplace_back("plain", 50, false, 50);
+    scenarios.emplace_back("plain", 200, false, 200);
+    scenarios.emplace_back("plain", 500, false, 500);
+    scenarios.emplace_back("stairs_doors", 200, true, 201);
+    for (auto const & scenario : scenarios)
+    {
+        if (!this->runScenario(scenario))
+        {
+            return false;
+        }
+    }
+    if (!this->runGeneration())
+    {
+        return false;
+    }
+    this->runRandom();
+    return true;
+}
+
+const std::vector<BenchmarkResult> & StructureBenchmark::getResults() const
+{
+    return results;
+}
+
+std::string StructureBenchmark::toJson() const
+{
+    std::string output = "{\n  \"results\": [\n";
+    for (size_t it = 0; it < results.size(); ++it)
+    {
+        auto const & result = results[it];
+        output += "    {";
+        output += "\"scenario\": \"" + result.scenario + "\", ";
+        output += "\"rooms\": " + ToString(result.rooms) + ", ";
+        output += "\"operation\": \"" + result.operation + "\", ";
+        output += "\"queries\": " + ToString(result.queries) + ", ";
+        output += "\"total_us\": " + TimeToString(result.total) + ", ";
+        output += "\"mean_us\": " + TimeToString(result.getMean()) + ", ";
+        output += "\"min_us\": " + TimeToString(result.minimum) + ", ";
+        output += "\"max_us\": " + TimeToString(result.maximum) + "}";
+        output += ((it + 1) < results.size()) ? ",\n" : "\n";
+    }
+    output += "  ]\n}\n";
+    return output;
+}
+
+std::string StructureBenchmark::toCsv() const
+{
+    std::string output = "scenario,rooms,operation,queries,"
+                         "total_us,mean_us,min_us,max_us\n";
+    for (auto const & result : results)
+    {
+        output += result.scenario + ",";
+        output += ToString(result.rooms) + ",";
+        output += result.operation + ",";
+        output += ToString(result.queries) + ",";
+        output += TimeToString(result.total) + ",";
+        output += TimeToString(result.getMean()) + ",";
+        output += TimeToString(result.minimum) + ",";
+        output += TimeToString(result.maximum) + "\n";
+    }
+    return output;
+}
+
+bool StructureBenchmark::exportToFile(const std::string & filename) const
+{
+    std::ofstream jsonFile((filename + ".json").c_str(), std::ios::trunc);
+    if (!jsonFile.is_open())
+    {
+        Logger::log(LogLevel::Error, "Cannot open file %s.json.", filename);
+        return false;
+    }
+    jsonFile << this->toJson();
+    std::ofstream csvFile((filename + ".csv").c_str(), std::ios::trunc);
+    if (!csvFile.is_open())
+    {
+        Logger::log(LogLevel::Error, "Cannot open file %s.csv.", filename);
+        return false;
+    }
+    csvFile << this->toCsv();
+    return true;
+}
+
+bool StructureBenchmark::runScenario(const Scenario & scenario)
+{
+    // The same seed always produces the same doors and queries.
+    std::mt19937 engine(scenario.seed);
+    std::vector<Room *> rooms;
+    std::vector<Item *> doors;
+    auto area = buildArea(scenario, engine, rooms, doors);
+    if (area == nullptr)
+    {
+        return false;
+    }
+    auto name = scenario.name + "_" + ToString(scenario.size);
+    // Prepare the queries before timing them.
+    int fovRadius = radius;
+    int pathLength = maxPathLength;
+    std::uniform_int_distribution<size_t> pickRoom(0, rooms.size() - 1);
+    std::uniform_int_distribution<int> pickOffset(-fovRadius, fovRadius);
+    std::uniform_int_distribution<int> pickStep(-pathLength, pathLength);
+    std::vector<Room *> sources, targets;
+    std::vector<Coordinates> sights;
+    for (size_t it = 0; it < queries; ++it)
+    {
+        auto source = rooms[pickRoom(engine)];
+        // Search a destination at the distance of a chase.
+        auto target = area->getRoom(source->coord +
+                                    Coordinates(pickStep(engine),
+                                                pickStep(engine),
+                                                0));
+        sources.emplace_back(source);
+        targets.emplace_back((target != nullptr) ? target : source);
+        sights.emplace_back(source->coord +
+                            Coordinates(pickOffset(engine),
+                                        pickOffset(engine),
+                                        0));
+    }
+    // The checks on the state of the character are not part of the search.
+    AStar<Room *> aStar([](Room * from, Room * to)
+                        {
+                            MovementOptions options;
+                            std::string error;
+                            return StructUtils::checkConnection(options,
+                                                                from,
+                                                                to,
+                                                                error);
+                        },
+                        StructUtils::getRoomDistance,
+                        StructUtils::roomsAreEqual,
+                        StructUtils::getNeighbours,
+                        pathLength * 2);
+    std::vector<Room *> path;
+    this->measure(name, rooms.size(), "astar", [&](size_t it)
+    {
+        aStar.findPath(sources[it], targets[it], path);
+    });
+    // Start from empty caches.
+    area->invalidateFov();
+    this->measure(name, rooms.size(), "fov", [&](size_t it)
+    {
+        area->fov(sources[it]->coord, fovRadius);
+    });
+    this->measure(name, rooms.size(), "los", [&](size_t it)
+    {
+        area->los(sources[it]->coord, sights[it], fovRadius);
+    });
+    this->measure(name, rooms.size(), "is_lit", [&](size_t it)
+    {
+        sources[it]->isLit();
+    });
+    area->invalidateFov();
+    this->measure(name, rooms.size(), "draw_ascii_fov", [&](size_t it)
+    {
+        area->drawASCIIFov(sources[it], fovRadius);
+    });
+    destroyArea(area, rooms, doors);
+    return true;
+}
+
+bool StructureBenchmark::runGeneration()
+{
+    // Check if there is a height map.
+    if (Mud::instance().mudHeightMaps.empty())
+    {
+        Logger::log(LogLevel::Error, "There are no height maps.");
+        return false;
+    }
+    auto heightMap = Mud::instance().mudHeightMaps.begin()->second;
+    auto generated = true;
+    for (auto size : {100, 250, 500})
+    {
+        auto name = "generation_" + ToString(size);
+        auto cells = static_cast<size_t>(size * size);
+        for (auto mode : {ReliefMode::Mountains, ReliefMode::Noise})
+        {
+            auto configuration = GetMapConfiguration(
+                size, static_cast<unsigned int>(size));
+            configuration.reliefMode = mode;
+            auto operation = (mode == ReliefMode::Noise) ? "noise"
+                                                         : "mountains";
+            this->measure(name, cells, operation, [&](size_t)
+            {
+                MapGenerator mapGenerator(configuration, heightMap);
+                auto map = std::make_shared<MapWrapper>();
+                generated &= mapGenerator.generateMap(map);
+            }, generationRuns);
+        }
+    }
+    if (!generated)
+    {
+        Logger::log(LogLevel::Error, "Cannot generate the map.");
+    }
+    return generated;
+}
+
+void StructureBenchmark::runRandom()
+{
+    size_t draws = randomDraws;
+    auto name = "random_" + ToString(draws);
+    std::vector<int> values(draws);
+    this->measure(name, 0, "random_device", [&](size_t)
+    {
+        for (auto & value : values)
+        {
+            std::uniform_int_distribution<int> distribution(0, 99);
+            std::random_device randomDevice;
+            std::default_random_engine generator(randomDevice());
+            value = distribution(generator);
+        }
+    });
+    this->measure(name, 0, "thread_local", [&](size_t)
+    {
+        for (auto & value : values)
+        {
+            value = TRand<int>(0, 99);
+        }
+    });
+    RandomEngine stream(draws);
+    this->measure(name, 0, "stream_fill", [&](size_t)
+    {
+        stream.fillInt(values.begin(), values.end(), 0, 99);
+    });
+}
+
+Area * StructureBenchmark::buildArea(const Scenario & scenario,
+                                     std::mt19937 & engine,
+                                     std::vector<Room *> & rooms,
+                                     std::vector<Item *> & doors)
+{
+    // Check if there is a height map.
+    if (Mud::instance().mudHeightMaps.empty())
+    {
+        Logger::log(LogLevel::Error, "There are no height maps.");
+        return nullptr;
+    }
+    // Generate the terrain.
+    auto configuration = GetMapConfiguration(scenario.size, scenario.seed);
+    MapGenerator mapGenerator(configuration,
+                              Mud::instance().mudHeightMaps.begin()->second);
+    auto map = std::make_shared<MapWrapper>();
+    if (!mapGenerator.generateMap(map))
+    {
+        Logger::log(LogLevel::Error, "Cannot generate the map.");
+        return nullptr;
+    }
+    // Create the area, which is not added to the mud.
+    auto area = new Area();
+    area->vnum = Mud::instance().getUniqueAreaVnum();
+    area->name = scenario.name;
+    area->builder = "Benchmark";
+    area->width = scenario.size;
+    area->height = scenario.size;
+    area->elevation = 100;
+    area->tileSet = 1;
+    area->type = AreaType::Normal;
+    area->status = AreaStatus::Normal;
+    // Create the rooms, the upper floor is placed above the ground.
+    auto floors = scenario.stairsAndDoors ? 2 : 1;
+    for (int floor = 0; floor < floors; ++floor)
+    {
+        for (int x = 0; x < scenario.size; ++x)
+        {
+            for (int y = 0; y < scenario.size; ++y)
+            {
+                auto cell = map->getCell(x, y);
+                auto room = new Room();
+                room->vnum = static_cast<int>(rooms.size()) + 1;
+                room->coord = Coordinates(x, y, cell->coordinates.z + floor);
+                room->terrain = cell->terrain;
+                room->name = cell->terrain->name;
+                room->flags = cell->flags;
+                if (floor == 0)
+                {
+                    room->liquidContent = cell->liquidContent;
+                }
+                if (!area->addRoom(room))
+                {
+                    delete (room);
+                    destroyArea(area, rooms, doors);
+                    return nullptr;
+                }
+                rooms.emplace_back(room);
+            }
+        }
+    }
+    // Connect the rooms in both directions.
+    auto Connect = [](Room * from, Room * to, unsigned int flags)
+    {
+        auto direction = StructUtils::getDirection(from->coord, to->coord);
+        from->addExit(std::make_shared<Exit>(from, to, direction, flags));
+        to->addExit(std::make_shared<Exit>(to,
+                                           from,
+                                           direction.getOpposite(),
+                                           flags));
+    };
+    for (auto room : rooms)
+    {
+        auto east = area->getRoom(room->coord + Coordinates(1, 0, 0));
+        if (east != nullptr)
+        {
+            Connect(room, east, 0);
+        }
+        auto north = area->getRoom(room->coord + Coordinates(0, 1, 0));
+        if (north != nullptr)
+        {
+            Connect(room, north, 0);
+        }
+        // Place a stair every few rooms.
+        if (((room->coord.x % 8) == 4) && ((room->coord.y % 8) == 4))
+        {
+            auto up = area->getRoom(room->coord + Coordinates(0, 0, 1));
+            if (up != nullptr)
+            {
+                Connect(room, up, static_cast<unsigned int>(ExitFlag::Stairs));
+            }
+        }
+    }
+    if (!scenario.stairsAndDoors)
+    {
+        return area;
+    }
+    // Search the model and the material of the doors.
+    std::shared_ptr<ItemModel> doorModel;
+    for (auto const & it : Mud::instance().mudItemModels)
+    {
+        if ((it.second->getType() == ModelType::Mechanism) &&
+            (it.second->toMechanism()->mechanismType == MechanismType::Door))
+        {
+            doorModel = it.second;
+            break;
+        }
+    }
+    Material * doorMaterial = nullptr;
+    for (auto const & it : Mud::instance().mudMaterials)
+    {
+        if ((doorModel != nullptr) && (it.second->type == doorModel->material))
+        {
+            doorMaterial = it.second;
+            break;
+        }
+    }
+    if (doorMaterial == nullptr)
+    {
+        Logger::log(LogLevel::Warning, "There is no door to place.");
+        return area;
+    }
+    // Place the doors on the ground, half of them closed.
+    std::uniform_int_distribution<int> chance(0, 19);
+    for (auto room : rooms)
+    {
+        if ((room->coord.z != rooms.front()->coord.z) || (chance(engine) != 0))
+        {
+            continue;
+        }
+        auto door = doorModel->createItem("Benchmark",
+                                          doorMaterial,
+                                          true,
+                                          ItemQuality::Normal);
+        if (door == nullptr)
+        {
+            continue;
+        }
+        if ((doors.size() % 2) == 0)
+        {
+            SetFlag(door->flags, ItemFlag::Closed);
+        }
+        room->addItem(door, false);
+        doors.emplace_back(door);
+    }
+    return area;
+}
+
+void StructureBenchmark::destroyArea(Area * area,
+                                     std::vector<Room *> & rooms,
+                                     std::vector<Item *> & doors)
+{
+    for (auto door : doors)
+    {
+        door->room->removeItem(door, false);
+        delete (door);
+    }
+    doors.clear();
+    // Detach the rooms first, so that the area is not updated while its
+    // rooms are deleted one by one.
+    for (auto room : rooms)
+    {
+        room->area = nullptr;
+    }
+    for (auto room : rooms)
+    {
+        delete (room);
+    }
+    rooms.clear();
+    delete (area);
+}
+
+void StructureBenchmark::measure(const std::string & scenario,
+                                 size_t rooms,
+                                 const std::string & operation,
+                                 const std::function<void(size_t)> & query,
+                                 size_t count)
+{
+    BenchmarkResult result;
+    result.scenario = scenario;
+    result.rooms = rooms;
+    result.operation = operation;
+    result.queries = (count > 0) ? count : queries;
+    Stopwatch<std::chrono::nanoseconds> stopwatch("Benchmark");
+    for (size_t it = 0; it < result.queries; ++it)
+    {
+        stopwatch.start();
+        query(it);
+        auto elapsed = stopwatch.stop() / 1000.0;
+        result.total += elapsed;
+        result.minimum = (it == 0) ? elapsed : std::min(result.minimum,
+                                                        elapsed);
+        result.maximum = std::max(result.maximum, elapsed);
+    }
+    Logger::log(LogLevel::Global, "Benchmark %s %s : %s us/query.",
+                result.scenario, operation,
+                TimeToString(result.getMean()));
+    results.emplace_back(result);
+}
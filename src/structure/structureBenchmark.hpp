@@ -0,0 +1,165 @@
+/// @file   structureBenchmark.hpp
+/// @brief  Defines the benchmarks of the pathfinding and field of view.
+/// @author Enrico Fraccaroli
+/// @date   11 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+class Area;
+
+class Item;
+
+class Room;
+
+/// @brief The timings of an operation of a benchmark scenario.
+class BenchmarkResult
+{
+public:
+    /// The name of the scenario.
+    std::string scenario;
+    /// The number of rooms of the scenario.
+    size_t rooms;
+    /// The name of the operation.
+    std::string operation;
+    /// The number of queries.
+    size_t queries;
+    /// The total time, in microseconds.
+    double total;
+    /// The fastest query, in microseconds.
+    double minimum;
+    /// The slowest query, in microseconds.
+    double maximum;
+
+    /// @brief Constructor.
+    BenchmarkResult();
+
+    /// @brief Provides the average time of a query, in microseconds.
+    double getMean() const;
+};
+
+/// @brief Times the pathfinding and field of view algorithms on synthetic
+///         areas, which are not part of the mud and are never saved, the
+///         generation of maps and the generation of random values.
+class StructureBenchmark
+{
+private:
+    /// @brief A synthetic area.
+    class Scenario
+    {
+    public:
+        /// The name of the scenario.
+        std::string name;
+        /// The side of the area.
+        int size;
+        /// If the area has an upper floor reached by stairs, and doors.
+        bool stairsAndDoors;
+        /// The seed of the queries.
+        unsigned int seed;
+
+        /// @brief Constructor.
+        Scenario(std::string _name,
+                 int _size,
+                 bool _stairsAndDoors,
+                 unsigned int _seed);
+    };
+
+    /// The radius used by the field of view queries.
+    static const int radius = 10;
+    /// The maximum distance between the ends of the path queries.
+    static const int maxPathLength = 30;
+    /// The number of random values drawn by each query.
+    static const size_t randomDraws = 1000;
+    /// The number of maps generated for each size and relief.
+    static const size_t generationRuns = 3;
+    /// The number of queries of each operation.
+    size_t queries;
+    /// The results.
+    std::vector<BenchmarkResult> results;
+
+public:
+    /// @brief Constructor.
+    /// @param _queries The number of queries of each operation.
+    explicit StructureBenchmark(size_t _queries);
+
+    /// @brief Runs all the scenarios.
+    /// @return <b>True</b> if all the scenarios have been run,<br>
+    ///         <b>False</b> otherwise.
+    bool run();
+
+    /// @brief Provides the results.
+    const std::vector<BenchmarkResult> & getResults() const;
+
+    /// @brief Provides the results in JSON format.
+    std::string toJson() const;
+
+    /// @brief Provides the results in CSV format.
+    std::string toCsv() const;
+
+    /// @brief Writes the results on file, both in JSON and CSV format.
+    /// @param filename The name of the files, without extension.
+    bool exportToFile(const std::string & filename) const;
+
+private:
+    /// @brief Builds the area of the scenario and times the operations.
+    bool runScenario(const Scenario & scenario);
+
+    /// @brief Times the generation of maps of several sizes, with the relief
+    ///         raised either by mountains or by noise.
+    bool runGeneration();
+
+    /// @brief Times the generation of random values, drawing a new seed from
+    ///         the device for each value (as TRand used to do), using the
+    ///         generator of the thread and filling a buffer from a stream.
+    void runRandom();
+
+    /// @brief Builds the area of a scenario.
+    /// @param scenario The scenario.
+    /// @param engine   The generator used to place the doors.
+    /// @param rooms    Where the rooms of the area are stored.
+    /// @param doors    Where the doors placed inside the area are stored.
+    /// @return The area, or nullptr if the area cannot be built.
+    static Area * buildArea(const Scenario & scenario,
+                            std::mt19937 & engine,
+                            std::vector<Room *> & rooms,
+                            std::vector<Item *> & doors);
+
+    /// @brief Destroys an area built by buildArea.
+    static void destroyArea(Area * area,
+                            std::vector<Room *> & rooms,
+                            std::vector<Item *> & doors);
+
+    /// @brief Times an operation.
+    /// @param scenario  The name of the scenario.
+    /// @param rooms     The number of rooms of the scenario.
+    /// @param operation The name of the operation.
+    /// @param query     The function which performs the i-th query.
+    /// @param count     The number of queries, when zero the number of
+    ///                   queries of the benchmark is used.
+    void measure(const std::string & scenario,
+                 size_t rooms,
+                 const std::string & operation,
+                 const std::function<void(size_t)> & query,
+                 size_t count = 0);
+};
@@ -21,6 +21,7 @@
 
 #include "structureUtils.hpp"
 #include "mechanismModel.hpp"
+#include "areaChunks.hpp"
 #include "character.hpp"
 #include "area.hpp"
 #include "room.hpp"
@@ -268,6 +269,16 @@ Item * findDoor(Room * room)
     return nullptr;
 }
 
+bool isTransient(Room * room)
+{
+    if (room->area == nullptr)
+    {
+        return false;
+    }
+    auto const & chunks = room->area->chunks;
+    return (chunks != nullptr) && chunks->isTransient(room);
+}
+
 std::vector<Room *> selectRooms(Area * area,
                                 Room * startingRoom,
                                 RoomSelectionOptions options)
@@ -46,6 +46,15 @@ struct MovementOptions
     bool allowedInCloseCombat;
     /// The required amount of stamina required to move.
     unsigned int requiredStamina;
+
+    /// @brief Constructor.
+    MovementOptions() :
+        character(),
+        allowedInCloseCombat(),
+        requiredStamina()
+    {
+        // Nothing to do.
+    }
 };
 
 /// @brief Structure which contains options used to select specific rooms.
@@ -132,6 +141,10 @@ bool checkConnection(const MovementOptions & options,
 /// @return The contained door if there is one.
 Item * findDoor(Room * room);
 
+/// @brief Checks if the room has been materialized from the tiles of a
+///         streamed area, and it has not been saved on the database yet.
+bool isTransient(Room * room);
+
 std::vector<Room *> selectRooms(Area * area,
                                 Room * startingRoom,
                                 RoomSelectionOptions options);
@@ -22,6 +22,7 @@
 
 #include "terrain.hpp"
 #include "utils.hpp"
+#include "randomEngine.hpp"
 
 Terrain::Terrain() :
     vnum(),
@@ -50,18 +51,19 @@ void Terrain::addLiquidSource(Liquid * _liquid,
     liquidSources.emplace_back(std::move(ls));
 }
 
-Liquid * Terrain::getRandomLiquidSource() const
+Liquid * Terrain::getRandomLiquidSource(RandomEngine & random) const
 {
-    if (!liquidSources.empty())
+    if (liquidSources.empty())
+    {
+        return nullptr;
+    }
+    auto pickedValue = random.getInt<unsigned int>(
+        0, liquidSources.back().cumulativeProbability - 1);
+    for (auto liquidSource : liquidSources)
     {
-        auto pickedValue = TRand<unsigned int>(
-            0, liquidSources.back().cumulativeProbability - 1);
-        for (auto liquidSource : liquidSources)
+        if (pickedValue <= liquidSource.cumulativeProbability)
         {
-            if (pickedValue <= liquidSource.cumulativeProbability)
-            {
-                return liquidSource.liquid;
-            }
+            return liquidSource.liquid;
         }
     }
     return nullptr;
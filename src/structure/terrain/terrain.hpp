@@ -28,6 +28,8 @@
 
 class Liquid;
 
+class RandomEngine;
+
 /// Used to determine the flag of the terrain.
 using TerrainFlag = enum class TerrainFlags
 {
@@ -88,5 +90,7 @@ public:
                          const unsigned int & _assignedProbability);
 
     /// @brief Provides a random liquid source based on their probabilities.
-    Liquid * getRandomLiquidSource() const;
+    /// @param random The stream of random values, so that the same seed
+    ///                always picks the same liquid.
+    Liquid * getRandomLiquidSource(RandomEngine & random) const;
 };
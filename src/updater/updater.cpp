@@ -23,6 +23,10 @@
 #include <utilities/logger.hpp>
 #include "updater.hpp"
 #include "generalBehaviour.hpp"
+#include "memoryTracker.hpp"
+#include "pathRequestService.hpp"
+#include "mapGenerationService.hpp"
+#include "areaChunks.hpp"
 #include "mud.hpp"
 
 // //////////////////////////////////////////////////////////
@@ -171,6 +175,12 @@ void MudUpdater::advanceTime()
             {
                 iterator.second->updateHour();
             }
+            // [HOUR] Write behind the items and rooms modified meanwhile.
+            Mud::instance().saveChanges();
+            // [HOUR] Export the memory counters for external monitoring.
+            Mud::instance().sampleMemoryUsage();
+            MemoryTracker::instance().exportToFile(
+                Mud::instance().getMudSystemDirectory() + "memory.prom");
             // [HOUR] Reset the hour counter.
             hourTicCounter = 0;
         }
@@ -251,6 +261,18 @@ void MudUpdater::updateDayPhase()
 
 void MudUpdater::performActions()
 {
+    // Deliver the paths resolved in background.
+    PathRequestService::instance().update();
+    // Collect the generated maps and continue building the maps.
+    MapGenerationService::instance().update();
+    // Materialize the rooms near the characters of the streamed areas.
+    for (auto iterator : Mud::instance().mudAreas)
+    {
+        if (iterator.second->chunks != nullptr)
+        {
+            iterator.second->chunks->update();
+        }
+    }
     for (auto player : Mud::instance().mudPlayers)
     {
         // If the player is not playing, continue.
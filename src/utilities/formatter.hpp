@@ -85,6 +85,36 @@ public:
         return o;
     }
 
+    /// @brief Returns the string which identifies the start of a map update,
+    ///         which contains only the changed tiles, as layer,index,tile;
+    ///         preceded by S,x,y; when the tiles must first be shifted.
+    /// @return The IAC:DO:UPD_MAP command.
+    static inline std::string doUpdateMap()
+    {
+        if (getFormat() != CLIENT) return "";
+        std::string o;
+        o.push_back('\0');
+        o.push_back(static_cast<char>(TelnetChar::IAC));
+        o.push_back(static_cast<char>(TelnetChar::DO));
+        o.push_back(static_cast<char>(TelnetChar::UPD_MAP));
+        o.push_back('\0');
+        return o;
+    }
+
+    /// @brief Returns the string which identifies the end of a map update.
+    /// @return The IAC:DONT:UPD_MAP command.
+    static inline std::string dontUpdateMap()
+    {
+        if (getFormat() != CLIENT) return "";
+        std::string o;
+        o.push_back('\0');
+        o.push_back(static_cast<char>(TelnetChar::IAC));
+        o.push_back(static_cast<char>(TelnetChar::DONT));
+        o.push_back(static_cast<char>(TelnetChar::UPD_MAP));
+        o.push_back('\0');
+        return o;
+    }
+
     /// @defgroup TelnetFunction Telnet Command Generation Function
     /// @brief All the functions necessary to generate formatted Telnet commands.
 
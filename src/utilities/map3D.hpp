@@ -1,6 +1,7 @@
 /// @file    map3D.hpp
 /// @brief   Define the class Map3D.
-/// @details This class allows to hadle a templatic tridimensional map.
+/// @details This class allows to hadle a templatic tridimensional map, stored
+///          as a dense grid of chunks which are allocated on first write.
 /// @author  Enrico Fraccaroli
 /// @date   Sep 8 2015
 /// @copyright
@@ -19,20 +20,51 @@
 
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <bitset>
+#include <array>
 
 /// Used to create and manage a tridimensional map.
+/// @details
+/// The space is divided in chunks of chunkWidth x chunkHeight x
+/// chunkElevation cells, each chunk is a dense array which is allocated the
+/// first time one of its cells is set. The chunks are indexed by a dense
+/// directory, thus every access costs a couple of divisions and two
+/// indirections. Coordinates must be non-negative, the directory grows
+/// automatically to contain the cells which are set.
 template<typename T>
 class Map3D
 {
+public:
+    /// Width of a chunk.
+    static const int chunkWidth = 16;
+    /// Height of a chunk.
+    static const int chunkHeight = 16;
+    /// Elevation of a chunk.
+    static const int chunkElevation = 4;
+
 private:
-    /// Define the type of internal 2D data structure.
-    using two_dim_map_t = typename
-    std::map<const int, std::map<const int, T> >;
+    /// Number of cells inside a chunk.
+    static const size_t chunkSize = chunkWidth * chunkHeight * chunkElevation;
 
-    /// Define the type of internal 3D data structure.
-    using three_dim_map_t = typename
-    std::map<const int, std::map<const int, std::map<const int, T> > >;
+    /// A dense block of cells.
+    struct Chunk
+    {
+        /// The cells of the chunk.
+        std::array<T, chunkSize> cells;
+        /// Which cells contain a value.
+        std::bitset<chunkSize> occupied;
+
+        /// @brief Constructor.
+        Chunk() :
+            cells(),
+            occupied()
+        {
+            cells.fill(T());
+        }
+    };
 
     /// Width of th map.
     int width;
@@ -40,8 +72,16 @@ private:
     int height;
     /// Elevation of th map.
     int elevation;
-    /// Data contained inside the map.
-    three_dim_map_t data;
+    /// Number of chunks along the width.
+    int chunksX;
+    /// Number of chunks along the height.
+    int chunksY;
+    /// Number of chunks along the elevation.
+    int chunksZ;
+    /// The directory of chunks.
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    /// Number of values contained inside the map.
+    size_t elements;
 
 public:
     /// @brief Constructor.
@@ -49,7 +89,11 @@ public:
         width(),
         height(),
         elevation(),
-        data()
+        chunksX(),
+        chunksY(),
+        chunksZ(),
+        chunks(),
+        elements()
     {
         // Nothing to do.
     }
@@ -59,12 +103,9 @@ public:
     /// @param _height    The height of the 3D map.
     /// @param _elevation The elevation of the 3D map.
     Map3D(int _width, int _height, int _elevation) :
-        width(_width),
-        height(_height),
-        elevation(_elevation),
-        data()
+        Map3D()
     {
-        // Nothing to do.
+        this->reserve(_width, _height, _elevation);
     }
 
     /// @brief Constructor.
@@ -73,18 +114,15 @@ public:
     /// @param _elevation The elevation of the 3D map.
     /// @param value     The initial value of the cells.
     Map3D(int _width, int _height, int _elevation, T value) :
-        width(_width),
-        height(_height),
-        elevation(_elevation),
-        data()
+        Map3D(_width, _height, _elevation)
     {
-        for (int z = 0; z < width; ++z)
+        for (int z = 0; z < elevation; ++z)
         {
             for (int y = 0; y < height; ++y)
             {
-                for (int x = 0; x < height; ++x)
+                for (int x = 0; x < width; ++x)
                 {
-                    data[x][y][z] = value;
+                    this->set(x, y, z, value);
                 }
             }
         }
@@ -120,6 +158,50 @@ public:
         return elevation;
     }
 
+    /// @brief Makes sure that the directory of chunks covers the given space.
+    /// @param _width     The width of the 3D map.
+    /// @param _height    The height of the 3D map.
+    /// @param _elevation The elevation of the 3D map.
+    void reserve(int _width, int _height, int _elevation)
+    {
+        if ((_width <= width) && (_height <= height) &&
+            (_elevation <= elevation))
+        {
+            return;
+        }
+        width = std::max(width, _width);
+        height = std::max(height, _height);
+        elevation = std::max(elevation, _elevation);
+        // Evaluate the new number of chunks.
+        auto newX = (width + chunkWidth - 1) / chunkWidth;
+        auto newY = (height + chunkHeight - 1) / chunkHeight;
+        auto newZ = (elevation + chunkElevation - 1) / chunkElevation;
+        if ((newX == chunksX) && (newY == chunksY) && (newZ == chunksZ))
+        {
+            return;
+        }
+        // Move the existing chunks inside the new directory.
+        std::vector<std::unique_ptr<Chunk>> directory(
+            static_cast<size_t>(newX * newY * newZ));
+        for (int cz = 0; cz < chunksZ; ++cz)
+        {
+            for (int cy = 0; cy < chunksY; ++cy)
+            {
+                for (int cx = 0; cx < chunksX; ++cx)
+                {
+                    auto index = static_cast<size_t>(
+                        (cz * newY + cy) * newX + cx);
+                    directory[index] = std::move(
+                        chunks[this->getChunkIndex(cx, cy, cz)]);
+                }
+            }
+        }
+        chunks.swap(directory);
+        chunksX = newX;
+        chunksY = newY;
+        chunksZ = newZ;
+    }
+
     /// @brief Set the object at the given Coordinates3D.
     /// @param x     Coordinate on width.
     /// @param y     Coordinate on heigth.
@@ -129,11 +211,27 @@ public:
     ///         <b>False</b> otherwise.
     bool set(int x, int y, int z, T value)
     {
-        if (this->has(x, y, z))
+        if ((x < 0) || (y < 0) || (z < 0))
         {
             return false;
         }
-        data[x][y][z] = value;
+        // Grow the directory, if necessary.
+        this->reserve(x + 1, y + 1, z + 1);
+        auto & chunk = chunks[this->getChunkIndex(x / chunkWidth,
+                                                  y / chunkHeight,
+                                                  z / chunkElevation)];
+        if (chunk == nullptr)
+        {
+            chunk.reset(new Chunk());
+        }
+        auto cell = getCellIndex(x, y, z);
+        if (chunk->occupied.test(cell))
+        {
+            return false;
+        }
+        chunk->cells[cell] = value;
+        chunk->occupied.set(cell);
+        ++elements;
         return true;
     }
 
@@ -141,10 +239,16 @@ public:
     /// @param x Coordinate on width.
     /// @param y Coordinate on heigth.
     /// @param z Coordinate on altitude.
-    /// @return The object at the given Coordinates3D.
-    T & get(int x, int y, int z)
+    /// @return The object at the given Coordinates3D, or a default
+    ///          constructed object if the cell is empty.
+    T get(int x, int y, int z) const
     {
-        return data[x][y][z];
+        auto chunk = this->findChunk(x, y, z);
+        if (chunk == nullptr)
+        {
+            return T();
+        }
+        return chunk->cells[getCellIndex(x, y, z)];
     }
 
     /// @brief Checks if there is an object at the given Coordinates3D.
@@ -155,17 +259,12 @@ public:
     ///         <b>False</b> otherwise.
     bool has(int x, int y, int z) const
     {
-
-        typename three_dim_map_t::const_iterator it = data.find(x);
-        if (it != data.end())
+        auto chunk = this->findChunk(x, y, z);
+        if (chunk == nullptr)
         {
-            typename two_dim_map_t::const_iterator it2 = it->second.find(y);
-            if (it2 != it->second.end())
-            {
-                return (it2->second.find(z) != it2->second.end());
-            }
+            return false;
         }
-        return false;
+        return chunk->occupied.test(getCellIndex(x, y, z));
     }
 
     /// @brief Erase the object at the given Coordinates3D and returns an iterator to the.
@@ -176,32 +275,113 @@ public:
     ///         <b>False</b> otherwise.
     bool erase(int x, int y, int z)
     {
-        if (this->has(x, y, z))
+        auto chunk = this->findChunk(x, y, z);
+        if (chunk == nullptr)
+        {
+            return false;
+        }
+        auto cell = getCellIndex(x, y, z);
+        if (!chunk->occupied.test(cell))
+        {
+            return false;
+        }
+        chunk->cells[cell] = T();
+        chunk->occupied.reset(cell);
+        --elements;
+        // Release the chunk when it becomes empty.
+        if (chunk->occupied.none())
         {
-            data[x][y].erase(data[x][y].find(z));
-            return true;
+            chunks[this->getChunkIndex(x / chunkWidth,
+                                       y / chunkHeight,
+                                       z / chunkElevation)].reset();
         }
-        return false;
+        return true;
     }
 
-    /// @brief Provides an iterator to the begin of the list of data.
-    /// @return An iterator to the begin of the 3D map.
-    typename three_dim_map_t::iterator begin()
+    /// @brief Calls the given function on all the objects of the map, the
+    ///         objects are visited chunk by chunk.
+    /// @param function The function which has to be called.
+    template<typename Function>
+    void forEach(Function function) const
     {
-        return data.begin();
+        for (auto const & chunk : chunks)
+        {
+            if (chunk == nullptr) continue;
+            for (size_t cell = 0; cell < chunkSize; ++cell)
+            {
+                if (chunk->occupied.test(cell))
+                {
+                    function(chunk->cells[cell]);
+                }
+            }
+        }
     }
 
-    /// @brief Provides an iterator to the end of the list of data.
-    /// @return An iterator to the end of the 3D map.
-    typename three_dim_map_t::iterator end()
+    /// @brief Provides the first object which satisfies the given predicate.
+    /// @param predicate The predicate.
+    /// @return The object if found, a default constructed object otherwise.
+    template<typename Predicate>
+    T findIf(Predicate predicate) const
     {
-        return data.end();
+        for (auto const & chunk : chunks)
+        {
+            if (chunk == nullptr) continue;
+            for (size_t cell = 0; cell < chunkSize; ++cell)
+            {
+                if (chunk->occupied.test(cell) && predicate(chunk->cells[cell]))
+                {
+                    return chunk->cells[cell];
+                }
+            }
+        }
+        return T();
     }
 
     /// @brief Provides the size of the data.
-    /// @return The size of the 3D map.
+    /// @return The number of objects contained in the 3D map.
     size_t size() const
     {
-        return data.size();
+        return elements;
+    }
+
+    /// @brief Provides the number of allocated chunks.
+    size_t getAllocatedChunks() const
+    {
+        size_t allocated = 0;
+        for (auto const & chunk : chunks)
+        {
+            if (chunk != nullptr) ++allocated;
+        }
+        return allocated;
+    }
+
+private:
+    /// @brief Provides the index of the chunk inside the directory.
+    inline size_t getChunkIndex(int cx, int cy, int cz) const
+    {
+        return static_cast<size_t>((cz * chunksY + cy) * chunksX + cx);
+    }
+
+    /// @brief Provides the index of the cell inside its chunk.
+    static inline size_t getCellIndex(int x, int y, int z)
+    {
+        return static_cast<size_t>(
+            ((z % chunkElevation) * chunkHeight + (y % chunkHeight)) *
+            chunkWidth + (x % chunkWidth));
+    }
+
+    /// @brief Provides the chunk which contains the given cell.
+    /// @return The chunk if it has been allocated, nullptr otherwise.
+    inline Chunk * findChunk(int x, int y, int z) const
+    {
+        if ((x < 0) || (y < 0) || (z < 0)) return nullptr;
+        auto cx = x / chunkWidth;
+        auto cy = y / chunkHeight;
+        auto cz = z / chunkElevation;
+        if ((cx >= chunksX) || (cy >= chunksY) || (cz >= chunksZ))
+        {
+            return nullptr;
+        }
+        return chunks[this->getChunkIndex(cx, cy, cz)].get();
     }
 };
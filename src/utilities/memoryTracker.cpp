@@ -0,0 +1,223 @@
+/// @file   memoryTracker.cpp
+/// @brief  Tracks memory usage for each subsystem of the mud.
+/// @author Enrico Fraccaroli
+/// @date   03 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "memoryTracker.hpp"
+#include "logger.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+MemoryTracker::MemoryTracker() :
+    current(),
+    peak(),
+    count()
+{
+    for (size_t it = 0; it < numCategories; ++it)
+    {
+        current[it] = 0;
+        peak[it] = 0;
+        count[it] = 0;
+    }
+}
+
+MemoryTracker::~MemoryTracker()
+{
+    // Nothing to do.
+}
+
+MemoryTracker & MemoryTracker::instance()
+{
+    // Since it's a static variable, if the class has already been created,
+    // It won't be created again. And it **is** thread-safe in C++11.
+    static MemoryTracker instance;
+    // Return a reference to our instance.
+    return instance;
+}
+
+void MemoryTracker::allocate(const MemoryCategory & category,
+                             const size_t & size)
+{
+    auto index = static_cast<size_t>(category);
+    this->updatePeak(index, current[index].fetch_add(size) + size);
+    ++count[index];
+}
+
+void MemoryTracker::deallocate(const MemoryCategory & category,
+                               const size_t & size)
+{
+    auto index = static_cast<size_t>(category);
+    current[index] -= size;
+    --count[index];
+}
+
+void MemoryTracker::resize(const MemoryCategory & category,
+                           const size_t & oldSize,
+                           const size_t & newSize)
+{
+    auto index = static_cast<size_t>(category);
+    if (newSize > oldSize)
+    {
+        auto delta = newSize - oldSize;
+        this->updatePeak(index, current[index].fetch_add(delta) + delta);
+    }
+    else
+    {
+        current[index] -= (oldSize - newSize);
+    }
+}
+
+void MemoryTracker::sample(const MemoryCategory & category,
+                           const size_t & size,
+                           const size_t & items)
+{
+    auto index = static_cast<size_t>(category);
+    current[index] = size;
+    count[index] = items;
+    this->updatePeak(index, size);
+}
+
+size_t MemoryTracker::getCurrent(const MemoryCategory & category) const
+{
+    return current[static_cast<size_t>(category)];
+}
+
+size_t MemoryTracker::getPeak(const MemoryCategory & category) const
+{
+    return peak[static_cast<size_t>(category)];
+}
+
+size_t MemoryTracker::getCount(const MemoryCategory & category) const
+{
+    return count[static_cast<size_t>(category)];
+}
+
+size_t MemoryTracker::getTotal() const
+{
+    size_t total = 0;
+    for (size_t it = 0; it < numCategories; ++it)
+    {
+        total += current[it];
+    }
+    return total;
+}
+
+std::string MemoryTracker::exportCounters() const
+{
+    std::stringstream ss;
+    ss << "# HELP radmud_memory_bytes Bytes currently used.\n";
+    ss << "# TYPE radmud_memory_bytes gauge\n";
+    for (size_t it = 0; it < numCategories; ++it)
+    {
+        ss << "radmud_memory_bytes{category=\""
+           << getCategoryName(static_cast<MemoryCategory>(it)) << "\"} "
+           << current[it] << "\n";
+    }
+    ss << "# HELP radmud_memory_peak_bytes Highest number of bytes used.\n";
+    ss << "# TYPE radmud_memory_peak_bytes gauge\n";
+    for (size_t it = 0; it < numCategories; ++it)
+    {
+        ss << "radmud_memory_peak_bytes{category=\""
+           << getCategoryName(static_cast<MemoryCategory>(it)) << "\"} "
+           << peak[it] << "\n";
+    }
+    ss << "# HELP radmud_memory_objects Number of live allocations.\n";
+    ss << "# TYPE radmud_memory_objects gauge\n";
+    for (size_t it = 0; it < numCategories; ++it)
+    {
+        ss << "radmud_memory_objects{category=\""
+           << getCategoryName(static_cast<MemoryCategory>(it)) << "\"} "
+           << count[it] << "\n";
+    }
+    return ss.str();
+}
+
+bool MemoryTracker::exportToFile(const std::string & filename) const
+{
+    // Write on a temporary file, so that a reader never sees a partial file.
+    auto temporary = filename + ".tmp";
+    std::ofstream outFile(temporary.c_str(), std::ios::trunc);
+    if (!outFile.is_open())
+    {
+        Logger::log(LogLevel::Error, "Cannot open file %s.", temporary);
+        return false;
+    }
+    outFile << this->exportCounters();
+    outFile.close();
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        Logger::log(LogLevel::Error, "Cannot rename %s.", temporary);
+        return false;
+    }
+    return true;
+}
+
+std::string MemoryTracker::getCategoryName(const MemoryCategory & category)
+{
+    switch (category)
+    {
+        case MemoryCategory::Room:
+            return "rooms";
+        case MemoryCategory::Item:
+            return "items";
+        case MemoryCategory::Character:
+            return "characters";
+        case MemoryCategory::Lua:
+            return "lua";
+        case MemoryCategory::Database:
+            return "database";
+        case MemoryCategory::Network:
+            return "network";
+        case MemoryCategory::MapWrapper:
+            return "map_wrappers";
+        case MemoryCategory::Strings:
+            return "strings";
+        case MemoryCategory::Count:
+        default:
+            return "none";
+    }
+}
+
+void MemoryTracker::updatePeak(const size_t & index, const size_t & value)
+{
+    auto previous = peak[index].load();
+    while ((value > previous) &&
+           !peak[index].compare_exchange_weak(previous, value))
+    {
+        // Retry, previous has been updated by compare_exchange_weak.
+    }
+}
+
+std::string MemorySizeToString(const size_t & size)
+{
+    static const char * units[] = {"B", "KB", "MB", "GB"};
+    auto value = static_cast<double>(size);
+    size_t unit = 0;
+    while ((value >= 1024.0) && (unit < 3))
+    {
+        value /= 1024.0;
+        ++unit;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f %s", value, units[unit]);
+    return buffer;
+}
@@ -0,0 +1,141 @@
+/// @file   memoryTracker.hpp
+/// @brief  Tracks memory usage for each subsystem of the mud.
+/// @author Enrico Fraccaroli
+/// @date   03 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <array>
+
+/// @brief The subsystems for which the memory usage is tracked.
+using MemoryCategory = enum class MemoryCategory_t
+{
+    Room,       ///< Memory used by the rooms.
+    Item,       ///< Memory used by the items.
+    Character,  ///< Memory used by players and mobiles.
+    Lua,        ///< Memory used by the lua states.
+    Database,   ///< Memory used by SQLite.
+    Network,    ///< Memory used by the network buffers.
+    MapWrapper, ///< Memory used by the generated maps.
+    Strings,    ///< Memory used by the pool of interned strings.
+    Count       ///< The number of categories.
+};
+
+/// @brief Keeps, for each category, the number of bytes currently allocated
+///         together with the peak usage.
+/// @details
+/// The Rooms, Items and Characters are tracked by means of class-specific
+/// allocation functions, the lua states by means of a custom lua allocator,
+/// while the other categories are sampled (see MemoryTracker::sample).
+class MemoryTracker
+{
+private:
+    /// The number of categories.
+    static const size_t numCategories =
+        static_cast<size_t>(MemoryCategory::Count);
+    /// The current usage for each category.
+    std::array<std::atomic<size_t>, numCategories> current;
+    /// The peak usage for each category.
+    std::array<std::atomic<size_t>, numCategories> peak;
+    /// The number of live allocations for each category.
+    std::array<std::atomic<size_t>, numCategories> count;
+
+    /// @brief Constructor.
+    MemoryTracker();
+
+    /// @brief Destructor.
+    ~MemoryTracker();
+
+public:
+    /// @brief Disable Copy Construct.
+    MemoryTracker(MemoryTracker const &) = delete;
+
+    /// @brief Disable Move construct.
+    MemoryTracker(MemoryTracker &&) = delete;
+
+    /// @brief Disable Copy assign.
+    MemoryTracker & operator=(MemoryTracker const &) = delete;
+
+    /// @brief Disable Move assign.
+    MemoryTracker & operator=(MemoryTracker &&) = delete;
+
+    /// @brief Get the singleton istance of the MemoryTracker.
+    /// @return The static and uniquie MemoryTracker variable.
+    static MemoryTracker & instance();
+
+    /// @brief Registers an allocation.
+    /// @param category The category of the allocation.
+    /// @param size     The number of allocated bytes.
+    void allocate(const MemoryCategory & category, const size_t & size);
+
+    /// @brief Registers a deallocation.
+    /// @param category The category of the allocation.
+    /// @param size     The number of released bytes.
+    void deallocate(const MemoryCategory & category, const size_t & size);
+
+    /// @brief Registers the change of size of an already tracked block.
+    /// @param category The category of the allocation.
+    /// @param oldSize  The previous size of the block.
+    /// @param newSize  The new size of the block.
+    void resize(const MemoryCategory & category,
+                const size_t & oldSize,
+                const size_t & newSize);
+
+    /// @brief Sets the current usage of a sampled category.
+    /// @param category The category.
+    /// @param size     The current usage.
+    /// @param items    The current number of allocations.
+    void sample(const MemoryCategory & category,
+                const size_t & size,
+                const size_t & items);
+
+    /// @brief Provides the current usage of the given category.
+    size_t getCurrent(const MemoryCategory & category) const;
+
+    /// @brief Provides the peak usage of the given category.
+    size_t getPeak(const MemoryCategory & category) const;
+
+    /// @brief Provides the number of live allocations of the given category.
+    size_t getCount(const MemoryCategory & category) const;
+
+    /// @brief Provides the total usage.
+    size_t getTotal() const;
+
+    /// @brief Provides the counters in the Prometheus text exposition format.
+    std::string exportCounters() const;
+
+    /// @brief Writes the counters to the given file.
+    /// @param filename The path of the file.
+    /// @return <b>True</b> if the file has been written,<br>
+    ///         <b>False</b> otherwise.
+    bool exportToFile(const std::string & filename) const;
+
+    /// @brief Provides the name of the given category.
+    static std::string getCategoryName(const MemoryCategory & category);
+
+private:
+    /// @brief Updates the peak of the given category.
+    void updatePeak(const size_t & index, const size_t & value);
+};
+
+/// @brief Provides a human readable version of the given number of bytes.
+std::string MemorySizeToString(const size_t & size);
@@ -0,0 +1,76 @@
+/// @file   randomEngine.cpp
+/// @brief  Implements a fast and seedable pseudo-random number generator.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#include "randomEngine.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+
+/// @brief Mixes the value and moves it forward, used to expand a single
+///         seed into the whole state of the generator (splitmix64).
+static uint64_t SplitMix(uint64_t & value)
+{
+    auto result = (value += 0x9E3779B97F4A7C15ULL);
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+    return result ^ (result >> 31);
+}
+
+RandomEngine::RandomEngine(uint64_t _seed) :
+    state()
+{
+    this->seed(_seed);
+}
+
+void RandomEngine::seed(uint64_t _seed)
+{
+    // Splitmix64 is a bijection of its counter, hence the four words are all
+    // different and the state is never all zeros.
+    for (auto & it : state)
+    {
+        it = SplitMix(_seed);
+    }
+}
+
+RandomEngine & RandomEngine::local()
+{
+    static thread_local RandomEngine engine(RandomEngine::generateSeed());
+    return engine;
+}
+
+uint64_t RandomEngine::generateSeed()
+{
+    // The device is read only once, the following seeds are derived from it.
+    static const uint64_t base = []()
+    {
+        std::random_device randomDevice;
+        return (static_cast<uint64_t>(randomDevice()) << 32) ^
+               static_cast<uint64_t>(randomDevice()) ^
+               static_cast<uint64_t>(std::chrono::high_resolution_clock::now()
+                                         .time_since_epoch().count());
+    }();
+    static std::atomic<uint64_t> counter(0);
+    uint64_t value = base + (counter++ * 0x9E3779B97F4A7C15ULL);
+    return SplitMix(value);
+}
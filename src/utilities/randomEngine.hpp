@@ -0,0 +1,217 @@
+/// @file   randomEngine.hpp
+/// @brief  Defines a fast and seedable pseudo-random number generator.
+/// @author Enrico Fraccaroli
+/// @date   12 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/// @brief A xoshiro256** generator, which satisfies the requirements of an
+///         uniform random bit generator. The values drawn from a given seed
+///         are the same on every platform, thus a seeded engine can be used
+///         as a stream of random values by deterministic subsystems.
+class RandomEngine
+{
+public:
+    /// The type of the generated values.
+    using result_type = uint64_t;
+
+private:
+    /// The state of the generator.
+    std::array<uint64_t, 4> state;
+
+public:
+    /// @brief Constructor.
+    /// @param _seed The seed of the generator.
+    explicit RandomEngine(uint64_t _seed);
+
+    /// @brief Restarts the generator from the given seed.
+    void seed(uint64_t _seed);
+
+    /// @brief The smallest value which can be generated.
+    static constexpr result_type min()
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    /// @brief The largest value which can be generated.
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /// @brief Generates the next value.
+    inline result_type operator()()
+    {
+        auto result = rotate(state[1] * 5, 7) * 9;
+        auto t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate(state[3], 45);
+        return result;
+    }
+
+    /// @brief Generates an integral value between the given bounds.
+    /// @param lowerBound The lower bound, included.
+    /// @param upperBound The upper bound, included.
+    /// @return The generated value.
+    template<typename T,
+        typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    T getInt(const T & lowerBound, const T & upperBound)
+    {
+        auto span = getSpan(lowerBound, upperBound);
+        return offset(lowerBound, this->getBounded(span, getThreshold(span)));
+    }
+
+    /// @brief Generates a floating point value between the given bounds.
+    /// @param lowerBound The lower bound, included.
+    /// @param upperBound The upper bound, excluded.
+    /// @return The generated value.
+    template<typename T,
+        typename = typename std::enable_if<
+            std::is_floating_point<T>::value>::type>
+    T getReal(const T & lowerBound, const T & upperBound)
+    {
+        return lowerBound + (upperBound - lowerBound) * this->getUnit<T>();
+    }
+
+    /// @brief Fills a range with integral values between the given bounds,
+    ///         the bounds are checked only once for the whole range.
+    /// @param first      The beginning of the range.
+    /// @param last       The end of the range.
+    /// @param lowerBound The lower bound, included.
+    /// @param upperBound The upper bound, included.
+    template<typename Iterator, typename T,
+        typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    void fillInt(Iterator first,
+                 Iterator last,
+                 const T & lowerBound,
+                 const T & upperBound)
+    {
+        auto span = getSpan(lowerBound, upperBound);
+        auto threshold = getThreshold(span);
+        for (; first != last; ++first)
+        {
+            *first = offset(lowerBound, this->getBounded(span, threshold));
+        }
+    }
+
+    /// @brief Fills a range with floating point values between the given
+    ///         bounds.
+    /// @param first      The beginning of the range.
+    /// @param last       The end of the range.
+    /// @param lowerBound The lower bound, included.
+    /// @param upperBound The upper bound, excluded.
+    template<typename Iterator, typename T,
+        typename = typename std::enable_if<
+            std::is_floating_point<T>::value>::type>
+    void fillReal(Iterator first,
+                  Iterator last,
+                  const T & lowerBound,
+                  const T & upperBound)
+    {
+        auto width = upperBound - lowerBound;
+        for (; first != last; ++first)
+        {
+            *first = lowerBound + width * this->getUnit<T>();
+        }
+    }
+
+    /// @brief Provides the generator of the calling thread, which is seeded
+    ///         only once, the first time it is used.
+    static RandomEngine & local();
+
+    /// @brief Provides a seed which is different at every call.
+    static uint64_t generateSeed();
+
+private:
+    /// @brief Rotates the bits of the value to the left.
+    static inline uint64_t rotate(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    /// @brief Provides the number of values between the bounds, minus one.
+    template<typename T>
+    static inline uint64_t getSpan(const T & lowerBound, const T & upperBound)
+    {
+        return static_cast<uint64_t>(upperBound) -
+               static_cast<uint64_t>(lowerBound);
+    }
+
+    /// @brief Provides the smallest value which can be accepted when
+    ///         drawing a value up to span, so that all the values have the
+    ///         same probability.
+    static inline uint64_t getThreshold(uint64_t span)
+    {
+        return (span == max()) ? 0 : ((max() - span) % (span + 1));
+    }
+
+    /// @brief Adds the drawn offset to the lower bound.
+    template<typename T>
+    static inline T offset(const T & lowerBound, uint64_t value)
+    {
+        return static_cast<T>(static_cast<uint64_t>(lowerBound) + value);
+    }
+
+    /// @brief Generates a value between zero and span, both included.
+    inline uint64_t getBounded(uint64_t span, uint64_t threshold)
+    {
+        auto value = (*this)();
+        if (span == max())
+        {
+            return value;
+        }
+        // Reject the lowest values, which would make the remainders in the
+        // first part of the range more likely than the others.
+        while (value < threshold)
+        {
+            value = (*this)();
+        }
+        return value % (span + 1);
+    }
+
+    /// @brief Generates a floating point value between zero, included, and
+    ///         one, excluded.
+    template<typename T>
+    inline T getUnit()
+    {
+        // Use the 53 upper bits, which fill the mantissa of a double.
+        return static_cast<T>(static_cast<double>((*this)() >> 11) *
+                              (1.0 / 9007199254740992.0));
+    }
+};
+
+/// @brief Generates a float between zero, included, and one, excluded. Only
+///         the 24 upper bits are used, since a double close to one would be
+///         rounded up to one when converted.
+template<>
+inline float RandomEngine::getUnit<float>()
+{
+    return static_cast<float>((*this)() >> 40) * (1.0f / 16777216.0f);
+}
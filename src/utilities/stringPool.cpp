@@ -0,0 +1,129 @@
+/// @file   stringPool.cpp
+/// @brief  Pool of interned immutable strings.
+/// @author Enrico Fraccaroli
+/// @date   04 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#include "stringPool.hpp"
+
+StringPool::StringPool() :
+    poolMutex(),
+    pool(),
+    entries(),
+    bytes(),
+    requests(),
+    emptyEntry()
+{
+    // Intern the empty string, so that it has always the identifier 0.
+    emptyEntry = this->intern("");
+}
+
+StringPool::~StringPool()
+{
+    // Nothing to do.
+}
+
+StringPool & StringPool::instance()
+{
+    // Since it's a static variable, if the class has already been created,
+    // It won't be created again. And it **is** thread-safe in C++11.
+    static StringPool instance;
+    // Return a reference to our instance.
+    return instance;
+}
+
+const StringPool::Entry * StringPool::intern(const std::string & str)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    ++requests;
+    // Check if the string has already been interned.
+    auto it = pool.find(str);
+    if (it != pool.end())
+    {
+        return &(*it);
+    }
+    // Add the string to the pool.
+    auto id = static_cast<unsigned int>(entries.size());
+    it = pool.insert(std::make_pair(str, id)).first;
+    entries.emplace_back(&(*it));
+    bytes += str.capacity() + 1;
+    return &(*it);
+}
+
+const std::string & StringPool::get(const unsigned int & id) const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (id >= entries.size())
+    {
+        return emptyEntry->first;
+    }
+    return entries[id]->first;
+}
+
+size_t StringPool::size() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return entries.size();
+}
+
+size_t StringPool::getMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    // Estimate of the bookkeeping of a single node of the unordered_map.
+    static const size_t nodeSize = sizeof(Entry) + 2 * sizeof(void *);
+    return bytes +
+           pool.size() * nodeSize +
+           pool.bucket_count() * sizeof(void *) +
+           entries.capacity() * sizeof(const Entry *);
+}
+
+size_t StringPool::getRequests() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return requests;
+}
+
+InternedString::InternedString() :
+    entry(StringPool::instance().getEmpty())
+{
+    // Nothing to do.
+}
+
+InternedString::InternedString(const std::string & str) :
+    entry(StringPool::instance().intern(str))
+{
+    // Nothing to do.
+}
+
+InternedString::InternedString(const char * str) :
+    entry(StringPool::instance().intern(str))
+{
+    // Nothing to do.
+}
+
+std::vector<InternedString> Intern(const std::vector<std::string> & strings)
+{
+    std::vector<InternedString> result;
+    result.reserve(strings.size());
+    for (auto const & str : strings)
+    {
+        result.emplace_back(str);
+    }
+    return result;
+}
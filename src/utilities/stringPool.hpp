@@ -0,0 +1,249 @@
+/// @file   stringPool.hpp
+/// @brief  Pool of interned immutable strings.
+/// @author Enrico Fraccaroli
+/// @date   04 02 2018
+/// @copyright
+/// Copyright (c) 2018 Enrico Fraccaroli <enrico.fraccaroli@gmail.com>
+/// Permission is hereby granted, free of charge, to any person obtaining a
+/// copy of this software and associated documentation files (the "Software"),
+/// to deal in the Software without restriction, including without limitation
+/// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+/// and/or sell copies of the Software, and to permit persons to whom the
+/// Software is furnished to do so, subject to the following conditions:
+///     The above copyright notice and this permission notice shall be included
+///     in all copies or substantial portions of the Software.
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+/// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+/// DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <unordered_map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <mutex>
+
+/// @brief Symbol table which stores a single immutable copy of each string.
+/// @details
+/// Once a string has been interned it is never released, both its address
+/// and its identifier remain valid until the end of the execution.
+class StringPool
+{
+public:
+    /// An entry of the pool: the string and its unique identifier.
+    using Entry = std::pair<const std::string, unsigned int>;
+
+private:
+    /// Mutex for the pool.
+    mutable std::mutex poolMutex;
+    /// The interned strings (the nodes of an unordered_map are stable).
+    std::unordered_map<std::string, unsigned int> pool;
+    /// The interned strings, indexed by identifier.
+    std::vector<const Entry *> entries;
+    /// The bytes used by the characters of the interned strings.
+    size_t bytes;
+    /// The number of requests served by the pool.
+    size_t requests;
+    /// The entry of the empty string.
+    const Entry * emptyEntry;
+
+    /// @brief Constructor.
+    StringPool();
+
+    /// @brief Destructor.
+    ~StringPool();
+
+public:
+    /// @brief Disable Copy Construct.
+    StringPool(StringPool const &) = delete;
+
+    /// @brief Disable Move construct.
+    StringPool(StringPool &&) = delete;
+
+    /// @brief Disable Copy assign.
+    StringPool & operator=(StringPool const &) = delete;
+
+    /// @brief Disable Move assign.
+    StringPool & operator=(StringPool &&) = delete;
+
+    /// @brief Get the singleton istance of the StringPool.
+    /// @return The static and uniquie StringPool variable.
+    static StringPool & instance();
+
+    /// @brief Interns the given string.
+    /// @param str The string to intern.
+    /// @return The entry of the pool associated with the string.
+    const Entry * intern(const std::string & str);
+
+    /// @brief Provides the entry of the empty string.
+    inline const Entry * getEmpty() const
+    {
+        return emptyEntry;
+    }
+
+    /// @brief Provides the string with the given identifier.
+    const std::string & get(const unsigned int & id) const;
+
+    /// @brief Provides the number of interned strings.
+    size_t size() const;
+
+    /// @brief Provides an estimate of the memory used by the pool.
+    size_t getMemoryUsage() const;
+
+    /// @brief Provides the number of requests served by the pool.
+    size_t getRequests() const;
+};
+
+/// @brief A lightweight handle to a string stored inside the StringPool.
+/// @details
+/// Copies only cost a pointer, while two interned strings are equal if and
+/// only if they point to the same entry of the pool.
+class InternedString
+{
+private:
+    /// The entry inside the pool.
+    const StringPool::Entry * entry;
+
+public:
+    /// @brief Constructor, creates the empty string.
+    InternedString();
+
+    /// @brief Constructor.
+    /// @param str The string to intern.
+    InternedString(const std::string & str);
+
+    /// @brief Constructor.
+    /// @param str The string to intern.
+    InternedString(const char * str);
+
+    /// @brief Provides the interned string.
+    inline const std::string & str() const
+    {
+        return entry->first;
+    }
+
+    /// @brief Provides the interned string.
+    inline operator const std::string &() const
+    {
+        return entry->first;
+    }
+
+    /// @brief Provides the interned string as a null terminated string.
+    inline const char * c_str() const
+    {
+        return entry->first.c_str();
+    }
+
+    /// @brief Provides the unique identifier of the string.
+    inline unsigned int id() const
+    {
+        return entry->second;
+    }
+
+    /// @brief Checks if the string is empty.
+    inline bool empty() const
+    {
+        return entry->first.empty();
+    }
+
+    /// @brief Provides the length of the string.
+    inline size_t size() const
+    {
+        return entry->first.size();
+    }
+
+    /// @brief Equality operator, it just compares the entries.
+    inline bool operator==(const InternedString & other) const
+    {
+        return entry == other.entry;
+    }
+
+    /// @brief Inequality operator, it just compares the entries.
+    inline bool operator!=(const InternedString & other) const
+    {
+        return entry != other.entry;
+    }
+
+    /// @brief Lesser than operator, used for ordered containers.
+    inline bool operator<(const InternedString & other) const
+    {
+        return entry->first < other.entry->first;
+    }
+};
+
+/// @brief Equality operator between an interned and a normal string.
+inline bool operator==(const InternedString & lhs, const std::string & rhs)
+{
+    return lhs.str() == rhs;
+}
+
+/// @brief Equality operator between a normal and an interned string.
+inline bool operator==(const std::string & lhs, const InternedString & rhs)
+{
+    return lhs == rhs.str();
+}
+
+/// @brief Equality operator between an interned and a C string.
+inline bool operator==(const InternedString & lhs, const char * rhs)
+{
+    return lhs.str() == rhs;
+}
+
+/// @brief Inequality operator between an interned and a normal string.
+inline bool operator!=(const InternedString & lhs, const std::string & rhs)
+{
+    return lhs.str() != rhs;
+}
+
+/// @brief Inequality operator between a normal and an interned string.
+inline bool operator!=(const std::string & lhs, const InternedString & rhs)
+{
+    return lhs != rhs.str();
+}
+
+/// @brief Inequality operator between an interned and a C string.
+inline bool operator!=(const InternedString & lhs, const char * rhs)
+{
+    return lhs.str() != rhs;
+}
+
+/// @brief Concatenates a normal and an interned string.
+inline std::string operator+(const std::string & lhs,
+                             const InternedString & rhs)
+{
+    return lhs + rhs.str();
+}
+
+/// @brief Concatenates an interned and a normal string.
+inline std::string operator+(const InternedString & lhs,
+                             const std::string & rhs)
+{
+    return lhs.str() + rhs;
+}
+
+/// @brief Concatenates a C string and an interned string.
+inline std::string operator+(const char * lhs, const InternedString & rhs)
+{
+    return lhs + rhs.str();
+}
+
+/// @brief Concatenates an interned string and a C string.
+inline std::string operator+(const InternedString & lhs, const char * rhs)
+{
+    return lhs.str() + rhs;
+}
+
+/// @brief Writes the interned string on the stream.
+inline std::ostream & operator<<(std::ostream & os,
+                                 const InternedString & str)
+{
+    return os << str.str();
+}
+
+/// @brief Interns all the strings of the given vector.
+std::vector<InternedString> Intern(const std::vector<std::string> & strings);
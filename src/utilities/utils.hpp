@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include "randomEngine.hpp"
+
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
@@ -198,7 +200,8 @@ std::string ToString(const T & value)
     return ss.str();
 }
 
-/// @brief Generate a random integral value between the defined range.
+/// @brief Generate a random integral value between the defined range,
+///         using the generator of the calling thread.
 /// @param lowerBound The lower bound for the random value.
 /// @param upperBound The upper bound for the random value.
 /// @return The generated random value.
@@ -206,13 +209,11 @@ template<typename T,
     typename = typename std::enable_if<std::is_integral<T>::value>::type>
 T TRand(const T & lowerBound, const T & upperBound)
 {
-    std::uniform_int_distribution<T> distribution(lowerBound, upperBound);
-    std::random_device randomDevice;
-    std::default_random_engine generator(randomDevice());
-    return distribution(generator);
+    return RandomEngine::local().getInt(lowerBound, upperBound);
 }
 
-/// @brief Generate a random integral value between the defined range.
+/// @brief Generate a random real value between the defined range,
+///         using the generator of the calling thread.
 /// @param lowerBound The lower bound for the random value.
 /// @param upperBound The upper bound for the random value.
 /// @return The generated random value.
@@ -220,10 +221,7 @@ template<typename T,
     typename = typename std::enable_if<std::is_floating_point<T>::value>::type>
 T TRandReal(const T & lowerBound, const T & upperBound)
 {
-    std::uniform_real_distribution<T> distribution(lowerBound, upperBound);
-    std::random_device randomDevice;
-    std::default_random_engine generator(randomDevice());
-    return distribution(generator);
+    return RandomEngine::local().getReal(lowerBound, upperBound);
 }
 
 /// @brief Normalizes the value from a range to another.